@@ -1,5 +1,7 @@
 #pragma once
 
+#include "threadPool.h"
+
 // #define FOOSORT_LIMIT_THREADS 1
 
 
@@ -10,4 +12,64 @@ namespace fb2k {
 	// expects cb to handle concurrent calls as long as they do not touch the same items concurrently
 	void sort(pfc::sort_callback & cb, size_t count, size_t concurrency, abort_callback & aborter);
 
+	// abortable multithreaded merge sort over a plain array, comparator inlined (see pfc::sort_inline_t)
+	// each thread sorts one chunk, then neighbouring chunks are merged pairwise, pairs of one round in parallel
+	// not stable; items must be default constructible and movable
+	// on abort the items are all still there, in unspecified order
+	template<typename t_item, typename t_compare>
+	void sort_parallel_t(t_item * base, size_t count, t_compare compare, size_t concurrency, abort_callback & aborter) {
+		// below this many items per chunk, thread hand-off costs more than it saves
+		const size_t minChunk = 4096;
+
+#ifdef FOOSORT_LIMIT_THREADS
+		if (concurrency > FOOSORT_LIMIT_THREADS) concurrency = FOOSORT_LIMIT_THREADS;
+#endif
+		size_t chunks = concurrency;
+		if (chunks > count / minChunk) chunks = count / minChunk;
+		if (chunks <= 1) {
+			pfc::sort_inline_t(base, count, compare);
+			return;
+		}
+
+		pfc::array_t<size_t> bounds; bounds.set_size(chunks + 1);
+		for (size_t walk = 0; walk <= chunks; ++walk) bounds[walk] = (size_t)((uint64_t)count * walk / chunks);
+
+		{
+			pfc::counter next(0);
+			cpuThreadPool::runMultiHelper([&] {
+				for (;;) {
+					const size_t chunk = next++;
+					if (chunk >= chunks) return;
+					aborter.check();
+					pfc::sort_inline_t(base + bounds[chunk], bounds[chunk + 1] - bounds[chunk], compare);
+				}
+			}, chunks);
+		}
+
+		// each pair gets its own part of the buffer, starting where the pair starts
+		pfc::array_staticsize_t<t_item> buffer(count);
+		size_t runs = chunks;
+		while (runs > 1) {
+			aborter.check();
+			const size_t pairs = runs / 2;
+			pfc::counter next(0);
+			auto merge = [&] {
+				pfc::_sort_inline<t_item*, t_compare> sorter(base, compare);
+				for (;;) {
+					const size_t pair = next++;
+					if (pair >= pairs) return;
+					const size_t start = bounds[pair * 2], mid = bounds[pair * 2 + 1], end = bounds[pair * 2 + 2];
+					sorter.merge(start, mid - start, end - mid, buffer.get_ptr() + start);
+				}
+			};
+			if (pairs > 1) cpuThreadPool::runMultiHelper(merge, pairs);
+			else merge();
+
+			// drop the bounds between merged pairs, an odd last run is carried over as is
+			size_t out = 0;
+			for (size_t walk = 0; walk <= runs; walk += 2) bounds[out++] = bounds[walk];
+			if (runs % 2 != 0) bounds[out++] = bounds[runs];
+			runs = out - 1;
+		}
+	}
 }
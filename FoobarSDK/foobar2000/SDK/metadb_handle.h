@@ -185,6 +185,17 @@ public:
 	virtual void formatTitle_v2(const rec_t& rec, titleformat_hook* p_hook, pfc::string_base& p_out, const service_ptr_t<titleformat_object>& p_script, titleformat_text_filter* p_filter) = 0;
 };
 
+//! Hasher for pfc::hash_map_t / pfc::hash_set_t keyed by metadb_handle_ptr. There is one handle per location, so the pointer identifies the item.
+class metadb_handle_hasher {
+public:
+	static t_uint32 hash(const metadb_handle * p) {return pfc::hash_mix((t_uint64)(t_size)p);}
+	static t_uint32 hash(const metadb_handle_ptr & p) {return hash(p.get_ptr());}
+	static bool equals(const metadb_handle_ptr & p1, const metadb_handle_ptr & p2) {return p1.get_ptr() == p2.get_ptr();}
+	static bool equals(const metadb_handle_ptr & p1, const metadb_handle * p2) {return p1.get_ptr() == p2;}
+	static bool equals(const metadb_handle * p1, const metadb_handle * p2) {return p1 == p2;}
+	static bool equals(const metadb_handle * p1, const metadb_handle_ptr & p2) {return p1 == p2.get_ptr();}
+};
+
 typedef pfc::list_base_t<metadb_handle_ptr>* metadb_handle_list_ptr;
 typedef pfc::list_base_const_t<metadb_handle_ptr> const * metadb_handle_list_cptr;
 
@@ -207,6 +218,19 @@ namespace metadb_handle_list_helper {
 	void sort_by_pointer(pfc::list_base_t<metadb_handle_ptr> & p_list);
 	t_size bsearch_by_pointer(const pfc::list_base_const_t<metadb_handle_ptr> & p_list,const metadb_handle_ptr & val);
 
+	//! Scratch table for the hash-based helpers below, which need no sorting and keep the list order. \n
+	//! Pass the same one to repeated calls so it is allocated once; its contents between calls are unspecified.
+	typedef pfc::hash_set_t<const metadb_handle*, metadb_handle_hasher> handle_set_t;
+
+	//! Removes repeated items, keeping the first occurrence of each. For a union, add_items() then dedupe().
+	void dedupe(metadb_handle_list_ref p_list, handle_set_t & p_scratch);
+	//! Removes from p_list every item that is in p_remove.
+	void difference(metadb_handle_list_ref p_list, metadb_handle_list_cref p_remove, handle_set_t & p_scratch);
+	//! Removes from p_list every item that is not in p_keep.
+	void intersect(metadb_handle_list_ref p_list, metadb_handle_list_cref p_keep, handle_set_t & p_scratch);
+	//! Returns whether the lists have any item in common.
+	bool contains_any(metadb_handle_list_cref p_list_1, metadb_handle_list_cref p_list_2, handle_set_t & p_scratch);
+
 	double calc_total_duration(metadb_handle_list_cref p_list);
 
 	//! New method to deal with slower metadb in foobar2000 v2
@@ -140,30 +140,99 @@ void metadb_handle_list_helper::sort_by_relative_path_get_order(metadb_handle_li
 
 void metadb_handle_list_helper::remove_duplicates(metadb_handle_list_ref p_list)
 {
-	t_size count = p_list.get_count();
-	if (count>0)
+	handle_set_t scratch;
+	dedupe(p_list,scratch);
+}
+
+namespace {
+	void fill_handle_set(metadb_handle_list_helper::handle_set_t & p_set,metadb_handle_list_cref p_list)
 	{
-		pfc::bit_array_bittable mask(count);
-		pfc::array_t<t_size> order; order.set_size(count);
-		order_helper::g_fill(order);
+		const t_size count = p_list.get_count();
+		p_set.remove_all();
+		p_set.prealloc(count);
+		metadb_handle_ptr item;
+		for(t_size n=0;n<count;n++)
+		{
+			p_list.get_item_ex(item,n);
+			p_set.add_item(item.get_ptr());
+		}
+	}
 
-		p_list.sort_get_permutation_t(pfc::compare_t<metadb_handle_ptr,metadb_handle_ptr>,order.get_ptr());
-		
-		t_size n;
+	void remove_by_set(metadb_handle_list_ref p_list,const metadb_handle_list_helper::handle_set_t & p_set,bool p_in_set)
+	{
+		const t_size count = p_list.get_count();
+		pfc::bit_array_bittable mask(count);
 		bool found = false;
-		for(n=0;n<count-1;n++)
+		metadb_handle_ptr item;
+		for(t_size n=0;n<count;n++)
 		{
-			if (p_list.get_item(order[n])==p_list.get_item(order[n+1]))
+			p_list.get_item_ex(item,n);
+			if (p_set.have_item(item.get_ptr()) == p_in_set)
 			{
 				found = true;
-				mask.set(order[n+1],true);
+				mask.set(n,true);
 			}
 		}
-		
 		if (found) p_list.remove_mask(mask);
 	}
 }
 
+void metadb_handle_list_helper::dedupe(metadb_handle_list_ref p_list,handle_set_t & p_scratch)
+{
+	const t_size count = p_list.get_count();
+	if (count < 2) return;
+
+	p_scratch.remove_all();
+	p_scratch.prealloc(count);
+	pfc::bit_array_bittable mask(count);
+	bool found = false;
+	metadb_handle_ptr item;
+	for(t_size n=0;n<count;n++)
+	{
+		p_list.get_item_ex(item,n);
+		if (!p_scratch.add_item_check(item.get_ptr()))
+		{
+			found = true;
+			mask.set(n,true);
+		}
+	}
+	if (found) p_list.remove_mask(mask);
+}
+
+void metadb_handle_list_helper::difference(metadb_handle_list_ref p_list,metadb_handle_list_cref p_remove,handle_set_t & p_scratch)
+{
+	if (p_list.get_count() == 0 || p_remove.get_count() == 0) return;
+	fill_handle_set(p_scratch,p_remove);
+	remove_by_set(p_list,p_scratch,true);
+}
+
+void metadb_handle_list_helper::intersect(metadb_handle_list_ref p_list,metadb_handle_list_cref p_keep,handle_set_t & p_scratch)
+{
+	if (p_list.get_count() == 0) return;
+	if (p_keep.get_count() == 0) {p_list.remove_all(); return;}
+	fill_handle_set(p_scratch,p_keep);
+	remove_by_set(p_list,p_scratch,false);
+}
+
+bool metadb_handle_list_helper::contains_any(metadb_handle_list_cref p_list_1,metadb_handle_list_cref p_list_2,handle_set_t & p_scratch)
+{
+	// hash the shorter list, walk the longer one until the first hit
+	const bool swap = p_list_1.get_count() > p_list_2.get_count();
+	metadb_handle_list_cref hashed = swap ? p_list_2 : p_list_1;
+	metadb_handle_list_cref walked = swap ? p_list_1 : p_list_2;
+	if (hashed.get_count() == 0) return false;
+
+	fill_handle_set(p_scratch,hashed);
+	const t_size count = walked.get_count();
+	metadb_handle_ptr item;
+	for(t_size n=0;n<count;n++)
+	{
+		walked.get_item_ex(item,n);
+		if (p_scratch.have_item(item.get_ptr())) return true;
+	}
+	return false;
+}
+
 void metadb_handle_list_helper::sort_by_pointer_remove_duplicates(metadb_handle_list_ref p_list)
 {
 	t_size count = p_list.get_count();
@@ -469,12 +538,8 @@ void metadb_handle_list_helper::sort_by_format_get_order_v3(metadb_handle_list_c
 			return pfc::sgn_t((t_ssize)elem1.index - (t_ssize)elem2.index);
 		};
 
-		typedef decltype(data) container_t;
-		typedef decltype(compare) compare_t;
-		pfc::sort_callback_impl_simple_wrap_t<container_t, compare_t> cb(data, compare);
-
 		size_t concurrency = pfc::getOptimalWorkerThreadCountEx(count / 4096);
-		fb2k::sort(cb, count, concurrency, aborter);
+		fb2k::sort_parallel_t(data.get(), count, compare, concurrency, aborter);
 	}
 
 	//qsort(data.get_ptr(),count,sizeof(custom_sort_data),p_direction > 0 ? _custom_sort_compare<1> : _custom_sort_compare<-1>);
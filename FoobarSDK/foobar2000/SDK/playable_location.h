@@ -43,6 +43,13 @@ public:
 	public:
 		static int compare(const playable_location & v1, const playable_location & v2) {return g_compare(v1,v2);}
 	};
+
+	//! Hasher for pfc::hash_map_t / pfc::hash_set_t, consistent with g_equals(), which compares paths case sensitively.
+	class hasher {
+	public:
+		static t_uint32 hash(const playable_location & v) {return pfc::hash_combine(pfc::hash_string(v.get_path()), v.get_subsong());}
+		static bool equals(const playable_location & v1, const playable_location & v2) {return g_equals(v1,v2);}
+	};
 	static int path_compare( const char * p1, const char * p2 );
 
 protected:
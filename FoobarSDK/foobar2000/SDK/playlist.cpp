@@ -594,14 +594,14 @@ void playlist_manager::active_playlist_fix()
 namespace {
 	class enum_items_callback_remove_list : public playlist_manager::enum_items_callback
 	{
-		const metadb_handle_list & m_data;
+		const metadb_handle_list_helper::handle_set_t & m_data;
 		bit_array_var & m_table;
 		t_size m_found;
 	public:
-		enum_items_callback_remove_list(const metadb_handle_list & p_data,bit_array_var & p_table) : m_data(p_data), m_table(p_table), m_found(0) {}
+		enum_items_callback_remove_list(const metadb_handle_list_helper::handle_set_t & p_data,bit_array_var & p_table) : m_data(p_data), m_table(p_table), m_found(0) {}
 		bool on_item(t_size p_index,const metadb_handle_ptr & p_location,bool b_selected)
 		{
-			bool found = m_data.bsearch_by_pointer(p_location) != pfc_infinite;
+			bool found = m_data.have_item(p_location.get_ptr());
 			m_table.set(p_index,found);
 			if (found) m_found++;
 			return true;
@@ -616,9 +616,9 @@ void playlist_manager::remove_items_from_all_playlists(const pfc::list_base_cons
 	t_size playlist_num, playlist_max = get_playlist_count();
 	if (playlist_max != pfc_infinite)
 	{
-		metadb_handle_list temp;
-		temp.add_items(p_data);
-		temp.sort_by_pointer();
+		metadb_handle_list_helper::handle_set_t temp;
+		temp.prealloc(p_data.get_count());
+		for(t_size n = 0; n < p_data.get_count(); n++) temp.add_item(p_data[n].get_ptr());
 		for(playlist_num = 0; playlist_num < playlist_max; playlist_num++ )
 		{
 			t_size playlist_item_count = playlist_get_item_count(playlist_num);
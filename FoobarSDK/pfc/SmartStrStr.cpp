@@ -3,6 +3,7 @@
 #include "string-conv-lite.h"
 #include "string_conv.h"
 #include "SmartStrStr.h"
+#include "string-ascii.h"
 #include <algorithm>
 #include "SmartStrStr-table.h"
 #include "SmartStrStr-twoCharMappings.h"
@@ -98,6 +99,17 @@ SmartStrStr::SmartStrStr() {
 template<typename char_t> const char_t * SmartStrStr::matchHere_(const char_t * pString, const char_t * pUserString) const {
     auto walkData = pString;
     auto walkUser = pUserString;
+
+    // An ASCII data char matches the same user char, or the lower case one if it is upper case; nothing else,
+    // not even through m_twoCharMappings. Decode only from the first non-ASCII char on.
+    for (;; ) {
+        const uint32_t cUser = (uint32_t)*walkUser, cData = (uint32_t)*walkData;
+        if (cUser == 0) return walkData;
+        if (cUser >= 0x80 || cData >= 0x80) break;
+        if (cData != cUser && pfc::ascii_tolower(cData) != cUser) return nullptr;
+        ++walkData; ++walkUser;
+    }
+
     for (;; ) {
         if (*walkUser == 0) return walkData;
 
@@ -175,9 +187,56 @@ bool SmartStrStr::equalsW( const wchar_t * pString, const wchar_t * pUserString)
     return equals_(pString, pUserString);
 }
 const char * SmartStrStr::strStrEnd(const char * pString, const char * pSubString, size_t * outFoundAt) const {
+    const size_t subLen = strlen(pSubString);
+    if (subLen > 0 && pfc::isPureASCII(pSubString, subLen)) return strStrEndASCII(pString, pSubString, subLen, outFoundAt);
     return strStrEnd_(pString, pSubString, outFoundAt);
 }
 
+const char * SmartStrStr::strStrEndASCII(const char * pString, const char * pSubString, size_t subLen, size_t * outFoundAt) const {
+    // ASCII user chars only match ASCII data one to one (see matchHere_), runs of ASCII data are searched a block
+    // at a time and the Unicode path is only taken at the non-ASCII chars between them
+    const size_t len = strlen(pString);
+    size_t walk = 0;
+    for (;; ) {
+        const size_t run = walk + pfc::asciiSpan(pString + walk, len - walk);
+
+        const size_t found = findASCII(pString + walk, run - walk, pSubString, subLen);
+        if (found != SIZE_MAX) {
+            if (outFoundAt != nullptr) *outFoundAt = walk + found;
+            return pString + walk + found + subLen;
+        }
+        if (run == len) return nullptr;
+
+        // matches running from the end of the run into the non-ASCII char, or starting at it
+        for (size_t at = (run - walk >= subLen) ? run - subLen + 1 : walk; at <= run; ++at) {
+            auto end = matchHere(pString + at, pSubString);
+            if (end != nullptr) {
+                if (outFoundAt != nullptr) *outFoundAt = at;
+                return end;
+            }
+        }
+
+        const size_t delta = pfc::uni_char_length(pString + run);
+        if (delta == 0) return nullptr;
+        walk = run + delta;
+    }
+}
+
+size_t SmartStrStr::findASCII(const char * pString, size_t len, const char * pSubString, size_t subLen) const {
+    bool upper = false;
+    for (size_t walk = 0; walk < subLen; ++walk) upper |= (pSubString[walk] >= 'A' && pSubString[walk] <= 'Z');
+
+    // asciiFindI ignores case both ways, upper case user chars only match themselves
+    for (size_t from = 0; from < len; ) {
+        size_t at = pfc::asciiFindI(pString + from, len - from, pSubString, subLen);
+        if (at == SIZE_MAX) break;
+        at += from;
+        if (!upper || matchHere(pString + at, pSubString) != nullptr) return at;
+        from = at + 1;
+    }
+    return SIZE_MAX;
+}
+
 const char16_t * SmartStrStr::strStrEnd16(const char16_t * pString, const char16_t * pSubString, size_t * outFoundAt) const {
     return strStrEnd_(pString, pSubString, outFoundAt);
 }
@@ -329,6 +388,9 @@ bool SmartStrStr::testSubString_prefix_subst(const char* str, const char* sub, u
 	return false;
 }
 bool SmartStrStr::testSubstring(const char* str, const char* sub) const {
+	// ASCII on both sides, most tags are: a plain search a block at a time
+	const size_t subLen = strlen(sub), len = strlen(str);
+	if (subLen > 0 && pfc::isPureASCII(sub, subLen) && pfc::isPureASCII(str, len)) return findASCII(str, len, sub, subLen) != SIZE_MAX;
 #if 1
     // optimized version for UTF-8
 	unsigned prefix;
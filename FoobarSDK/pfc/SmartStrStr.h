@@ -55,6 +55,8 @@ private:
     template<typename char_t> const char_t * strStrEnd_(const char_t * pString, const char_t * pSubString, size_t * outFoundAt = nullptr) const;
     template<typename char_t> const char_t * matchHere_(const char_t * pString, const char_t * pUserString) const;
     template<typename char_t> bool equals_( const char_t * pString, const char_t * pUserString) const;
+    const char * strStrEndASCII(const char * pString, const char * pSubString, size_t subLen, size_t * outFoundAt) const;
+    size_t findASCII(const char * pString, size_t len, const char * pSubString, size_t subLen) const;
     
 	bool testSubString_prefix(const char* str, const char* sub, const char * prefix, size_t prefixLen) const;
 	bool testSubString_prefix(const char* str, const char* sub, uint32_t c) const;
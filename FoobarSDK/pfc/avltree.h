@@ -4,11 +4,18 @@
 
 namespace pfc {
 
-	template<typename t_storage>
+	// Node allocation policy of avltree_t / map_t; see avltree_pool.h for a pooled one
+	class avltree_alloc_default {
+	public:
+		template<size_t t_size> static void * node_alloc() {return ::operator new(t_size);}
+		template<size_t t_size> static void node_free(void * p) throw() {::operator delete(p);}
+	};
+
+	template<typename t_storage, typename t_alloc = avltree_alloc_default>
 	class _avltree_node : public _list_node<t_storage> {
 	public:
 		typedef _list_node<t_storage> t_node;
-		typedef _avltree_node<t_storage> t_self;
+		typedef _avltree_node<t_storage,t_alloc> t_self;
 		template<typename t_param> _avltree_node(t_param const& param) : t_node(param) {}
 
 		typedef refcounted_object_ptr_t<t_self> t_ptr;
@@ -68,22 +75,26 @@ namespace pfc {
 		}
 		t_node * prev() throw() {return step(false);}
 		t_node * next() throw() {return step(true);}
+
+		// also used by refcounted_object_root's delete this
+		static void * operator new(size_t size) {PFC_ASSERT(size == sizeof(t_self)); (void)size; return t_alloc::template node_alloc<sizeof(t_self)>();}
+		static void operator delete(void * p) throw() {t_alloc::template node_free<sizeof(t_self)>(p);}
 	private:
 		~_avltree_node() throw() {}
 	};
 
 	
-	template<typename t_storage,typename t_comparator = comparator_default>
+	template<typename t_storage,typename t_comparator = comparator_default,typename t_alloc = avltree_alloc_default>
 	class avltree_t {
 	public:
-		typedef avltree_t<t_storage,t_comparator> t_self;
+		typedef avltree_t<t_storage,t_comparator,t_alloc> t_self;
 		typedef pfc::const_iterator<t_storage> const_iterator;
 		typedef pfc::iterator<t_storage> iterator;
 		typedef pfc::forward_iterator<t_storage> forward_iterator;
 		typedef pfc::forward_const_iterator<t_storage> forward_const_iterator;
 		typedef t_storage t_item;
 	private:
-		typedef _avltree_node<t_storage> t_node;
+		typedef _avltree_node<t_storage,t_alloc> t_node;
 #if 1//MSVC8 bug fix
 		typedef refcounted_object_ptr_t<t_node> t_nodeptr;
 		typedef t_node * t_noderawptr;
@@ -226,26 +237,29 @@ namespace pfc {
 		}
 
 
+		// rotations move the links around instead of copying them, no reference count changes
 		static void g_rotate_right(t_nodeptr & oldroot) {
-			t_nodeptr newroot ( oldroot->m_right );
-			oldroot->link_child(true, newroot->m_left.get_ptr());
-			newroot->m_left   = oldroot;
+			t_nodeptr newroot ( std::move(oldroot->m_right) );
+			oldroot->m_right = std::move(newroot->m_left);
+			if (oldroot->m_right.is_valid()) oldroot->m_right->m_parent = oldroot.get_ptr();
 			newroot->m_parent = oldroot->m_parent;
 			oldroot->m_parent = newroot.get_ptr();
 			recalc_depth(oldroot);
+			newroot->m_left = std::move(oldroot);
 			recalc_depth(newroot);
-			oldroot = newroot;
+			oldroot = std::move(newroot);
 		}
 
 		static void g_rotate_left(t_nodeptr & oldroot) {
-			t_nodeptr newroot ( oldroot->m_left );
-			oldroot->link_child(false, newroot->m_right.get_ptr());
-			newroot->m_right  = oldroot;
+			t_nodeptr newroot ( std::move(oldroot->m_left) );
+			oldroot->m_left = std::move(newroot->m_right);
+			if (oldroot->m_left.is_valid()) oldroot->m_left->m_parent = oldroot.get_ptr();
 			newroot->m_parent = oldroot->m_parent;
 			oldroot->m_parent = newroot.get_ptr();
 			recalc_depth(oldroot);
+			newroot->m_right = std::move(oldroot);
 			recalc_depth(newroot);
-			oldroot = newroot;
+			oldroot = std::move(newroot);
 		}
 
 		static void g_rebalance(t_nodeptr & p_node) {
@@ -573,6 +587,6 @@ namespace pfc {
 	};
 
 
-	template<typename t_storage,typename t_comparator>
-	class traits_t<avltree_t<t_storage,t_comparator> > : public traits_default_movable {};
+	template<typename t_storage,typename t_comparator,typename t_alloc>
+	class traits_t<avltree_t<t_storage,t_comparator,t_alloc> > : public traits_default_movable {};
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+// Pooled node allocation for avltree_t / map_t, chosen per container:
+//     pfc::map_t<pfc::string8, int, pfc::comparator_strcmp, pfc::avltree_alloc_pool> map;
+// Nodes of one size are carved from 64 KB slabs and recycled through a free list shared by every container
+// using the policy. Building a large tree then costs one allocation per slab instead of one per node, and
+// nodes created together sit next to each other. Slabs are kept for reuse and never given back, so this suits
+// containers that are rebuilt over and over rather than one-off peaks. Once every node is free again the pool
+// carves the kept slabs from the start again instead of handing out the free list, whose order is the order
+// the last tree was torn down in, scattered all over the slabs.
+
+namespace pfc {
+
+	template<size_t t_size>
+	class _avltree_node_pool {
+	public:
+		static void * alloc() {
+			{
+				lock_scope scope;
+				void * ret = take();
+				if (ret != NULL) return ret;
+			}
+
+			// allocated without holding the lock, it may throw
+			char * slab = (char*) ::operator new(slab_bytes);
+			*(char**) slab = NULL;
+
+			lock_scope scope;
+			// the first item of every slab links the slabs together, in the order they were allocated
+			if (s_last != NULL) *(char**) s_last = slab;
+			else s_first = slab;
+			s_last = slab;
+			// another thread may have added a slab meanwhile, this one then waits at the end of the chain
+			void * ret = take();
+			PFC_ASSERT(ret != NULL);
+			return ret;
+		}
+
+		static void release(void * p) throw() {
+			lock_scope scope;
+			*(void**) p = s_free;
+			s_free = p;
+			if (--s_live == 0) {
+				// nothing is in use, start over at the first slab
+				s_free = NULL;
+				s_slab = NULL;
+				s_cursor = s_end = NULL;
+			}
+		}
+
+	private:
+		// with the lock held; NULL when every slab is used up
+		static void * take() {
+			void * ret = s_free;
+			if (ret != NULL) {
+				s_free = *(void**) ret;
+			} else {
+				if (s_cursor == s_end) {
+					char * next = (s_slab != NULL) ? *(char**) s_slab : s_first;
+					if (next == NULL) return NULL;
+					s_slab = next;
+					s_cursor = next + item_bytes;
+					s_end = next + items_per_slab * item_bytes;
+				}
+				ret = s_cursor;
+				s_cursor += item_bytes;
+			}
+			++s_live;
+			return ret;
+		}
+
+		enum {
+			item_align = sizeof(void*) * 2,
+			item_bytes = (t_size + item_align - 1) / item_align * item_align,
+			slab_bytes = 64 * 1024,
+			items_per_slab = slab_bytes / item_bytes,
+		};
+
+		// held for a few instructions only, a spinning flag is cheaper than any mutex here
+		class lock_scope {
+		public:
+			lock_scope() {
+				while (threadSafeInt::exchangeHere(s_lock, 1) != 0) pfc::yield();
+			}
+			~lock_scope() {
+				threadSafeInt::exchangeHere(s_lock, 0);
+			}
+		};
+
+		static volatile threadSafeInt::val_t s_lock;
+		static void * s_free;
+		static char * s_first;		// slab chain
+		static char * s_last;
+		static char * s_slab;		// slab being carved, s_cursor ... s_end is what is left of it
+		static char * s_cursor;
+		static char * s_end;
+		static size_t s_live;		// nodes handed out and not released yet
+	};
+
+	template<size_t t_size> volatile threadSafeInt::val_t _avltree_node_pool<t_size>::s_lock = 0;
+	template<size_t t_size> void * _avltree_node_pool<t_size>::s_free = NULL;
+	template<size_t t_size> char * _avltree_node_pool<t_size>::s_first = NULL;
+	template<size_t t_size> char * _avltree_node_pool<t_size>::s_last = NULL;
+	template<size_t t_size> char * _avltree_node_pool<t_size>::s_slab = NULL;
+	template<size_t t_size> char * _avltree_node_pool<t_size>::s_cursor = NULL;
+	template<size_t t_size> char * _avltree_node_pool<t_size>::s_end = NULL;
+	template<size_t t_size> size_t _avltree_node_pool<t_size>::s_live = 0;
+
+	class avltree_alloc_pool {
+	public:
+		template<size_t t_size> static void * node_alloc() {return _avltree_node_pool<t_size>::alloc();}
+		template<size_t t_size> static void node_free(void * p) throw() {_avltree_node_pool<t_size>::release(p);}
+	};
+}
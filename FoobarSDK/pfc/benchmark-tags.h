@@ -0,0 +1,143 @@
+#pragma once
+
+// Artist, album and title tags as they appear in real libraries, the corpus pfc::benchmark() runs the ASCII scans on.
+// Mostly ASCII with accented, Cyrillic, Japanese and Korean names mixed in;
+// non-ASCII chars are spelled as UTF-8 escapes so that the compiler's source charset does not matter.
+
+namespace pfc {
+	static const char * const benchmarkTags[] = {
+		"The Beatles", "Abbey Road (Remastered 2009)", "Here Comes the Sun - Remastered 2009",
+		"The Beatles", "Sgt. Pepper's Lonely Hearts Club Band", "Lucy in the Sky with Diamonds",
+		"Pink Floyd", "The Dark Side of the Moon", "Brain Damage",
+		"Pink Floyd", "Wish You Were Here", "Shine On You Crazy Diamond (Pts. 1-5)",
+		"Led Zeppelin", "Led Zeppelin IV (Remaster)", "Stairway to Heaven - Remaster",
+		"Queen", "A Night at the Opera (2011 Remaster)", "Bohemian Rhapsody - Remastered 2011",
+		"David Bowie", "The Rise and Fall of Ziggy Stardust and the Spiders from Mars", "Starman - 2012 Remaster",
+		"Fleetwood Mac", "Rumours", "Go Your Own Way",
+		"Radiohead", "OK Computer", "Paranoid Android",
+		"Radiohead", "Kid A", "Everything in Its Right Place",
+		"Bj\xC3\xB6rk", "Homogenic", "J\xC3\xB3ga",
+		"Bj\xC3\xB6rk", "Vespertine", "Hidden Place",
+		"Sigur R\xC3\xB3s", "\xC3\x81g\xC3\xA6tis byrjun", "Svefn-g-englar",
+		"Sigur R\xC3\xB3s", "Takk...", "Hopp\xC3\xADpolla",
+		"Mot\xC3\xB6rhead", "Ace of Spades", "Ace of Spades",
+		"Blue \xC3\x96yster Cult", "Agents of Fortune", "(Don't Fear) The Reaper",
+		"M\xC3\xB6tley Cr\xC3\xBC" "e", "Dr. Feelgood", "Kickstart My Heart",
+		"Beyonc\xC3\xA9", "Lemonade", "Formation",
+		"C\xC3\xA9line Dion", "Let's Talk About Love", "My Heart Will Go On (Love Theme from \"Titanic\")",
+		"\xC3\x89" "dith Piaf", "La Vie en rose", "Non, je ne regrette rien",
+		"Serge Gainsbourg", "Histoire de Melody Nelson", "Ballade de Melody Nelson",
+		"Fran\xC3\xA7oise Hardy", "Tous les gar\xC3\xA7ons et les filles", "Le temps de l'amour",
+		"Daft Punk", "Random Access Memories", "Get Lucky (feat. Pharrell Williams & Nile Rodgers)",
+		"Daft Punk", "Discovery", "One More Time",
+		"Kraftwerk", "Trans-Europa Express", "Europa Endlos",
+		"Rammstein", "Mutter", "Sonne",
+		"Die \xC3\x84rzte", "Die Bestie in Menschengestalt", "Schrei nach Liebe",
+		"Einst\xC3\xBCrzende Neubauten", "Halber Mensch", "Halber Mensch",
+		"Anton\xC3\xADn Dvo\xC5\x99\xC3\xA1k; Wiener Philharmoniker, Herbert von Karajan", "Symphony No. 9 \"From the New World\"", "Symphony No. 9 in E Minor, Op. 95, B. 178 \"From the New World\": II. Largo",
+		"Ludwig van Beethoven; Berliner Philharmoniker, Claudio Abbado", "Beethoven: Symphonies Nos. 7 & 9", "Symphony No. 9 in D Minor, Op. 125 \"Choral\": IV. Presto \xE2\x80\x93 Allegro assai",
+		"Johann Sebastian Bach; Glenn Gould", "Bach: The Goldberg Variations, BWV 988 (1981 Recording)", "Goldberg Variations, BWV 988: Aria",
+		"Fr\xC3\xA9" "d\xC3\xA9ric Chopin; Krystian Zimerman", "Chopin: Ballades; Barcarolle; Fantaisie", "Ballade No. 1 in G Minor, Op. 23",
+		"Pyotr Ilyich Tchaikovsky; London Symphony Orchestra", "Tchaikovsky: The Nutcracker, Op. 71", "The Nutcracker, Op. 71, Act II: No. 14c, Dance of the Sugar-Plum Fairy",
+		"Erik Satie; Pascal Rog\xC3\xA9", "Satie: Piano Works", "Gymnop\xC3\xA9" "die No. 1",
+		"Arvo P\xC3\xA4rt", "Tabula Rasa", "Fratres (for violin and piano)",
+		"Henryk G\xC3\xB3recki; London Sinfonietta, David Zinman", "Symphony No. 3 \"Symphony of Sorrowful Songs\"", "I. Lento \xE2\x80\x93 Sostenuto tranquillo ma cantabile",
+		"Miles Davis", "Kind of Blue (Legacy Edition)", "So What",
+		"John Coltrane", "A Love Supreme", "A Love Supreme, Pt. I \xE2\x80\x93 Acknowledgement",
+		"Dave Brubeck Quartet", "Time Out", "Take Five",
+		"Thelonious Monk", "Brilliant Corners", "Pannonica",
+		"Bill Evans Trio", "Sunday at the Village Vanguard", "Gloria's Step (Take 2)",
+		"Stan Getz & Jo\xC3\xA3o Gilberto", "Getz/Gilberto", "The Girl from Ipanema (Garota de Ipanema)",
+		"Ant\xC3\xB4nio Carlos Jobim", "Wave", "\xC3\x81guas de Mar\xC3\xA7o",
+		"Caetano Veloso", "Transa", "You Don't Know Me",
+		"Os Mutantes", "Os Mutantes", "A Minha Menina",
+		"Buena Vista Social Club", "Buena Vista Social Club", "Chan Chan",
+		"Caf\xC3\xA9 Tacvba", "Re", "La ingrata",
+		"Rosal\xC3\xAD" "a", "El Mal Querer", "MALAMENTE - Cap.1: Augurio",
+		"Manu Chao", "Clandestino", "Me gustas t\xC3\xBA",
+		"Mercedes Sosa", "Gracias a la vida", "Gracias a la vida",
+		"Fela Kuti", "Zombie", "Zombie",
+		"Tinariwen", "Imidiwan: Companions", "Tenhert",
+		"Ali Farka Tour\xC3\xA9 & Toumani Diabat\xC3\xA9", "In the Heart of the Moon", "Debe",
+		"Ryuichi Sakamoto", "Merry Christmas Mr. Lawrence", "Merry Christmas Mr. Lawrence",
+		"\xE5\x9D\x82\xE6\x9C\xAC\xE9\xBE\x8D\xE4\xB8\x80", "\xE6\x88\xA6\xE5\xA0\xB4\xE3\x81\xAE\xE3\x83\xA1\xE3\x83\xAA\xE3\x83\xBC\xE3\x82\xAF\xE3\x83\xAA\xE3\x82\xB9\xE3\x83\x9E\xE3\x82\xB9", "\xE6\x88\xA6\xE5\xA0\xB4\xE3\x81\xAE\xE3\x83\xA1\xE3\x83\xAA\xE3\x83\xBC\xE3\x82\xAF\xE3\x83\xAA\xE3\x82\xB9\xE3\x83\x9E\xE3\x82\xB9",
+		"\xE5\xAE\x87\xE5\xA4\x9A\xE7\x94\xB0\xE3\x83\x92\xE3\x82\xAB\xE3\x83\xAB", "First Love", "Automatic",
+		"Yellow Magic Orchestra", "Solid State Survivor", "Rydeen",
+		"\xE4\xB9\x85\xE7\x9F\xB3\xE8\xAD\xB2", "\xE3\x81\xA8\xE3\x81\xAA\xE3\x82\x8A\xE3\x81\xAE\xE3\x83\x88\xE3\x83\x88\xE3\x83\xAD \xE3\x82\xB5\xE3\x82\xA6\xE3\x83\xB3\xE3\x83\x89\xE3\x83\x88\xE3\x83\xA9\xE3\x83\x83\xE3\x82\xAF\xE9\x9B\x86", "\xE3\x81\xA8\xE3\x81\xAA\xE3\x82\x8A\xE3\x81\xAE\xE3\x83\x88\xE3\x83\x88\xE3\x83\xAD",
+		"BTS (\xEB\xB0\xA9\xED\x83\x84\xEC\x86\x8C\xEB\x85\x84\xEB\x8B\xA8)", "Map of the Soul: 7", "ON",
+		"\xD0\x9A\xD0\xB8\xD0\xBD\xD0\xBE", "\xD0\x93\xD1\x80\xD1\x83\xD0\xBF\xD0\xBF\xD0\xB0 \xD0\xBA\xD1\x80\xD0\xBE\xD0\xB2\xD0\xB8", "\xD0\x93\xD1\x80\xD1\x83\xD0\xBF\xD0\xBF\xD0\xB0 \xD0\xBA\xD1\x80\xD0\xBE\xD0\xB2\xD0\xB8",
+		"\xD0\x9C\xD1\x83\xD0\xBC\xD0\xB8\xD0\xB9 \xD0\xA2\xD1\x80\xD0\xBE\xD0\xBB\xD0\xBB\xD1\x8C", "\xD0\x9C\xD0\xBE\xD1\x80\xD1\x81\xD0\xBA\xD0\xB0\xD1\x8F", "\xD0\x92\xD0\xBB\xD0\xB0\xD0\xB4\xD0\xB8\xD0\xB2\xD0\xBE\xD1\x81\xD1\x82\xD0\xBE\xD0\xBA 2000",
+		"Sezen Aksu", "I\xC5\x9F\xC4\xB1k Do\xC4\x9Fudan Y\xC3\xBCkselir", "\xC5\x9E" "ark\xC4\xB1 S\xC3\xB6ylemek Laz\xC4\xB1m",
+		"\xC3\x93lafur Arnalds", "re:member", "saman",
+		"J\xC3\xB3hann J\xC3\xB3hannsson", "Orph\xC3\xA9" "e", "A Song for Europa",
+		"Max Richter", "The Blue Notebooks", "On the Nature of Daylight",
+		"Nils Frahm", "Spaces", "Says",
+		"Brian Eno", "Ambient 1: Music for Airports", "1/1",
+		"Aphex Twin", "Selected Ambient Works 85-92", "Xtal",
+		"Boards of Canada", "Music Has the Right to Children", "Roygbiv",
+		"Massive Attack", "Mezzanine", "Teardrop",
+		"Portishead", "Dummy", "Glory Box",
+		"Bj\xC3\xB6rk", "Post", "Army of Me",
+		"Nirvana", "Nevermind (Remastered)", "Smells Like Teen Spirit",
+		"Pearl Jam", "Ten", "Alive",
+		"Soundgarden", "Superunknown (20th Anniversary)", "Black Hole Sun",
+		"Red Hot Chili Peppers", "Californication (Deluxe Edition)", "Scar Tissue",
+		"Metallica", "Master of Puppets (Remastered)", "Master of Puppets (Remastered)",
+		"Iron Maiden", "The Number of the Beast (2015 Remaster)", "Run to the Hills",
+		"Black Sabbath", "Paranoid (2009 Remastered Version)", "War Pigs / Luke's Wall",
+		"AC/DC", "Back in Black", "You Shook Me All Night Long",
+		"Guns N' Roses", "Appetite for Destruction", "Sweet Child o' Mine",
+		"The Rolling Stones", "Sticky Fingers (Super Deluxe)", "Can't You Hear Me Knocking - Remastered",
+		"The Who", "Who's Next (Deluxe Edition)", "Baba O'Riley",
+		"The Velvet Underground & Nico", "The Velvet Underground & Nico 45th Anniversary", "Femme Fatale",
+		"Simon & Garfunkel", "Bridge over Troubled Water", "The Boxer",
+		"Bob Dylan", "Highway 61 Revisited", "Like a Rolling Stone",
+		"Leonard Cohen", "Songs of Leonard Cohen", "Suzanne",
+		"Joni Mitchell", "Blue", "A Case of You",
+		"Nick Drake", "Pink Moon", "Pink Moon",
+		"Jeff Buckley", "Grace", "Hallelujah",
+		"Kate Bush", "Hounds of Love", "Running Up That Hill (A Deal with God)",
+		"Prince & The Revolution", "Purple Rain", "When Doves Cry",
+		"Michael Jackson", "Thriller 25 Super Deluxe Edition", "Billie Jean",
+		"Stevie Wonder", "Songs in the Key of Life", "Sir Duke",
+		"Marvin Gaye", "What's Going On", "Mercy Mercy Me (The Ecology)",
+		"Aretha Franklin", "I Never Loved a Man the Way I Love You", "Respect",
+		"Nina Simone", "I Put a Spell on You", "Feeling Good",
+		"Amy Winehouse", "Back to Black", "Rehab",
+		"Adele", "21", "Rolling in the Deep",
+		"Kendrick Lamar", "To Pimp a Butterfly", "Alright",
+		"Kanye West", "My Beautiful Dark Twisted Fantasy", "Runaway (feat. Pusha T)",
+		"OutKast", "Speakerboxxx/The Love Below", "Hey Ya!",
+		"Lauryn Hill", "The Miseducation of Lauryn Hill", "Doo Wop (That Thing)",
+		"Wu-Tang Clan", "Enter the Wu-Tang (36 Chambers)", "C.R.E.A.M. (Cash Rules Everything Around Me)",
+		"Arctic Monkeys", "AM", "Do I Wanna Know?",
+		"The Strokes", "Is This It", "Last Nite",
+		"LCD Soundsystem", "Sound of Silver", "All My Friends",
+		"Arcade Fire", "Funeral", "Wake Up",
+		"Bon Iver", "For Emma, Forever Ago", "Skinny Love",
+		"Sufjan Stevens", "Carrie & Lowell", "Should Have Known Better",
+		"Beach House", "Bloom", "Myth",
+		"Tame Impala", "Currents", "The Less I Know the Better",
+		"Alt-J", "An Awesome Wave", "Breezeblocks",
+		"M\xC3\xB8", "No Mythologies to Follow", "Pilgrim",
+		"R\xC3\xB6yksopp", "Melody A.M.", "Eple",
+		"Kings of Convenience", "Riot on an Empty Street", "I'd Rather Dance with You",
+		"ABBA", "Arrival", "Dancing Queen",
+		"The Cardigans", "First Band on the Moon", "Lovefool",
+		"Ennio Morricone", "Il buono, il brutto, il cattivo (Original Soundtrack)", "L'estasi dell'oro",
+		"Hans Zimmer", "Interstellar (Original Motion Picture Soundtrack)", "No Time for Caution",
+		"Vangelis", "Blade Runner (Soundtrack from the Motion Picture)", "Blade Runner Blues",
+		"Various Artists", "Pulp Fiction (Music from the Motion Picture)", "Misirlou",
+		"Dick Dale & His Del-Tones", "King of the Surf Guitar", "Misirlou",
+		"Orchestre Symphonique de Montr\xC3\xA9" "al, Charles Dutoit", "Ravel: Bol\xC3\xA9ro; La Valse; Rapsodie espagnole", "Bol\xC3\xA9ro",
+		"Maurice Ravel; Martha Argerich", "Ravel: Gaspard de la nuit", "Gaspard de la nuit, M. 55: I. Ondine",
+		"Claude Debussy; Zolt\xC3\xA1n Kocsis", "Debussy: Images; Estampes; Suite bergamasque", "Suite bergamasque, L. 75: III. Clair de lune",
+		"Camille Saint-Sa\xC3\xABns; Orchestre de la Suisse Romande", "Saint-Sa\xC3\xABns: Le Carnaval des animaux", "Le Carnaval des animaux: XIII. Le cygne",
+		"Wolfgang Amadeus Mozart; Academy of St Martin in the Fields, Sir Neville Marriner", "Mozart: Requiem in D Minor, K. 626", "Requiem in D Minor, K. 626: III. Sequentia: 6. Lacrimosa",
+		"Antonio Vivaldi; Il Giardino Armonico", "Vivaldi: Le quattro stagioni", "Violin Concerto in F Minor, RV 297 \"L'inverno\": I. Allegro non molto",
+		"Gustav Mahler; Wiener Philharmoniker, Leonard Bernstein", "Mahler: Symphony No. 5", "Symphony No. 5 in C-Sharp Minor: IV. Adagietto. Sehr langsam",
+		"Richard Wagner; Wiener Philharmoniker, Sir Georg Solti", "Wagner: Die Walk\xC3\xBCre", "Die Walk\xC3\xBCre, WWV 86B, Act III: Walk\xC3\xBCrenritt",
+		"Sergei Rachmaninoff; Vladimir Ashkenazy", "Rachmaninov: Piano Concerto No. 2", "Piano Concerto No. 2 in C Minor, Op. 18: II. Adagio sostenuto",
+		"B\xC3\xA9la Bart\xC3\xB3k; Budapest Festival Orchestra, Iv\xC3\xA1n Fischer", "Bart\xC3\xB3k: Concerto for Orchestra", "Concerto for Orchestra, Sz. 116: IV. Intermezzo interrotto",
+	};
+}
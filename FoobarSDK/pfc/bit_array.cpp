@@ -167,6 +167,33 @@ namespace pfc {
 		return rv;
 	}
 
+	t_size bit_array_bittable::find(bool val, t_size start, t_ssize count) const
+	{
+		if (count <= 0) return bit_array::find(val, start, count);
+
+		const t_size end = start + count;
+		const t_size limit = pfc::min_t<t_size>(end, m_count);
+		const t_uint8 * data = m_data.get_ptr();
+		const t_size bytes = m_data.get_size();
+
+		for (t_size n = start; n < limit; n = (n | 63) + 1) {
+			// bit i of the word is item (n & ~63) + i, regardless of host byte order
+			const t_size base = (n >> 6) << 3;
+			t_uint64 word = 0;
+			for (t_size b = 0; b < 8 && base + b < bytes; ++b) word |= (t_uint64)data[base + b] << (b * 8);
+
+			if (!val) word = ~word;
+			word &= ~(t_uint64)0 << (n & 63);
+			if (word != 0) {
+				const t_size found = (n & ~(t_size)63) + pfc::findLowestBit64(word);
+				// bits past m_count read as false
+				return found < limit ? found : (val ? end : limit);
+			}
+		}
+
+		return val ? end : pfc::max_t<t_size>(start, limit);
+	}
+
 	t_size bit_array_one::find(bool p_val, t_size start, t_ssize count) const
 	{
 		if (count == 0) return start;
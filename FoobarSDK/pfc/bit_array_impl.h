@@ -179,6 +179,8 @@ namespace pfc {
 		void set(t_size n, bool val);
 
 		bool get(t_size n) const;
+		//! Forward searches test 64 bits at a time.
+		t_size find(bool val, t_size start, t_ssize count) const;
 
 		size_t size() const {return m_count;}
 	};
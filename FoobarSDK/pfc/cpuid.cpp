@@ -11,12 +11,16 @@ namespace pfc {
 
 	bool query_cpu_feature_set(unsigned p_value) {
 
-#ifdef __AVX__
-		// AVX implies all supported values are set
+#ifdef __AVX2__
+		// AVX2 implies all supported values are set
 		return true;
 #else
 
-#if _M_IX86_FP >= 2 || defined(_M_X64)
+#ifdef __AVX__
+		// AVX implies everything but AVX2
+		p_value &= CPU_HAVE_AVX2;
+		if (p_value == 0) return true;
+#elif _M_IX86_FP >= 2 || defined(_M_X64)
 		// don't bother checking for SSE/SSE2 if compiled to use them
 		p_value &= ~(CPU_HAVE_SSE | CPU_HAVE_SSE2);
 		if (p_value == 0) return true;
@@ -50,6 +54,15 @@ namespace pfc {
 					if ((buffer[2] & (1 << 28)) == 0) return false;
 				}
 			}
+			if (p_value & CPU_HAVE_AVX2) {
+				int buffer[4];
+				__cpuid(buffer, 1);
+				// AVX and OSXSAVE, then the OS must actually save the upper halves of the ymm registers
+				if ((buffer[2] & (1 << 28)) == 0 || (buffer[2] & (1 << 27)) == 0) return false;
+				if ((_xgetbv(0) & 6) != 6) return false;
+				__cpuidex(buffer, 7, 0);
+				if ((buffer[1] & (1 << 5)) == 0) return false;
+			}
 			return true;
 #ifdef _MSC_VER
 		} __except(1) {
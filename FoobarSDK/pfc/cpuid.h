@@ -12,6 +12,7 @@ namespace pfc {
 		CPU_HAVE_SSE41		= 1 << 6,
 		CPU_HAVE_SSE42		= 1 << 7,
 		CPU_HAVE_AVX		= 1 << 8,
+		CPU_HAVE_AVX2		= 1 << 9,
 	};
 
 	bool query_cpu_feature_set(unsigned p_value);
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <new>
+#include <utility>
+
+// Open-addressing hash containers with the unordered part of the map_t / avltree_t surface:
+// set / find_or_add / query / query_ptr / have_item / find / remove / enumerate.
+// Items live in one power-of-two array next to an array of their hashes and are probed linearly.
+// Removal shifts the following items back instead of leaving tombstones, so probes stay short.
+// Enumeration order is unspecified; any insertion or removal invalidates pointers into the container.
+//
+// A hasher provides static hash() and equals() for the stored key type and for any other type lookups are made with.
+
+namespace pfc {
+
+	// 64-bit finalizer (splitmix64), spreads pointers and small integers over all bits
+	inline t_uint32 hash_mix(t_uint64 v) {
+		v ^= v >> 30; v *= 0xbf58476d1ce4e5b9ULL;
+		v ^= v >> 27; v *= 0x94d049bb133111ebULL;
+		v ^= v >> 31;
+		return (t_uint32) v;
+	}
+
+	inline t_uint32 hash_combine(t_uint32 h, t_uint32 v) {
+		return hash_mix( ((t_uint64) h << 32) | v );
+	}
+
+	// FNV-1a
+	inline t_uint32 hash_bytes(const void * p, t_size bytes) {
+		const t_uint8 * walk = (const t_uint8 *) p;
+		t_uint32 h = 2166136261u;
+		for(t_size n = 0; n < bytes; ++n) { h ^= walk[n]; h *= 16777619u; }
+		return h;
+	}
+
+	inline t_uint32 hash_string(const char * p) {
+		t_uint32 h = 2166136261u;
+		for(; *p; ++p) { h ^= (t_uint8) *p; h *= 16777619u; }
+		return h;
+	}
+
+	class hasher_default {
+	public:
+		template<typename t_item> static t_uint32 hash(t_item * p) {return hash_mix((t_uint64)(t_size) p);}
+		template<typename t_item> static t_uint32 hash(const t_item & v) {return hash_mix((t_uint64) v);}
+		template<typename t_item1, typename t_item2> static bool equals(const t_item1 & v1, const t_item2 & v2) {return v1 == v2;}
+	};
+
+	// pfc::string8 / const char * keys, case sensitive
+	class hasher_strcmp {
+	public:
+		static t_uint32 hash(const char * p) {return hash_string(p);}
+		static bool equals(const char * p1, const char * p2) {return strcmp(p1, p2) == 0;}
+	};
+
+	template<typename t_storage, typename t_hasher>
+	class _hash_table {
+	public:
+		_hash_table() : m_items(), m_hashes(), m_mask(0), m_count(0) {}
+		~_hash_table() {_release();}
+
+		_hash_table(const _hash_table & p_source) : m_items(), m_hashes(), m_mask(0), m_count(0) {_copy(p_source);}
+		_hash_table(_hash_table && p_source) noexcept : m_items(), m_hashes(), m_mask(0), m_count(0) {_swap(p_source);}
+		_hash_table & operator=(const _hash_table & p_source) {
+			if (this != &p_source) { _release(); _copy(p_source); }
+			return *this;
+		}
+		_hash_table & operator=(_hash_table && p_source) noexcept {
+			if (this != &p_source) { _release(); _swap(p_source); }
+			return *this;
+		}
+
+		t_size get_count() const throw() {return m_count;}
+
+		template<typename t_param>
+		t_storage * find_ptr(const t_param & p_key) const {
+			if (m_count == 0) return NULL;
+			const t_uint32 h = _hash(p_key);
+			for(t_size walk = h & m_mask; ; walk = (walk + 1) & m_mask) {
+				const t_uint32 cur = m_hashes[walk];
+				if (cur == 0) return NULL;
+				if (cur == h && t_hasher::equals(m_items[walk].m_key, p_key)) return &m_items[walk];
+			}
+		}
+
+		template<typename t_param>
+		t_storage & add_ex(const t_param & p_key, bool & p_isnew) {
+			if ((m_count + 1) * 4 > _capacity() * 3) _grow();
+			const t_uint32 h = _hash(p_key);
+			t_size walk = h & m_mask;
+			for(;;) {
+				const t_uint32 cur = m_hashes[walk];
+				if (cur == 0) break;
+				if (cur == h && t_hasher::equals(m_items[walk].m_key, p_key)) {
+					p_isnew = false;
+					return m_items[walk];
+				}
+				walk = (walk + 1) & m_mask;
+			}
+			new(&m_items[walk]) t_storage(p_key);
+			m_hashes[walk] = h;
+			++m_count;
+			p_isnew = true;
+			return m_items[walk];
+		}
+
+		template<typename t_param>
+		bool remove_item(const t_param & p_key) {
+			t_storage * item = find_ptr(p_key);
+			if (item == NULL) return false;
+
+			t_size hole = item - m_items;
+			m_items[hole].~t_storage();
+			m_hashes[hole] = 0;
+			--m_count;
+
+			// pull back every following item that may not stay behind the hole
+			for(t_size walk = (hole + 1) & m_mask; m_hashes[walk] != 0; walk = (walk + 1) & m_mask) {
+				const t_size home = m_hashes[walk] & m_mask;
+				if (((walk - home) & m_mask) >= ((walk - hole) & m_mask)) {
+					new(&m_items[hole]) t_storage(std::move(m_items[walk]));
+					m_items[walk].~t_storage();
+					m_hashes[hole] = m_hashes[walk];
+					m_hashes[walk] = 0;
+					hole = walk;
+				}
+			}
+			return true;
+		}
+
+		void remove_all() throw() {
+			for(t_size walk = 0; walk < _capacity(); ++walk) {
+				if (m_hashes[walk] != 0) { m_items[walk].~t_storage(); m_hashes[walk] = 0; }
+			}
+			m_count = 0;
+		}
+
+		// makes room for the given number of items without rehashing
+		void prealloc(t_size p_count) {
+			while (p_count * 4 > _capacity() * 3) _grow();
+		}
+
+		template<typename t_callback>
+		void enumerate(t_callback & p_callback) const {
+			for(t_size walk = 0; walk < _capacity(); ++walk) {
+				if (m_hashes[walk] != 0) p_callback(const_cast<const t_storage &>(m_items[walk]));
+			}
+		}
+
+		template<typename t_callback>
+		void _enumerate_var(t_callback & p_callback) {
+			for(t_size walk = 0; walk < _capacity(); ++walk) {
+				if (m_hashes[walk] != 0) p_callback(m_items[walk]);
+			}
+		}
+
+	private:
+		// 0 marks an empty slot
+		template<typename t_param>
+		static t_uint32 _hash(const t_param & p_key) {
+			const t_uint32 h = t_hasher::hash(p_key);
+			return h != 0 ? h : 1;
+		}
+
+		t_size _capacity() const {return m_hashes != NULL ? m_mask + 1 : 0;}
+
+		void _grow() {
+			const t_size capacity = _capacity() > 0 ? _capacity() * 2 : 16;
+			t_storage * items = (t_storage *) ::operator new(capacity * sizeof(t_storage));
+			t_uint32 * hashes = new(std::nothrow) t_uint32[capacity]();
+			if (hashes == NULL) { ::operator delete(items); throw std::bad_alloc(); }
+
+			const t_size mask = capacity - 1;
+			for(t_size walk = 0; walk < _capacity(); ++walk) {
+				const t_uint32 h = m_hashes[walk];
+				if (h == 0) continue;
+				t_size target = h & mask;
+				while (hashes[target] != 0) target = (target + 1) & mask;
+				new(&items[target]) t_storage(std::move(m_items[walk]));
+				m_items[walk].~t_storage();
+				hashes[target] = h;
+			}
+
+			::operator delete(m_items);
+			delete[] m_hashes;
+			m_items = items; m_hashes = hashes; m_mask = mask;
+		}
+
+		void _release() throw() {
+			if (m_hashes == NULL) return;
+			remove_all();
+			::operator delete(m_items);
+			delete[] m_hashes;
+			m_items = NULL; m_hashes = NULL; m_mask = 0;
+		}
+
+		void _copy(const _hash_table & p_source) {
+			if (p_source.m_count == 0) return;
+			const t_size capacity = p_source._capacity();
+			m_items = (t_storage *) ::operator new(capacity * sizeof(t_storage));
+			m_hashes = new t_uint32[capacity]();
+			m_mask = capacity - 1;
+			for(t_size walk = 0; walk < capacity; ++walk) {
+				if (p_source.m_hashes[walk] == 0) continue;
+				new(&m_items[walk]) t_storage(p_source.m_items[walk]);
+				m_hashes[walk] = p_source.m_hashes[walk];
+				++m_count;
+			}
+		}
+
+		void _swap(_hash_table & p_other) throw() {
+			std::swap(m_items, p_other.m_items);
+			std::swap(m_hashes, p_other.m_hashes);
+			std::swap(m_mask, p_other.m_mask);
+			std::swap(m_count, p_other.m_count);
+		}
+
+		t_storage * m_items;
+		t_uint32 * m_hashes;
+		t_size m_mask;
+		t_size m_count;
+	};
+
+	template<typename t_storage_key, typename t_storage_value, typename t_hasher = hasher_default>
+	class hash_map_t {
+	private:
+		typedef hash_map_t<t_storage_key,t_storage_value,t_hasher> t_self;
+		struct t_storage;
+	public:
+		typedef t_storage_key t_key; typedef t_storage_value t_value;
+
+		template<typename _t_key,typename _t_value>
+		void set(const _t_key & p_key, const _t_value & p_value) {
+			bool isnew;
+			m_data.add_ex(p_key, isnew).m_value = p_value;
+		}
+
+		template<typename _t_key>
+		t_storage_value & find_or_add(_t_key const & p_key) {
+			bool isnew;
+			return m_data.add_ex(p_key, isnew).m_value;
+		}
+
+		template<typename _t_key>
+		t_storage_value & find_or_add_ex(_t_key const & p_key,bool & p_isnew) {
+			return m_data.add_ex(p_key, p_isnew).m_value;
+		}
+
+		template<typename _t_key>
+		bool have_item(const _t_key & p_key) const {
+			return m_data.find_ptr(p_key) != NULL;
+		}
+
+		template<typename key_t>
+		bool contains(key_t const& arg) const { return have_item(arg); }
+
+		template<typename _t_key,typename _t_value>
+		bool query(const _t_key & p_key,_t_value & p_value) const {
+			const t_storage * storage = m_data.find_ptr(p_key);
+			if (storage == NULL) return false;
+			p_value = storage->m_value;
+			return true;
+		}
+
+		template<typename _t_key>
+		const t_storage_value & operator[] (const _t_key & p_key) const {
+			const t_storage_value * ptr = query_ptr(p_key);
+			if (ptr == NULL) throw exception_map_entry_not_found();
+			return *ptr;
+		}
+
+		template<typename _t_key>
+		t_storage_value & operator[] (const _t_key & p_key) {
+			return find_or_add(p_key);
+		}
+
+		template<typename _t_key>
+		const t_storage_value * query_ptr(const _t_key & p_key) const {
+			const t_storage * storage = m_data.find_ptr(p_key);
+			if (storage == NULL) return NULL;
+			return &storage->m_value;
+		}
+
+		template<typename _t_key>
+		t_storage_value * query_ptr(const _t_key & p_key) {
+			t_storage * storage = m_data.find_ptr(p_key);
+			if (storage == NULL) return NULL;
+			return &storage->m_value;
+		}
+
+		// Like map_t::find: is_valid() tells whether the key was found, -> reaches m_key and m_value.
+		// Not an iterator in any other sense, only valid until the next insertion or removal.
+		template<typename t_entry> class find_result {
+		public:
+			find_result(t_entry * p_ptr = NULL) : m_ptr(p_ptr) {}
+			bool is_valid() const {return m_ptr != NULL;}
+			t_entry * operator->() const {PFC_ASSERT(is_valid()); return m_ptr;}
+			t_entry & operator*() const {PFC_ASSERT(is_valid()); return *m_ptr;}
+		private:
+			t_entry * m_ptr;
+		};
+
+		template<typename _t_key> find_result<const t_storage> find(const _t_key & p_key) const {return m_data.find_ptr(p_key);}
+		template<typename _t_key> find_result<t_storage> find(const _t_key & p_key) {return m_data.find_ptr(p_key);}
+
+		template<typename _t_key>
+		bool remove(const _t_key & p_key) {
+			return m_data.remove_item(p_key);
+		}
+
+		template<typename t_callback>
+		void enumerate(t_callback && p_callback) const {
+			enumeration_wrapper<t_callback> cb(p_callback);
+			m_data.enumerate(cb);
+		}
+
+		template<typename t_callback>
+		void enumerate(t_callback && p_callback) {
+			enumeration_wrapper_var<t_callback> cb(p_callback);
+			m_data._enumerate_var(cb);
+		}
+
+		t_size get_count() const throw() {return m_data.get_count();}
+		size_t size() const throw() { return get_count(); }
+
+		void remove_all() throw() {m_data.remove_all();}
+		void clear() throw() { remove_all(); }
+
+		void prealloc(t_size p_count) {m_data.prealloc(p_count);}
+
+		template<typename t_source>
+		void overwrite(const t_source & p_source) {
+			__map_overwrite_wrapper<t_self> wrapper(*this);
+			p_source.enumerate(wrapper);
+		}
+
+	private:
+		struct t_storage {
+			t_storage_key m_key;
+			t_storage_value m_value;
+
+			template<typename _t_key> t_storage(const _t_key & p_key) : m_key(p_key), m_value() {}
+			t_storage(const t_storage & p_source) : m_key(p_source.m_key), m_value(p_source.m_value) {}
+			t_storage(t_storage && p_source) : m_key(std::move(p_source.m_key)), m_value(std::move(p_source.m_value)) {}
+		};
+
+		template<typename t_callback>
+		class enumeration_wrapper {
+		public:
+			enumeration_wrapper(t_callback & p_callback) : m_callback(p_callback) {}
+			void operator()(const t_storage & p_item) {m_callback(p_item.m_key,p_item.m_value);}
+		private:
+			t_callback & m_callback;
+		};
+
+		template<typename t_callback>
+		class enumeration_wrapper_var {
+		public:
+			enumeration_wrapper_var(t_callback & p_callback) : m_callback(p_callback) {}
+			void operator()(t_storage & p_item) {m_callback(const_cast<const t_storage_key&>(p_item.m_key),p_item.m_value);}
+		private:
+			t_callback & m_callback;
+		};
+
+		_hash_table<t_storage, t_hasher> m_data;
+	};
+
+	template<typename t_storage_item, typename t_hasher = hasher_default>
+	class hash_set_t {
+	public:
+		typedef t_storage_item t_item;
+
+		template<typename t_param>
+		const t_item & add_item(const t_param & p_item) {
+			bool isnew;
+			return m_data.add_ex(p_item, isnew).m_key;
+		}
+
+		// true when the item was not there yet
+		template<typename t_param>
+		bool add_item_check(const t_param & p_item) {
+			bool isnew;
+			m_data.add_ex(p_item, isnew);
+			return isnew;
+		}
+
+		template<typename t_param>
+		bool have_item(const t_param & p_item) const {
+			return m_data.find_ptr(p_item) != NULL;
+		}
+
+		template<typename t_param>
+		bool contains(const t_param & p_item) const { return have_item(p_item); }
+
+		template<typename t_param>
+		const t_item * find_item_ptr(const t_param & p_item) const {
+			const t_storage * storage = m_data.find_ptr(p_item);
+			return storage != NULL ? &storage->m_key : NULL;
+		}
+
+		template<typename t_param>
+		bool remove_item(const t_param & p_item) {
+			return m_data.remove_item(p_item);
+		}
+
+		template<typename t_callback>
+		void enumerate(t_callback && p_callback) const {
+			enumeration_wrapper<t_callback> cb(p_callback);
+			m_data.enumerate(cb);
+		}
+
+		t_size get_count() const throw() {return m_data.get_count();}
+		size_t size() const throw() { return get_count(); }
+
+		void remove_all() throw() {m_data.remove_all();}
+		void clear() throw() { remove_all(); }
+
+		void prealloc(t_size p_count) {m_data.prealloc(p_count);}
+
+	private:
+		struct t_storage {
+			t_storage_item m_key;
+
+			template<typename t_param> t_storage(const t_param & p_item) : m_key(p_item) {}
+			t_storage(const t_storage & p_source) : m_key(p_source.m_key) {}
+			t_storage(t_storage && p_source) : m_key(std::move(p_source.m_key)) {}
+		};
+
+		template<typename t_callback>
+		class enumeration_wrapper {
+		public:
+			enumeration_wrapper(t_callback & p_callback) : m_callback(p_callback) {}
+			void operator()(const t_storage & p_item) {m_callback(p_item.m_key);}
+		private:
+			t_callback & m_callback;
+		};
+
+		_hash_table<t_storage, t_hasher> m_data;
+	};
+}
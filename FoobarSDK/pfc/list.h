@@ -518,22 +518,19 @@ public:
 
 	void sort()
 	{
-		::pfc::sort_callback_impl_auto_wrap_t<t_storage> wrapper(m_buffer);
-		::pfc::sort(wrapper,get_size());
+		::pfc::sort_inline_t(m_buffer,get_size(),[] (const T & item1,const T & item2) {return ::pfc::compare_t(item1,item2);});
 	}
 
 	template<typename t_compare>
 	void sort_t(t_compare p_compare)
 	{
-		::pfc::sort_callback_impl_simple_wrap_t<t_storage,t_compare> wrapper(m_buffer,p_compare);
-		::pfc::sort(wrapper,get_size());
+		::pfc::sort_inline_t(m_buffer,get_size(),p_compare);
 	}
 
 	template<typename t_compare>
 	void sort_stable_t(t_compare p_compare)
 	{
-		::pfc::sort_callback_impl_simple_wrap_t<t_storage,t_compare> wrapper(m_buffer,p_compare);
-		::pfc::sort_stable(wrapper,get_size());
+		::pfc::sort_stable_inline_t(m_buffer,get_size(),p_compare);
 	}
 	inline void reorder_partial(t_size p_base,const t_size * p_order,t_size p_count)
 	{
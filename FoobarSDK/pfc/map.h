@@ -12,10 +12,10 @@ namespace pfc {
 		t_destination & m_destination;
 	};
 
-	template<typename t_storage_key, typename t_storage_value, typename t_comparator = comparator_default>
+	template<typename t_storage_key, typename t_storage_value, typename t_comparator = comparator_default, typename t_alloc = avltree_alloc_default>
 	class map_t {
 	private:
-		typedef map_t<t_storage_key,t_storage_value,t_comparator> t_self;
+		typedef map_t<t_storage_key,t_storage_value,t_comparator,t_alloc> t_self;
 	public:
 		typedef t_storage_key t_key; typedef t_storage_value t_value;
 		template<typename _t_key,typename _t_value>
@@ -236,7 +236,7 @@ namespace pfc {
 			t_callback & m_callback;
 		};
 
-		typedef avltree_t<t_storage,comparator_wrapper> t_content;
+		typedef avltree_t<t_storage,comparator_wrapper,t_alloc> t_content;
 
 		t_content m_data;
 	public:
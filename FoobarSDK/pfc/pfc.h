@@ -20,6 +20,8 @@
 #include "ptr_list.h"
 #include "string-lite.h"
 #include "string_base.h"
+#include "string-sso.h"
+#include "string-arena.h"
 #include "splitString.h"
 #include "string_list.h"
 #include "lockless.h"
@@ -27,6 +29,7 @@
 #include "iterators.h"
 #include "avltree.h"
 #include "map.h"
+#include "hash_map.h"
 #include "bit_array_impl_part2.h"
 #include "timers.h"
 #include "guid.h"
@@ -65,6 +68,7 @@
 
 namespace pfc {
     void selftest();
+    void benchmark();
 }
 
 #ifndef PFC_SET_THREAD_DESCRIPTION
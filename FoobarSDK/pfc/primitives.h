@@ -2,6 +2,10 @@
 
 #include <functional>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "traits.h"
 #include "bit_array.h"
 
@@ -893,6 +897,24 @@ namespace pfc {
 		return (acc3 & 0xFFFF) + ((acc3 >> 16) & 0xFFFF);
 	}
 
+	//! Index of the lowest set bit, v must not be zero.
+	inline unsigned findLowestBit64(uint64_t v) {
+		PFC_ASSERT(v != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index; _BitScanForward64(&index, v); return (unsigned)index;
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (uint32_t)v)) return (unsigned)index;
+		_BitScanForward(&index, (uint32_t)(v >> 32)); return (unsigned)index + 32;
+#elif defined(__GNUC__)
+		return (unsigned)__builtin_ctzll(v);
+#else
+		unsigned index = 0;
+		while ((v & 1) == 0) { v >>= 1; ++index; }
+		return index;
+#endif
+	}
+
     // Forward declarations
     template<typename t_to,typename t_from>
 	void copy_array_t(t_to & p_to,const t_from & p_from);
@@ -964,7 +986,11 @@ namespace pfc {
 		return n;
 	}
 
-	inline t_size strlen_max(const char* ptr, t_size max) noexcept { return strlen_max_t(ptr, max); }
+	// the C library's strnlen scans a block at a time and knows how far it may read
+	inline t_size strlen_max(const char* ptr, t_size max) noexcept {
+		PFC_ASSERT(ptr != NULL || max == 0);
+		return max == 0 ? 0 : strnlen(ptr, max);
+	}
 	inline t_size wcslen_max(const wchar_t* ptr, t_size max) noexcept { return strlen_max_t(ptr, max); }
 
 #ifdef _WINDOWS
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "synchro.h"
+
+// Bounded lock-free queues over contiguous storage.
+// ringSPSC / ringMPSC are the raw rings: try_put() fails when full, try_get() fails when empty.
+// ringWaitQueue wraps either of them with the waitQueue interface - put / get / set_eof / abort-aware get -
+// where the event is reset only when the consumer finds the ring empty, and only the first put after that sets it.
+
+namespace pfc {
+
+	enum { ringQueueCacheLine = 64, ringQueueSpinCount = 4 };
+
+	inline size_t ringQueueCapacity( size_t requested ) {
+		size_t v = 2;
+		while ( v < requested ) v <<= 1;
+		return v;
+	}
+
+	// Single producer, single consumer.
+	template<typename obj_t>
+	class ringSPSC {
+	public:
+		ringSPSC( size_t capacity = 1024 ) : m_mask( ringQueueCapacity(capacity) - 1 ), m_items( new obj_t[m_mask + 1] ) {}
+
+		size_t capacity() const { return m_mask + 1; }
+
+		template<typename arg_t>
+		bool try_put( arg_t && obj ) {
+			const size_t tail = m_tail.load( std::memory_order_relaxed );
+			if ( tail - m_headCache > m_mask ) {
+				m_headCache = m_head.load( std::memory_order_acquire );
+				if ( tail - m_headCache > m_mask ) return false;
+			}
+			m_items[tail & m_mask] = std::forward<arg_t>(obj);
+			m_tail.store( tail + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool try_get( obj_t & out ) {
+			const size_t head = m_head.load( std::memory_order_relaxed );
+			if ( head == m_tailCache ) {
+				m_tailCache = m_tail.load( std::memory_order_acquire );
+				if ( head == m_tailCache ) return false;
+			}
+			obj_t & item = m_items[head & m_mask];
+			out = std::move( item );
+			item = obj_t();
+			m_head.store( head + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool is_empty() const {
+			return m_head.load( std::memory_order_acquire ) == m_tail.load( std::memory_order_acquire );
+		}
+	private:
+		const size_t m_mask;
+		std::unique_ptr<obj_t[]> m_items;
+
+		// consumer side
+		alignas(ringQueueCacheLine) std::atomic<size_t> m_head = {0};
+		size_t m_tailCache = 0;
+
+		// producer side
+		alignas(ringQueueCacheLine) std::atomic<size_t> m_tail = {0};
+		size_t m_headCache = 0;
+
+		ringSPSC( const ringSPSC & ) = delete;
+		void operator=( const ringSPSC & ) = delete;
+	};
+
+	// Multiple producers, single consumer.
+	// Each slot carries a sequence number telling whose turn it is, so producers only contend on the tail counter.
+	template<typename obj_t>
+	class ringMPSC {
+	public:
+		ringMPSC( size_t capacity = 1024 ) : m_mask( ringQueueCapacity(capacity) - 1 ), m_cells( new cell_t[m_mask + 1] ) {
+			for ( size_t walk = 0; walk <= m_mask; ++walk ) m_cells[walk].seq.store( walk, std::memory_order_relaxed );
+		}
+
+		size_t capacity() const { return m_mask + 1; }
+
+		template<typename arg_t>
+		bool try_put( arg_t && obj ) {
+			size_t pos = m_tail.load( std::memory_order_relaxed );
+			cell_t * cell;
+			for ( ;; ) {
+				cell = &m_cells[pos & m_mask];
+				const size_t seq = cell->seq.load( std::memory_order_acquire );
+				const ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) pos;
+				if ( diff == 0 ) {
+					if ( m_tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) break;
+				} else if ( diff < 0 ) {
+					return false;
+				} else {
+					pos = m_tail.load( std::memory_order_relaxed );
+				}
+			}
+			cell->value = std::forward<arg_t>(obj);
+			cell->seq.store( pos + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool try_get( obj_t & out ) {
+			const size_t head = m_head.load( std::memory_order_relaxed );
+			cell_t & cell = m_cells[head & m_mask];
+			const size_t seq = cell.seq.load( std::memory_order_acquire );
+			if ( (ptrdiff_t) seq - (ptrdiff_t) (head + 1) < 0 ) return false;
+			out = std::move( cell.value );
+			cell.value = obj_t();
+			cell.seq.store( head + m_mask + 1, std::memory_order_release );
+			m_head.store( head + 1, std::memory_order_relaxed );
+			return true;
+		}
+
+		bool is_empty() const {
+			const size_t head = m_head.load( std::memory_order_relaxed );
+			return (ptrdiff_t) m_cells[head & m_mask].seq.load( std::memory_order_acquire ) - (ptrdiff_t) (head + 1) < 0;
+		}
+	private:
+		struct alignas(ringQueueCacheLine) cell_t {
+			std::atomic<size_t> seq;
+			obj_t value;
+		};
+
+		const size_t m_mask;
+		std::unique_ptr<cell_t[]> m_cells;
+
+		alignas(ringQueueCacheLine) std::atomic<size_t> m_head = {0};
+		alignas(ringQueueCacheLine) std::atomic<size_t> m_tail = {0};
+
+		ringMPSC( const ringMPSC & ) = delete;
+		void operator=( const ringMPSC & ) = delete;
+	};
+
+	template<typename ring_t, typename obj_t>
+	class ringWaitQueue {
+	public:
+		ringWaitQueue( size_t capacity = 1024 ) : m_ring( capacity ) {}
+
+		// Blocks (yielding) while the ring is full.
+		template<typename arg_t>
+		void put( arg_t && obj ) {
+			while ( !m_ring.try_put( std::forward<arg_t>(obj) ) ) std::this_thread::yield();
+			wake();
+		}
+
+		template<typename arg_t>
+		bool try_put( arg_t && obj ) {
+			if ( !m_ring.try_put( std::forward<arg_t>(obj) ) ) return false;
+			wake();
+			return true;
+		}
+
+		void set_eof() {
+			m_eof.store( true, std::memory_order_seq_cst );
+			m_signaled.store( true, std::memory_order_relaxed );
+			m_canRead.set_state( true );
+		}
+		bool wait_read( double timeout ) {
+			if ( !m_ring.is_empty() || m_eof.load() ) return true;
+			return m_canRead.wait_for( timeout );
+		}
+		eventHandle_t get_event_handle() {
+			return m_canRead.get_handle();
+		}
+
+		bool get( obj_t & out ) {
+			for ( ;; ) {
+				int state = prepareWait( out );
+				if ( state >= 0 ) return state > 0;
+				m_canRead.wait_for( -1 );
+			}
+		}
+
+		bool get( obj_t & out, pfc::eventHandle_t hAbort, bool * didAbort = nullptr ) {
+			if (didAbort != nullptr) * didAbort = false;
+			for ( ;; ) {
+				int state = prepareWait( out );
+				if ( state >= 0 ) return state > 0;
+				int wait = pfc::event::g_twoEventWait( hAbort, m_canRead.get_handle(), -1 );
+				if ( wait == 1 ) {
+					if (didAbort != nullptr) * didAbort = true;
+					return false;
+				}
+			}
+		}
+
+		// Not safe against concurrent put() calls.
+		void clear() {
+			obj_t dummy;
+			while ( m_ring.try_get( dummy ) ) {}
+			m_eof = false;
+			m_signaled = false;
+			m_canRead.set_state( false );
+		}
+	private:
+		// The event is set while there is something to read, as with waitQueue: producers set it on the first put after
+		// the consumer reset it, the consumer resets it when it takes the last item. Resetting and putting both go through
+		// a fence and then look at the other side, so either the producer sees the reset or the consumer sees the item.
+		void wake() {
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			if ( !m_signaled.load( std::memory_order_relaxed ) ) signal();
+		}
+		void signal() {
+			// only the first producer after a reset pays for setting the event
+			if ( !m_signaled.exchange( true, std::memory_order_relaxed ) ) m_canRead.set_state( true );
+		}
+		// false if the ring turned out not to be empty or at eof meanwhile, the event is set again then
+		bool reset() {
+			m_canRead.set_state( false );
+			m_signaled.store( false, std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+			if ( m_ring.is_empty() && !m_eof.load() ) return true;
+			signal();
+			return false;
+		}
+		void didGet() {
+			if ( m_signaled.load( std::memory_order_relaxed ) && m_ring.is_empty() && !m_eof.load() ) reset();
+		}
+
+		// 1 = got an item, 0 = eof, -1 = empty, consumer should wait on m_canRead
+		int prepareWait( obj_t & out ) {
+			for ( ;; ) {
+				// give producers a chance to refill before paying for a sleep/wake cycle
+				for ( int spin = 0; ; ++spin ) {
+					if ( m_ring.try_get( out ) ) {
+						didGet();
+						return 1;
+					}
+					if ( m_eof.load() ) return m_ring.try_get( out ) ? 1 : 0;
+					if ( spin == ringQueueSpinCount ) break;
+					std::this_thread::yield();
+				}
+				if ( reset() ) return -1;
+			}
+		}
+
+		ring_t m_ring;
+		std::atomic<bool> m_eof = {false};
+		std::atomic<bool> m_signaled = {false};	// m_canRead is set, or about to be
+		event m_canRead;
+
+		ringWaitQueue( const ringWaitQueue & ) = delete;
+		void operator=( const ringWaitQueue & ) = delete;
+	};
+
+	template<typename obj_t> using waitQueueSPSC = ringWaitQueue< ringSPSC<obj_t>, obj_t >;
+	template<typename obj_t> using waitQueueMPSC = ringWaitQueue< ringMPSC<obj_t>, obj_t >;
+}
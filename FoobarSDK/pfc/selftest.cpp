@@ -2,6 +2,11 @@
 #include "pfc.h"
 #include "string-conv-lite.h"
 #include "SmartStrStr.h"
+#include "string-ascii.h"
+#include "ring_queue.h"
+#include "wait_queue.h"
+#include "avltree_pool.h"
+#include "benchmark-tags.h"
 
 namespace {
     class foo {};
@@ -90,7 +95,152 @@ namespace pfc {
 			PFC_ASSERT(map["2"] == 2);
 			PFC_ASSERT(map["3"] == 3);
 		}
+
+		{
+			// removal shifts colliding items back, check that everything stays reachable
+			pfc::hash_map_t<int, int> map;
+			for (int i = 0; i < 1000; ++i) map.set(i, i * 2);
+			for (int i = 0; i < 1000; i += 3) PFC_ASSERT_SUCCESS(map.remove(i));
+			PFC_ASSERT(map.get_count() == 1000 - 334);
+			for (int i = 0; i < 1000; ++i) {
+				PFC_ASSERT((i % 3 == 0) ? !map.have_item(i) : (map.have_item(i) && *map.query_ptr(i) == i * 2));
+			}
+			PFC_ASSERT(!map.find(3).is_valid());
+			PFC_ASSERT(map.find(4).is_valid() && map.find(4)->m_key == 4 && map.find(4)->m_value == 8);
+			map.find(4)->m_value = 5;
+			const auto & constMap = map;
+			PFC_ASSERT(constMap.find(4)->m_value == 5);
+			(void)constMap;
+
+			pfc::hash_set_t<pfc::string8, pfc::hasher_strcmp> set;
+			PFC_ASSERT(set.add_item_check("a") && !set.add_item_check("a"));
+			PFC_ASSERT(set.contains("a") && !set.contains("b"));
+			PFC_ASSERT(set.remove_item("a") && set.get_count() == 0);
+		}
+
+		{
+			// pooled nodes are recycled through the free list after removal
+			pfc::map_t<int, int, pfc::comparator_default, pfc::avltree_alloc_pool> map;
+			for (int i = 0; i < 1000; ++i) map.set((i * 7919) % 1000, i);
+			for (int i = 0; i < 1000; i += 2) PFC_ASSERT(map.remove(i));
+			for (int i = 0; i < 1000; i += 4) map.set(i, i);
+			PFC_ASSERT(map.get_count() == 750);
+			int prev = -1;
+			map.enumerate([&prev](int key, int) { PFC_ASSERT(key > prev); prev = key; });
+		}
+
+		{
+			// few distinct keys make runs of equal items; stable sort must keep them in insertion order
+			pfc::array_t<t_size> keys; keys.set_size(1000);
+			for (t_size i = 0; i < 1000; ++i) keys[i] = (i * 7919) % 13;
+			pfc::array_t<t_size> order; order.set_size(1000);
+			for (t_size i = 0; i < 1000; ++i) order[i] = i;
+			pfc::sort_stable_get_permutation_t(keys, pfc::compare_t<t_size, t_size>, 1000, order.get_ptr());
+			for (t_size i = 1; i < 1000; ++i) {
+				PFC_ASSERT(keys[order[i - 1]] < keys[order[i]] || (keys[order[i - 1]] == keys[order[i]] && order[i - 1] < order[i]));
+			}
+			pfc::sort_t(keys, pfc::compare_t<t_size, t_size>, 1000);
+			for (t_size i = 1; i < 1000; ++i) PFC_ASSERT(keys[i - 1] <= keys[i]);
+		}
+
+		{
+			const char text[] = "Live at the Royal Albert Hall (Remastered 2011) - Disc 2";
+			const size_t len = strlen(text);
+			PFC_ASSERT(pfc::asciiSpan(text, len) == len && pfc::asciiSpan("Bj\xC3\xB6rk", 6) == 2);
+			PFC_ASSERT(pfc::asciiFindI(text, len, "REMASTERED", 10) == 31);
+			PFC_ASSERT(pfc::asciiFindI(text, len, "disc 3", 6) == SIZE_MAX);
+			PFC_ASSERT(pfc::asciiCommonPrefixI(text, "LIVE AT THE ROYAL ALBERT HALL [Remastered 2011]", len) == 30);
+			PFC_ASSERT(pfc::stricmp_ascii_ex(text, ~0, "LIVE AT THE ROYAL ALBERT HALL (REMASTERED 2011) - DISC 2", ~0) == 0);
+			(void)len;
+
+			// lower case user chars match either case, upper case ones only themselves;
+			// ASCII runs are searched a block at a time, with the Unicode rules in between
+			PFC_ASSERT(SmartStrStr::global().testSubstring(text, "albert hall") && !SmartStrStr::global().testSubstring(text, "ALBERT"));
+			PFC_ASSERT(SmartStrStr::global().testSubstring("Sigur R\xC3\xB3s - Hopp\xC3\xADpolla", "hoppipolla"));
+			size_t at = 0;
+			PFC_ASSERT(SmartStrStr::global().strStrEnd("Mot\xC3\xB6rhead - Ace of Spades", "orhead - ace", &at) != nullptr && at == 3);
+			(void)at;
+		}
+
+		{
+			// short values stay inline, growth keeps the value, even when appending the string to itself
+			pfc::string8_sso s = "Ace of Spades";
+			PFC_ASSERT(s.is_inline() && strcmp(s, "Ace of Spades") == 0);
+			s.add_string(s.get_ptr()); s.add_string(s.get_ptr()); s.add_string(s.get_ptr());
+			PFC_ASSERT(!s.is_inline() && s.get_length() == 13 * 8 && strncmp(s.get_ptr() + 13 * 7, "Ace of Spades", 14) == 0);
+			s.set_string(s.get_ptr() + 7, 6);
+			PFC_ASSERT(strcmp(s, "Spades") == 0);
+			pfc::string8_sso moved(std::move(s));
+			PFC_ASSERT(strcmp(moved, "Spades") == 0 && s.is_empty() && s.is_inline());
+
+			// committed strings stay put while later ones outgrow the inline block
+			pfc::string_arena_t<64> arena;
+			pfc::array_t<const char*> committed;
+			for (int pass = 0; pass < 2; ++pass) {
+				committed.set_size(0);
+				for (int i = 0; i < 100; ++i) {
+					arena << "track " << i;
+					committed.append_single_val(arena.commit());
+				}
+				for (int i = 0; i < 100; ++i) PFC_ASSERT(strcmp(committed[i], pfc::format("track ", i)) == 0);
+				arena.rewind();
+			}
+			PFC_ASSERT(strcmp(arena.commit(), "") == 0);
+		}
+
+		{
+			pfc::waitQueueMPSC<int> q(4);
+			for (int i = 0; i < 4; ++i) PFC_ASSERT_SUCCESS(q.try_put(i));
+			PFC_ASSERT(!q.try_put(4));
+			int v, order = 0;
+			for (int i = 0; i < 4; ++i) {
+				PFC_ASSERT_SUCCESS(q.get(v));
+				order = order * 10 + v;
+			}
+			q.put(5); q.set_eof();
+			while (q.get(v)) order = order * 10 + v;
+			PFC_ASSERT(order == 1235);
+			(void)order;
+		}
+
+		{
+			// a put from another thread wakes a reader waiting in wait_read() or on the event handle,
+			// before any get() and after get() took the last item
+			pfc::waitQueueMPSC<int> q;
+			for (int round = 0; round < 2; ++round) {
+				PFC_ASSERT(!q.wait_read(0));
+				thread2 producer;
+				producer.startHere([&q, round] { pfc::event delay; delay.wait_for(0.05); q.put(round); });
+				hires_timer timer; timer.start();
+				const bool woken = (round == 0) ? q.wait_read(5) : pfc::event::g_wait_for(q.get_event_handle(), 5);
+				PFC_ASSERT(woken && timer.query() < 1);
+				int v = -1;
+				PFC_ASSERT_SUCCESS(q.get(v));
+				PFC_ASSERT(v == round);
+				(void)woken; (void)v;
+			}
+		}
 	}
+	static void selftest_bit_array() {
+		// word-at-a-time find() against get(), with bits on both sides of word boundaries
+		const size_t count = 200;
+		bit_array_bittable mask(count);
+		const size_t set[] = { 0, 3, 63, 64, 65, 127, 128, 190, 199 };
+		for (size_t i = 0; i < PFC_TABSIZE(set); ++i) mask.set(set[i], true);
+
+		for (int v = 0; v < 2; ++v) {
+			const bool val = v != 0;
+			for (size_t start = 0; start <= count; start += 7) {
+				for (size_t max = start; max <= count + 70; max += 13) {
+					size_t expected = start;
+					while (expected < max && mask.get(expected) != val) ++expected;
+					PFC_ASSERT(mask.find_first(val, start, max) == expected);
+				}
+			}
+		}
+		PFC_ASSERT(mask.calc_count(true, 0, count) == PFC_TABSIZE(set));
+	}
+
 	// Self test routines that fail at compile time if there's something seriously wrong
 	void selftest_static() {
 		PFC_STATIC_ASSERT(sizeof(t_uint8) == 1);
@@ -124,8 +274,429 @@ namespace pfc {
 	}
 
 	void selftest() {
-		selftest_static(); selftest_runtime();
+		selftest_static(); selftest_runtime(); selftest_bit_array();
 
 		debugLog out; out << "PFC selftest OK";
 	}
+
+	// results that would otherwise go unused end up here, so that the optimizer keeps the work being timed
+	static volatile size_t benchmark_sink;
+
+	// cmdThread-style traffic: producers post std::function commands, one consumer runs them
+	template<typename queue_t>
+	static double benchmark_commands(size_t producers, size_t count) {
+		queue_t queue;
+		size_t done = 0;
+		hires_timer timer; timer.start();
+		{
+			thread2 threads[4];
+			for (size_t i = 0; i < producers; ++i) {
+				threads[i].startHere([&queue, &done, count] {
+					for (size_t n = 0; n < count; ++n) queue.put(std::function<void()>([&done] { ++done; }));
+				});
+			}
+			std::function<void()> cmd;
+			for (size_t n = producers * count; n > 0 && queue.get(cmd); --n) cmd();
+		}
+		const double time = timer.query();
+		PFC_ASSERT(done == producers * count);
+		return time;
+	}
+	static void benchmark_wait_queue() {
+		const size_t runs[][2] = { { 1, 1000000 }, { 4, 500000 } };
+		for (size_t i = 0; i < PFC_TABSIZE(runs); ++i) {
+			const size_t producers = runs[i][0], count = runs[i][1];
+			const double list = benchmark_commands< waitQueue< std::function<void()> > >(producers, count);
+			const double ring = benchmark_commands< waitQueueMPSC< std::function<void()> > >(producers, count);
+			debugLog out; out << "wait queue, " << producers << " x " << count << " commands: waitQueue " << format_float(list, 0, 3) << " s, waitQueueMPSC " << format_float(ring, 0, 3) << " s";
+		}
+	}
+
+	static int benchmark_compare_u32(const t_uint32 & v1, const t_uint32 & v2) {return compare_t(v1, v2);}
+	static int benchmark_compare_string(const pfc::string8 & v1, const pfc::string8 & v2) {return strcmp(v1, v2);}
+
+	// sorts a copy of data four ways, seconds for each: pfc::sort() through sort_callback, inlined sort_t(),
+	// then the same for the stable sorts; all with a function pointer comparator
+	template<typename t_item>
+	static void benchmark_sort_run(const pfc::array_t<t_item> & data, int (*compare)(const t_item &, const t_item &), double (&times)[4]) {
+		typedef sort_callback_impl_simple_wrap_t<pfc::array_t<t_item>, int (*)(const t_item &, const t_item &)> callback_t;
+		const t_size count = data.get_size();
+		for (int way = 0; way < 4; ++way) {
+			pfc::array_t<t_item> work = data;
+			hires_timer timer; timer.start();
+			switch (way) {
+			case 0: { callback_t cb(work, compare); sort(cb, count); } break;
+			case 1: sort_t(work, compare, count); break;
+			case 2: { callback_t cb(work, compare); sort_stable(cb, count); } break;
+			case 3: sort_stable_t(work, compare, count); break;
+			}
+			times[way] = timer.query();
+			for (t_size i = 1; i < count; ++i) PFC_ASSERT(compare(work[i - 1], work[i]) <= 0);
+		}
+	}
+	static void benchmark_sort() {
+		const size_t counts[] = { 10000, 100000, 1000000 };
+		for (size_t c = 0; c < PFC_TABSIZE(counts); ++c) {
+			const size_t count = counts[c];
+			pfc::array_t<t_uint32> numbers; numbers.set_size(count);
+			pfc::array_t<pfc::string8> strings; strings.set_size(count <= 100000 ? count : 0);
+			t_uint32 seed = 1;
+			for (size_t i = 0; i < count; ++i) {
+				seed = seed * 1664525 + 1013904223;
+				numbers[i] = seed;
+				if (i < strings.get_size()) strings[i] = pfc::format_hex(seed >> 4);
+			}
+
+			double t[4];
+			benchmark_sort_run(numbers, benchmark_compare_u32, t);
+			{
+				debugLog out; out << "sort, " << count << " t_uint32: sort_callback " << format_float(t[0] * 1000, 0, 2) << " ms, sort_t " << format_float(t[1] * 1000, 0, 2) << " ms; stable: sort_callback " << format_float(t[2] * 1000, 0, 2) << " ms, sort_stable_t " << format_float(t[3] * 1000, 0, 2) << " ms";
+			}
+			if (strings.get_size() == 0) continue;
+			benchmark_sort_run(strings, benchmark_compare_string, t);
+			{
+				debugLog out; out << "sort, " << count << " pfc::string8: sort_callback " << format_float(t[0] * 1000, 0, 2) << " ms, sort_t " << format_float(t[1] * 1000, 0, 2) << " ms; stable: sort_callback " << format_float(t[2] * 1000, 0, 2) << " ms, sort_stable_t " << format_float(t[3] * 1000, 0, 2) << " ms";
+			}
+		}
+	}
+
+	static const void * benchmark_pointer_key(size_t i) {
+		return (const void *)(t_size)((t_uint64)i * 0x9E3779B97F4A7C15ull);
+	}
+
+	// map_t with count scattered pointer keys: the first build, a rebuild after tearing it down,
+	// each key looked up once in an order unrelated to insertion, then the teardown; seconds for each
+	template<typename map_t>
+	static void benchmark_avltree_map(size_t count, double (&times)[4]) {
+		t_size sum = 0;
+		hires_timer timer; timer.start();
+		{
+			map_t map;
+			for (size_t i = 0; i < count; ++i) map.set(benchmark_pointer_key(i), i);
+			times[0] = timer.query();
+		}
+		timer.start();
+		{
+			map_t map;
+			for (size_t i = 0; i < count; ++i) map.set(benchmark_pointer_key(i), i);
+			times[1] = timer.query_reset();
+			for (size_t i = 0; i < count; ++i) {
+				auto iter = map.find(benchmark_pointer_key((size_t)((t_uint64)i * 7919 % count)));
+				if (iter.is_valid()) sum += iter->m_value;
+			}
+			times[2] = timer.query_reset();
+		}
+		times[3] = timer.query();
+		PFC_ASSERT(sum == count * (count - 1) / 2);
+		benchmark_sink = benchmark_sink + sum;
+	}
+	static void benchmark_avltree() {
+		const size_t counts[] = { 100000, 1000000 };
+		for (size_t i = 0; i < PFC_TABSIZE(counts); ++i) {
+			double heap[4], pool[4];
+			benchmark_avltree_map< map_t<const void *, size_t> >(counts[i], heap);
+			benchmark_avltree_map< map_t<const void *, size_t, comparator_default, avltree_alloc_pool> >(counts[i], pool);
+			const double * const results[2] = { heap, pool };
+			for (size_t r = 0; r < 2; ++r) {
+				const double * t = results[r];
+				debugLog out; out << "map_t, " << counts[i] << " pointer keys, " << (r == 0 ? "default" : "avltree_alloc_pool") << ": build " << format_float(t[0] * 1000, 0, 1) << " ms, rebuild " << format_float(t[1] * 1000, 0, 1) << " ms, lookup " << format_float(t[2] * 1000, 0, 1) << " ms, teardown " << format_float(t[3] * 1000, 0, 1) << " ms";
+			}
+		}
+	}
+
+	// count scattered keys inserted one by one, then each looked up once with find()
+	template<typename map_t>
+	static void benchmark_map(size_t count, double & insert, double & find) {
+		map_t map;
+		t_uint32 sum = 0;
+		hires_timer timer; timer.start();
+		for (size_t i = 0; i < count; ++i) map.set((t_uint32)(i * 2654435761u), (t_uint32)i);
+		insert = timer.query_reset();
+		for (size_t i = 0; i < count; ++i) {
+			auto iter = map.find((t_uint32)(i * 2654435761u));
+			if (iter.is_valid()) sum += iter->m_value;
+		}
+		find = timer.query();
+		PFC_ASSERT(sum == (t_uint32)((t_uint64)count * (count - 1) / 2));
+		benchmark_sink = benchmark_sink + sum;
+	}
+	static void benchmark_maps() {
+		const size_t counts[] = { 10000, 100000, 1000000 };
+		for (size_t i = 0; i < PFC_TABSIZE(counts); ++i) {
+			double treeInsert, treeFind, hashInsert, hashFind;
+			benchmark_map< map_t<t_uint32, t_uint32> >(counts[i], treeInsert, treeFind);
+			benchmark_map< hash_map_t<t_uint32, t_uint32> >(counts[i], hashInsert, hashFind);
+			debugLog out; out << "map, " << counts[i] << " keys: insert map_t " << format_float(treeInsert * 1000, 0, 1) << " ms, hash_map_t " << format_float(hashInsert * 1000, 0, 1) << " ms; find map_t " << format_float(treeFind * 1000, 0, 1) << " ms, hash_map_t " << format_float(hashFind * 1000, 0, 1) << " ms";
+		}
+	}
+
+	// a 50k item playlist mask with 500 marked items, walked with the generic bit at a time find() and with bit_array_bittable's
+	static void benchmark_bit_array() {
+		const size_t count = 50000, marked = 500, runs = 1000;
+		bit_array_bittable mask(count);
+		for (size_t i = 0; i < count; i += count / marked) mask.set(i, true);
+
+		size_t found = 0;
+		hires_timer timer; timer.start();
+		for (size_t run = 0; run < runs; ++run) {
+			for (size_t i = mask.bit_array::find(true, 0, count); i < count; i = mask.bit_array::find(true, i + 1, count - i - 1)) ++found;
+		}
+		const double generic = timer.query_reset();
+		for (size_t run = 0; run < runs; ++run) {
+			PFC_FOR_EACH_INDEX(mask, i, count) ++found;
+		}
+		const double words = timer.query();
+		PFC_ASSERT(found == 2 * runs * marked);
+		benchmark_sink = benchmark_sink + found;
+
+		debugLog out; out << "bit_array_bittable, " << found / (2 * runs) << " of " << count << " bits set, per scan: bit at a time " << format_float(generic * 1000 / runs, 0, 3) << " ms, word at a time " << format_float(words * 1000 / runs, 0, 3) << " ms";
+	}
+
+	// The hash based metadb_handle_list_helper::dedupe / difference from the SDK against the pointer sorts they replaced,
+	// on pfc::list_t of pointers the way the helpers see handles. Items are drawn from count values, about 37% repeat.
+	static void benchmark_handle_sets() {
+		typedef pfc::list_t<const void *> items_t;
+		hash_set_t<const void *> scratch;
+		const size_t counts[] = { 10000, 100000 };
+		for (size_t c = 0; c < PFC_TABSIZE(counts); ++c) {
+			const size_t count = counts[c];
+			items_t items, remove;
+			t_uint32 seed = 1;
+			for (size_t i = 0; i < count + count / 2; ++i) {
+				seed = seed * 1664525 + 1013904223;
+				(i < count ? items : remove).add_item(benchmark_pointer_key((seed >> 8) % count));
+			}
+
+			double times[4];
+			t_size results[4];
+			hires_timer timer;
+			{
+				// sort a permutation, flag the later of equal neighbours
+				items_t work = items;
+				timer.start();
+				const t_size n = work.get_count();
+				order_helper order(n);
+				work.sort_get_permutation_t(compare_t<const void *, const void *>, order.get_ptr());
+				bit_array_bittable mask(n);
+				for (t_size k = 0; k + 1 < n; ++k) {
+					if (work[order[k]] == work[order[k + 1]]) mask.set(order[k + 1], true);
+				}
+				work.remove_mask(mask);
+				times[0] = timer.query();
+				results[0] = work.get_count();
+			}
+			{
+				// flag what is already in the scratch table
+				items_t work = items;
+				timer.start();
+				const t_size n = work.get_count();
+				scratch.remove_all(); scratch.prealloc(n);
+				bit_array_bittable mask(n);
+				for (t_size k = 0; k < n; ++k) {
+					if (!scratch.add_item_check(work[k])) mask.set(k, true);
+				}
+				work.remove_mask(mask);
+				times[1] = timer.query();
+				results[1] = work.get_count();
+			}
+			{
+				// sort both, then walk them side by side
+				items_t work = items, other = remove, out;
+				timer.start();
+				work.sort_t(compare_t<const void *, const void *>);
+				other.sort_t(compare_t<const void *, const void *>);
+				for (t_size k = 0, o = 0; k < work.get_count(); ++k) {
+					while (o < other.get_count() && compare_t(other[o], work[k]) < 0) ++o;
+					if (o == other.get_count() || other[o] != work[k]) out.add_item(work[k]);
+				}
+				times[2] = timer.query();
+				results[2] = out.get_count();
+			}
+			{
+				// hash the items to remove, flag the hits
+				items_t work = items;
+				timer.start();
+				scratch.remove_all(); scratch.prealloc(remove.get_count());
+				for (t_size k = 0; k < remove.get_count(); ++k) scratch.add_item(remove[k]);
+				bit_array_bittable mask(work.get_count());
+				for (t_size k = 0; k < work.get_count(); ++k) {
+					if (scratch.have_item(work[k])) mask.set(k, true);
+				}
+				work.remove_mask(mask);
+				times[3] = timer.query();
+				results[3] = work.get_count();
+			}
+			PFC_ASSERT(results[0] == results[1] && results[2] == results[3]);
+			benchmark_sink = benchmark_sink + results[0] + results[2];
+
+			debugLog out; out << "handle list, " << count << " items: dedupe sorted " << format_float(times[0] * 1000, 0, 2) << " ms, hashed " << format_float(times[1] * 1000, 0, 2) << " ms; difference with " << remove.get_count() << " items sorted " << format_float(times[2] * 1000, 0, 2) << " ms, hashed " << format_float(times[3] * 1000, 0, 2) << " ms";
+		}
+	}
+
+	// SmartStrStr searches and stricmp_ascii_ex over the tag corpus, once on the SIMD kernels and once on their plain loops
+	static void benchmark_ascii() {
+		const size_t count = PFC_TABSIZE(benchmarkTags), runs = 500;
+		const char * const queries[] = { "lo", "remaster", "zzz", "a" };
+		SmartStrStr & sss = SmartStrStr::global();
+		size_t hits = 0;
+
+		for (size_t q = 0; q < PFC_TABSIZE(queries); ++q) {
+			double substring[2], strStr[2];
+			for (int scalar = 0; scalar < 2; ++scalar) {
+				asciiScalarOnly(scalar != 0);
+				hires_timer timer; timer.start();
+				for (size_t run = 0; run < runs; ++run) {
+					for (size_t i = 0; i < count; ++i) hits += sss.testSubstring(benchmarkTags[i], queries[q]) ? 1 : 0;
+				}
+				substring[scalar] = timer.query_reset();
+				for (size_t run = 0; run < runs; ++run) {
+					for (size_t i = 0; i < count; ++i) hits += sss.strStrEnd(benchmarkTags[i], queries[q]) != nullptr ? 1 : 0;
+				}
+				strStr[scalar] = timer.query();
+			}
+			asciiScalarOnly(false);
+			debugLog out; out << "SmartStrStr \"" << queries[q] << "\", " << count << " tags x " << runs << ": testSubstring SIMD " << format_float(substring[0] * 1000, 0, 1) << " ms, plain " << format_float(substring[1] * 1000, 0, 1) << " ms; strStrEnd SIMD " << format_float(strStr[0] * 1000, 0, 1) << " ms, plain " << format_float(strStr[1] * 1000, 0, 1) << " ms";
+		}
+
+		// every tag against its upper case spelling, equal all the way
+		pfc::array_t<pfc::string8> upper; upper.set_size(count);
+		for (size_t i = 0; i < count; ++i) {
+			for (const char * walk = benchmarkTags[i]; *walk; ++walk) {
+				const char c = ascii_toupper(*walk);
+				upper[i].add_string(&c, 1);
+			}
+		}
+		double compare[2];
+		for (int scalar = 0; scalar < 2; ++scalar) {
+			asciiScalarOnly(scalar != 0);
+			hires_timer timer; timer.start();
+			for (size_t run = 0; run < runs; ++run) {
+				for (size_t i = 0; i < count; ++i) hits += stricmp_ascii_ex(benchmarkTags[i], SIZE_MAX, upper[i], SIZE_MAX) == 0 ? 1 : 0;
+			}
+			compare[scalar] = timer.query();
+		}
+		asciiScalarOnly(false);
+		debugLog out; out << "stricmp_ascii_ex, " << count << " tags x " << runs << " against their upper case: SIMD " << format_float(compare[0] * 1000, 0, 1) << " ms, plain " << format_float(compare[1] * 1000, 0, 1) << " ms";
+
+		benchmark_sink = benchmark_sink + hits;
+	}
+
+	// A tag value written in two pieces, the way titleformat output arrives. Counts the times the string's buffer moved,
+	// which is every heap allocation of string8_fastalloc and string8_sso.
+	template<typename t_string> static void benchmark_write_field(t_string & out, const char * value, size_t & allocs) {
+		const size_t half = strlen(value) / 2;
+		const char * before = out.get_ptr();
+		out.add_string(value, half);
+		if (out.get_ptr() != before) { ++allocs; before = out.get_ptr(); }
+		out.add_string(value + half);
+		if (out.get_ptr() != before) ++allocs;
+	}
+
+	// An arena's strings follow each other within a block; one that does not start where the last ended is in a new block.
+	// newest is where the arena goes back to on rewind() once it has a block of its own.
+	static const char * benchmark_commit_field(string_arena & arena, const char * value, const char * & next, const char * & newest, size_t & allocs) {
+		const size_t half = strlen(value) / 2;
+		arena.add_string(value, half);
+		arena.add_string(value + half);
+		const char * ret = arena.commit();
+		if (*ret != 0) {
+			if (ret != next) { ++allocs; newest = ret; }
+			next = ret + strlen(value) + 1;
+		}
+		return ret;
+	}
+
+	// The tag fields Track::ReadInfo and Track::SetDynamic format per track: a new string8_fastalloc for every field as before,
+	// string8_sso, a string_arena_t<512> per track and one arena rewound per track.
+	static void benchmark_strings() {
+		const char * const genres[] = { "Rock", "Progressive Rock", "Jazz", "Electronic", "Classical", "" };
+		const char * const ratings[] = { "", "3", "", "5" };
+		const size_t count = PFC_TABSIZE(benchmarkTags) / 3, runs = 1000, tracks = count * runs;
+		size_t bytes = 0;
+
+		double times[6];
+		size_t allocs[6] = {};
+		string_arena_t<512> rewound;
+		const char * rewoundStart = rewound.lock_buffer(0); rewound.unlock_buffer();
+		const char * rewoundNewest = NULL;
+		for (int method = 0; method < 6; ++method) {
+			string8_sso live;
+			hires_timer timer; timer.start();
+			for (size_t run = 0; run < runs; ++run) {
+				for (size_t i = 0; i < count; ++i) {
+					// title, album artist, artist, album, genre, composer, rating
+					const char * const fields[7] = { benchmarkTags[i * 3 + 2], benchmarkTags[i * 3], benchmarkTags[i * 3], benchmarkTags[i * 3 + 1],
+						genres[i % PFC_TABSIZE(genres)], benchmarkTags[(i * 7 % count) * 3], ratings[i % PFC_TABSIZE(ratings)] };
+					switch (method) {
+					case 0:
+					case 1:
+						// the title is copied once more for the trigram index
+						for (size_t f = 0; f < 7; ++f) {
+							if (method == 0) {
+								string8_fastalloc value; benchmark_write_field(value, fields[f], allocs[method]);
+								bytes += value.get_length();
+								if (f == 0) { string8_fastalloc title(value); bytes += title.get_length(); if (title.get_length() > 0) ++allocs[method]; }
+							} else {
+								string8_sso value; benchmark_write_field(value, fields[f], allocs[method]);
+								bytes += value.get_length();
+								if (f == 0) { string8_sso title(value); bytes += title.get_length(); if (!title.is_inline()) ++allocs[method]; }
+							}
+						}
+						break;
+					case 2:
+					case 3:
+						{
+							string_arena_t<512> local;
+							string_arena & arena = (method == 2) ? (string_arena&) local : (string_arena&) rewound;
+							const char * next, * newest;
+							if (method == 2) {
+								next = local.lock_buffer(0); local.unlock_buffer(); newest = NULL;
+							} else {
+								rewound.rewind();
+								next = (rewoundNewest != NULL) ? rewoundNewest : rewoundStart; newest = rewoundNewest;
+							}
+							for (size_t f = 0; f < 7; ++f) bytes += strlen(benchmark_commit_field(arena, fields[f], next, newest, allocs[method]));
+							if (method == 3) rewoundNewest = newest;
+						}
+						break;
+					case 4:
+						for (size_t f = 0; f < 6; ++f) {
+							string8_fastalloc value; benchmark_write_field(value, fields[f], allocs[method]);
+							bytes += value.get_length();
+						}
+						break;
+					case 5:
+						for (size_t f = 0; f < 6; ++f) {
+							live.reset(); benchmark_write_field(live, fields[f], allocs[method]);
+							bytes += live.get_length();
+						}
+						break;
+					}
+				}
+			}
+			times[method] = timer.query();
+		}
+
+		const char * const names[] = { "ReadInfo, 7 fields + title copy: string8_fastalloc", "string8_sso", "string_arena_t<512>", "one arena, rewound",
+			"SetDynamic, 6 fields: string8_fastalloc", "one string8_sso" };
+		debugLog out; out << "tag strings, " << tracks << " tracks:";
+		for (int method = 0; method < 6; ++method) {
+			out << (method == 4 ? "; " : (method == 0 ? " " : ", ")) << names[method] << " " << format_float(times[method] * 1000, 0, 1) << " ms, "
+				<< format_float((double)allocs[method] / tracks, 0, 2) << " allocs/track";
+		}
+		benchmark_sink = benchmark_sink + bytes;
+	}
+
+	// Times hot pfc paths against the plain way of doing the same, results go to outputDebugLine.
+	// Not part of selftest(), takes a few seconds.
+	void benchmark() {
+		benchmark_wait_queue();
+		benchmark_bit_array();
+		benchmark_sort();
+		benchmark_avltree();
+		benchmark_maps();
+		benchmark_handle_sets();
+		benchmark_ascii();
+		benchmark_strings();
+	}
 }
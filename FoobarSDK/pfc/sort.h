@@ -1,6 +1,7 @@
 #pragma once
 
 #include "array.h"
+#include "sort_inline.h"
 
 namespace pfc {
 
@@ -163,32 +164,31 @@ namespace pfc {
 		t_permutation const & m_permutation;
 	};
 
+	// The templated helpers below know the container and comparator types, so they use the inlined sort from sort_inline.h.
+	// sort() / sort_stable() with a sort_callback remain for callers that only have the virtual interface.
+
 	template<typename t_container,typename t_compare>
 	static void sort_t(t_container & p_data,t_compare p_compare,t_size p_count)
 	{
-        sort_callback_impl_simple_wrap_t<t_container,t_compare> cb(p_data,p_compare);
-		sort(cb,p_count);
+		sort_inline_t(p_data,p_count,p_compare);
 	}
 
 	template<typename t_container,typename t_compare>
 	static void sort_stable_t(t_container & p_data,t_compare p_compare,t_size p_count)
 	{
-        sort_callback_impl_simple_wrap_t<t_container,t_compare> cb(p_data,p_compare);
-		sort_stable(cb,p_count);
+		sort_stable_inline_t(p_data,p_count,p_compare);
 	}
 
 	template<typename t_container,typename t_compare,typename t_permutation>
 	static void sort_get_permutation_t(const t_container & p_data,t_compare p_compare,t_size p_count,t_permutation const & p_permutation)
 	{
-        sort_callback_impl_permutation_wrap_t<t_container,t_compare,t_permutation> cb(p_data,p_compare,p_permutation);
-		sort(cb,p_count);
+		sort_inline_t(p_permutation,p_count,_sort_inline_permutation_compare<t_container,t_compare>(p_data,p_compare));
 	}
 
 	template<typename t_container,typename t_compare,typename t_permutation>
 	static void sort_stable_get_permutation_t(const t_container & p_data,t_compare p_compare,t_size p_count,t_permutation const & p_permutation)
 	{
-        sort_callback_impl_permutation_wrap_t<t_container,t_compare,t_permutation> cb(p_data,p_compare,p_permutation);
-		sort_stable(cb,p_count);
+		sort_stable_inline_t(p_permutation,p_count,_sort_inline_permutation_compare<t_container,t_compare>(p_data,p_compare));
 	}
 
 }
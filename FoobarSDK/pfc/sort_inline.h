@@ -0,0 +1,172 @@
+#pragma once
+
+#include <utility>
+
+// Sorting with the comparator known at compile time.
+// pfc::sort() goes through sort_callback, paying two virtual calls per compare or swap, and can't be inlined.
+// These work on anything indexable that returns references (pointers, array_t, std::vector, ...)
+// and take the usual pfc comparator returning <0, 0, >0.
+
+namespace pfc {
+
+	template<typename t_array, typename t_compare>
+	class _sort_inline {
+	public:
+		typedef typename std::remove_reference<decltype(std::declval<t_array&>()[0])>::type t_item;
+
+		_sort_inline(t_array & p_data, t_compare & p_compare) : m_data(p_data), m_compare(p_compare) {}
+
+		// Introsort: quicksort with median of three pivot, heapsort once recursion gets too deep, insertion sort for short ranges.
+		void sort(t_size p_base, t_size p_count) {
+			unsigned depth = 0;
+			for (t_size walk = p_count; walk > 1; walk >>= 1) depth += 2;
+			introsort(p_base, p_count, depth);
+		}
+
+		// Merge sort; equal items keep their order.
+		void sort_stable(t_size p_base, t_size p_count) {
+			if (p_count <= insertion_threshold) {
+				insertion_sort(p_base, p_count);
+				return;
+			}
+			array_staticsize_t<t_item> buffer(p_count / 2);
+			merge_sort(p_base, p_count, buffer.get_ptr());
+		}
+
+		// Merges two adjacent sorted runs in place, buffer must hold at least p_count1 items.
+		void merge(t_size p_base, t_size p_count1, t_size p_count2, t_item * p_buffer) {
+			const t_size mid = p_base + p_count1, end = mid + p_count2;
+			if (p_count1 == 0 || p_count2 == 0 || !less(mid, mid - 1)) return;
+
+			for (t_size walk = 0; walk < p_count1; ++walk) p_buffer[walk] = std::move(m_data[p_base + walk]);
+
+			t_size left = 0, right = mid, out = p_base;
+			while (left < p_count1 && right < end) {
+				if (m_compare(m_data[right], p_buffer[left]) < 0) m_data[out++] = std::move(m_data[right++]);
+				else m_data[out++] = std::move(p_buffer[left++]);
+			}
+			while (left < p_count1) m_data[out++] = std::move(p_buffer[left++]);
+		}
+
+	private:
+		enum { insertion_threshold = 16 };
+
+		bool less(t_size p_index1, t_size p_index2) {return m_compare(m_data[p_index1], m_data[p_index2]) < 0;}
+		void swap(t_size p_index1, t_size p_index2) {swap_t(m_data[p_index1], m_data[p_index2]);}
+		void swap_check(t_size p_index1, t_size p_index2) {if (less(p_index2, p_index1)) swap(p_index1, p_index2);}
+
+		void introsort(t_size p_base, t_size p_count, unsigned p_depth) {
+			while (p_count > insertion_threshold) {
+				if (p_depth == 0) {
+					heap_sort(p_base, p_count);
+					return;
+				}
+				--p_depth;
+
+				const t_size pivot = partition(p_base, p_count);
+				const t_size count1 = pivot - p_base, count2 = p_count - count1 - 1;
+				// recurse into the smaller half, loop on the bigger one; keeps the stack at O(log n)
+				if (count1 < count2) {
+					introsort(p_base, count1, p_depth);
+					p_base = pivot + 1; p_count = count2;
+				} else {
+					introsort(pivot + 1, count2, p_depth);
+					p_count = count1;
+				}
+			}
+			insertion_sort(p_base, p_count);
+		}
+
+		t_size partition(t_size p_base, t_size p_count) {
+			const t_size end = p_base + p_count;
+			{
+				// median of first, middle and last goes to p_base and serves as the pivot
+				const t_size first = p_base, middle = p_base + p_count / 2, last = end - 1;
+				swap_check(first, middle);
+				swap_check(middle, last);
+				swap_check(first, middle);
+				swap(first, middle);
+			}
+
+			// both scans stop on items equal to the pivot, so runs of equal items split evenly
+			t_size left = p_base, right = end;
+			for (;;) {
+				do ++left; while (left < end && less(left, p_base));
+				do --right; while (less(p_base, right));
+				if (left >= right) break;
+				swap(left, right);
+			}
+			if (right != p_base) swap(p_base, right);
+			return right;
+		}
+
+		void insertion_sort(t_size p_base, t_size p_count) {
+			const t_size end = p_base + p_count;
+			for (t_size walk = p_base + 1; walk < end; ++walk) {
+				if (!less(walk, walk - 1)) continue;
+				t_item temp(std::move(m_data[walk]));
+				t_size dest = walk;
+				do {
+					m_data[dest] = std::move(m_data[dest - 1]);
+					--dest;
+				} while (dest > p_base && m_compare(temp, m_data[dest - 1]) < 0);
+				m_data[dest] = std::move(temp);
+			}
+		}
+
+		void heap_sort(t_size p_base, t_size p_count) {
+			for (t_size walk = p_count / 2; walk > 0; --walk) sift_down(p_base, walk - 1, p_count);
+			for (t_size walk = p_count - 1; walk > 0; --walk) {
+				swap(p_base, p_base + walk);
+				sift_down(p_base, 0, walk);
+			}
+		}
+
+		void sift_down(t_size p_base, t_size p_root, t_size p_count) {
+			for (;;) {
+				t_size child = p_root * 2 + 1;
+				if (child >= p_count) break;
+				if (child + 1 < p_count && less(p_base + child, p_base + child + 1)) ++child;
+				if (!less(p_base + p_root, p_base + child)) break;
+				swap(p_base + p_root, p_base + child);
+				p_root = child;
+			}
+		}
+
+		void merge_sort(t_size p_base, t_size p_count, t_item * p_buffer) {
+			if (p_count <= insertion_threshold) {
+				insertion_sort(p_base, p_count);
+				return;
+			}
+			const t_size half = p_count / 2;
+			merge_sort(p_base, half, p_buffer);
+			merge_sort(p_base + half, p_count - half, p_buffer);
+			merge(p_base, half, p_count - half, p_buffer);
+		}
+
+		t_array & m_data;
+		t_compare & m_compare;
+	};
+
+	//! Sorts p_data[0] ... p_data[p_count-1]. Not stable. O(n log n) worst case.
+	template<typename t_array, typename t_compare>
+	inline void sort_inline_t(t_array && p_data, t_size p_count, t_compare p_compare) {
+		_sort_inline<typename std::remove_reference<t_array>::type, t_compare>(p_data, p_compare).sort(0, p_count);
+	}
+
+	//! Sorts p_data[0] ... p_data[p_count-1] keeping equal items in their original order. Needs a buffer of p_count/2 items.
+	template<typename t_array, typename t_compare>
+	inline void sort_stable_inline_t(t_array && p_data, t_size p_count, t_compare p_compare) {
+		_sort_inline<typename std::remove_reference<t_array>::type, t_compare>(p_data, p_compare).sort_stable(0, p_count);
+	}
+
+	template<typename t_container, typename t_compare>
+	class _sort_inline_permutation_compare {
+	public:
+		_sort_inline_permutation_compare(const t_container & p_data, t_compare & p_compare) : m_data(p_data), m_compare(p_compare) {}
+		int operator()(t_size p_index1, t_size p_index2) const {return m_compare(m_data[p_index1], m_data[p_index2]);}
+	private:
+		const t_container & m_data;
+		t_compare & m_compare;
+	};
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "string-interface.h"
+#include "alloc.h"
+
+namespace pfc {
+
+	//! Builds many short strings one after another in shared blocks of memory, for loops formatting a batch of values. \n
+	//! The string_base methods act on the current string; commit() ends it and returns a pointer that stays valid
+	//! until rewind() or destruction, the next string starts empty. rewind() drops every string but keeps the largest block,
+	//! a loop rewinding once per item stops allocating after the first few. \n
+	//! Use string_arena_t<> to start with a block inside the object; functions taking string_arena & accept any of them.
+	class string_arena : public string_base {
+	public:
+		~string_arena() { release(m_blocks); }
+
+		const char * get_ptr() const { return m_length > 0 ? m_block + m_start : ""; }
+		operator const char * () const { return get_ptr(); }
+		t_size get_length() const { return m_length; }
+
+		void add_string(const char * p_string, t_size p_length = SIZE_MAX) {
+			p_length = strlen_max(p_string, p_length);
+			if (p_length == 0) return;
+			if (m_length + p_length < m_length) throw exception_overflow();
+			// blocks are never moved, p_string stays valid if it points into the current string
+			make_room(m_length + p_length);
+			memcpy(m_block + m_start + m_length, p_string, p_length);
+			m_length += p_length;
+			m_block[m_start + m_length] = 0;
+		}
+		void set_string(const char * p_string, t_size p_length = SIZE_MAX) {
+			p_length = strlen_max(p_string, p_length);
+			m_length = 0;
+			if (p_length == 0) return;
+			make_room(p_length);
+			memmove(m_block + m_start, p_string, p_length);
+			m_length = p_length;
+			m_block[m_start + m_length] = 0;
+		}
+		void truncate(t_size p_length) {
+			if (p_length < m_length) {
+				m_length = p_length;
+				if (p_length > 0) m_block[m_start + p_length] = 0;
+			}
+		}
+		char * lock_buffer(t_size p_requested_length) {
+			make_room(p_requested_length);
+			memset(m_block + m_start, 0, p_requested_length + 1);
+			return m_block + m_start;
+		}
+		void unlock_buffer() {
+			m_length = strlen(m_block + m_start);
+		}
+
+		//! Ends the current string and returns it.
+		const char * commit() {
+			if (m_length == 0) return "";
+			const char * ret = m_block + m_start;
+			m_start += m_length + 1;
+			m_length = 0;
+			return ret;
+		}
+
+		//! Drops every string, committed or not, the memory is reused by the next ones.
+		void rewind() {
+			if (m_blocks != NULL) {
+				// the newest block is the largest
+				release(m_blocks->m_next);
+				m_blocks->m_next = NULL;
+				m_block = m_blocks->data(); m_blockSize = m_blocks->m_size;
+			}
+			m_start = 0; m_length = 0;
+		}
+
+	protected:
+		string_arena(char * p_inline, t_size p_inlineSize) : m_block(p_inline), m_blockSize(p_inlineSize), m_start(0), m_length(0), m_blocks(NULL) {}
+
+	private:
+		string_arena(const string_arena &) = delete;
+		void operator=(const string_arena &) = delete;
+
+		struct block_t {
+			block_t * m_next;
+			t_size m_size;
+			char * data() { return reinterpret_cast<char*>(this + 1); }
+		};
+
+		static void release(block_t * p_blocks) {
+			while (p_blocks != NULL) {
+				block_t * next = p_blocks->m_next;
+				raw_free(p_blocks);
+				p_blocks = next;
+			}
+		}
+
+		// room for a current string of p_length chars and its null; a new block takes over the current string
+		void make_room(t_size p_length) {
+			if (p_length < m_blockSize - m_start) return;
+			if (p_length + 1 == 0) throw exception_overflow();
+
+			t_size size = m_blockSize * 2;
+			if (size < 1024) size = 1024;
+			if (size < p_length + 1) size = p_length + 1;
+
+			block_t * block = (block_t*) raw_malloc(sizeof(block_t) + size);
+			block->m_next = m_blocks; block->m_size = size;
+			memcpy(block->data(), m_block + m_start, m_length);
+			m_blocks = block;
+			m_block = block->data(); m_blockSize = size; m_start = 0;
+		}
+
+		char * m_block;			// the block the current string is built in
+		t_size m_blockSize;
+		t_size m_start;			// of the current string in m_block
+		t_size m_length;		// of the current string
+		block_t * m_blocks;		// heap blocks, newest first
+	};
+
+	//! string_arena whose first block, inline_size bytes, is part of the object; as a local variable it makes
+	//! a batch of short strings fit on the stack.
+	template<t_size inline_size>
+	class string_arena_t : public string_arena {
+	public:
+		string_arena_t() : string_arena(m_inline, inline_size) {}
+	private:
+		char m_inline[inline_size];
+	};
+}
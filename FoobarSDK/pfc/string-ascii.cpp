@@ -0,0 +1,262 @@
+#include "pfc-lite.h"
+#include "string-ascii.h"
+#include "string_base.h"
+#include "primitives.h"
+
+
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(_M_X64) && !defined(_M_ARM64EC)) || defined(__x86_64__) || defined(__SSE2__)
+#define STRING_ASCII_SSE
+#include <emmintrin.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#define haveAVX2 true
+#define allowAVX2 1
+#elif PFC_HAVE_CPUID
+#include <immintrin.h>
+#include "cpuid.h"
+static const bool haveAVX2 = pfc::query_cpu_feature_set(pfc::CPU_HAVE_AVX2);
+#define allowAVX2 1
+#else
+#define haveAVX2 false
+#define allowAVX2 0
+#endif
+
+#endif
+
+#if defined( __aarch64__ ) || defined( _M_ARM64) || defined( _M_ARM64EC )
+#define STRING_ASCII_NEON
+#include <arm_neon.h>
+#endif
+
+
+inline static size_t noopt_asciiSpan(const char * p, size_t len) {
+    for (size_t walk = 0; walk < len; ++walk) {
+        if ((unsigned char)p[walk] >= 0x80) return walk;
+    }
+    return len;
+}
+
+inline static size_t noopt_asciiCommonPrefixI(const char * p1, const char * p2, size_t len) {
+    for (size_t walk = 0; walk < len; ++walk) {
+        const char c1 = p1[walk];
+        if (c1 == 0 || pfc::ascii_tolower(c1) != pfc::ascii_tolower(p2[walk])) return walk;
+    }
+    return len;
+}
+
+inline static bool noopt_equalsI(const char * p1, const char * p2, size_t len) {
+    for (size_t walk = 0; walk < len; ++walk) {
+        if (pfc::ascii_tolower(p1[walk]) != pfc::ascii_tolower(p2[walk])) return false;
+    }
+    return true;
+}
+
+inline static size_t noopt_asciiFindI(const char * p, size_t len, const char * sub, size_t subLen) {
+    if (subLen > len) return SIZE_MAX;
+    const char first = pfc::ascii_tolower(sub[0]);
+    for (size_t walk = 0; walk + subLen <= len; ++walk) {
+        if (pfc::ascii_tolower(p[walk]) == first && noopt_equalsI(p + walk + 1, sub + 1, subLen - 1)) return walk;
+    }
+    return SIZE_MAX;
+}
+
+// Search kernels below compare the first and the last char of sub against a whole block of positions at once
+// and only look at the chars in between where both match. Sub is at least one and at most len chars long.
+
+#if defined(STRING_ASCII_SSE)
+inline static __m128i sse2_tolower(__m128i v) {
+    // signed compares, bytes from 0x80 up are negative and stay as they are
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+inline static size_t sse2_asciiSpan(const char * p, size_t len) {
+    size_t walk = 0;
+    for (; walk + 16 <= len; walk += 16) {
+        const unsigned mask = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(p + walk)));
+        if (mask != 0) return walk + pfc::findLowestBit64(mask);
+    }
+    return walk + noopt_asciiSpan(p + walk, len - walk);
+}
+
+inline static size_t sse2_asciiCommonPrefixI(const char * p1, const char * p2, size_t len) {
+    size_t walk = 0;
+    for (; walk + 16 <= len; walk += 16) {
+        const __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + walk));
+        const __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + walk));
+        const __m128i same = _mm_cmpeq_epi8(sse2_tolower(v1), sse2_tolower(v2));
+        const __m128i null = _mm_cmpeq_epi8(v1, _mm_setzero_si128());
+        const unsigned stop = (unsigned)_mm_movemask_epi8(_mm_andnot_si128(null, same)) ^ 0xFFFF;
+        if (stop != 0) return walk + pfc::findLowestBit64(stop);
+    }
+    return walk + noopt_asciiCommonPrefixI(p1 + walk, p2 + walk, len - walk);
+}
+
+inline static size_t sse2_asciiFindI(const char * p, size_t len, const char * sub, size_t subLen) {
+    const __m128i first = _mm_set1_epi8(pfc::ascii_tolower(sub[0]));
+    const __m128i last = _mm_set1_epi8(pfc::ascii_tolower(sub[subLen - 1]));
+    const size_t positions = len - subLen + 1;
+    size_t walk = 0;
+    for (; walk + 16 <= positions; walk += 16) {
+        const __m128i v1 = sse2_tolower(_mm_loadu_si128((const __m128i*)(p + walk)));
+        const __m128i v2 = sse2_tolower(_mm_loadu_si128((const __m128i*)(p + walk + subLen - 1)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v1, first), _mm_cmpeq_epi8(v2, last)));
+        for (; mask != 0; mask &= mask - 1) {
+            const size_t at = walk + pfc::findLowestBit64(mask);
+            if (subLen <= 2 || noopt_equalsI(p + at + 1, sub + 1, subLen - 2)) return at;
+        }
+    }
+    const size_t found = noopt_asciiFindI(p + walk, len - walk, sub, subLen);
+    return found == SIZE_MAX ? SIZE_MAX : walk + found;
+}
+#endif // STRING_ASCII_SSE
+
+#if allowAVX2
+inline static __m256i avx2_tolower(__m256i v) {
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+inline static size_t avx2_asciiSpan(const char * p, size_t len) {
+    size_t walk = 0;
+    for (; walk + 32 <= len; walk += 32) {
+        const unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(p + walk)));
+        if (mask != 0) return walk + pfc::findLowestBit64(mask);
+    }
+    return walk + sse2_asciiSpan(p + walk, len - walk);
+}
+
+inline static size_t avx2_asciiCommonPrefixI(const char * p1, const char * p2, size_t len) {
+    size_t walk = 0;
+    for (; walk + 32 <= len; walk += 32) {
+        const __m256i v1 = _mm256_loadu_si256((const __m256i*)(p1 + walk));
+        const __m256i v2 = _mm256_loadu_si256((const __m256i*)(p2 + walk));
+        const __m256i same = _mm256_cmpeq_epi8(avx2_tolower(v1), avx2_tolower(v2));
+        const __m256i null = _mm256_cmpeq_epi8(v1, _mm256_setzero_si256());
+        const unsigned stop = ~(unsigned)_mm256_movemask_epi8(_mm256_andnot_si256(null, same));
+        if (stop != 0) return walk + pfc::findLowestBit64(stop);
+    }
+    return walk + sse2_asciiCommonPrefixI(p1 + walk, p2 + walk, len - walk);
+}
+
+inline static size_t avx2_asciiFindI(const char * p, size_t len, const char * sub, size_t subLen) {
+    const __m256i first = _mm256_set1_epi8(pfc::ascii_tolower(sub[0]));
+    const __m256i last = _mm256_set1_epi8(pfc::ascii_tolower(sub[subLen - 1]));
+    const size_t positions = len - subLen + 1;
+    size_t walk = 0;
+    for (; walk + 32 <= positions; walk += 32) {
+        const __m256i v1 = avx2_tolower(_mm256_loadu_si256((const __m256i*)(p + walk)));
+        const __m256i v2 = avx2_tolower(_mm256_loadu_si256((const __m256i*)(p + walk + subLen - 1)));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(v1, first), _mm256_cmpeq_epi8(v2, last)));
+        for (; mask != 0; mask &= mask - 1) {
+            const size_t at = walk + pfc::findLowestBit64(mask);
+            if (subLen <= 2 || noopt_equalsI(p + at + 1, sub + 1, subLen - 2)) return at;
+        }
+    }
+    const size_t found = sse2_asciiFindI(p + walk, len - walk, sub, subLen);
+    return found == SIZE_MAX ? SIZE_MAX : walk + found;
+}
+#endif // allowAVX2
+
+#ifdef STRING_ASCII_NEON
+inline static uint8x16_t neon_tolower(uint8x16_t v) {
+    const uint8x16_t upper = vandq_u8(vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+    return vorrq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+// Neon has no movemask; narrowing gives four bits per byte of a compare result, keep one of them
+inline static uint64_t neon_mask(uint8x16_t v) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0) & 0x8888888888888888ull;
+}
+
+inline static size_t neon_asciiSpan(const char * p, size_t len) {
+    size_t walk = 0;
+    for (; walk + 16 <= len; walk += 16) {
+        const uint64_t mask = neon_mask(vcgeq_u8(vld1q_u8((const uint8_t*)(p + walk)), vdupq_n_u8(0x80)));
+        if (mask != 0) return walk + pfc::findLowestBit64(mask) / 4;
+    }
+    return walk + noopt_asciiSpan(p + walk, len - walk);
+}
+
+inline static size_t neon_asciiCommonPrefixI(const char * p1, const char * p2, size_t len) {
+    size_t walk = 0;
+    for (; walk + 16 <= len; walk += 16) {
+        const uint8x16_t v1 = vld1q_u8((const uint8_t*)(p1 + walk));
+        const uint8x16_t v2 = vld1q_u8((const uint8_t*)(p2 + walk));
+        const uint8x16_t differ = vmvnq_u8(vceqq_u8(neon_tolower(v1), neon_tolower(v2)));
+        const uint64_t stop = neon_mask(vorrq_u8(differ, vceqq_u8(v1, vdupq_n_u8(0))));
+        if (stop != 0) return walk + pfc::findLowestBit64(stop) / 4;
+    }
+    return walk + noopt_asciiCommonPrefixI(p1 + walk, p2 + walk, len - walk);
+}
+
+inline static size_t neon_asciiFindI(const char * p, size_t len, const char * sub, size_t subLen) {
+    const uint8x16_t first = vdupq_n_u8((uint8_t)pfc::ascii_tolower(sub[0]));
+    const uint8x16_t last = vdupq_n_u8((uint8_t)pfc::ascii_tolower(sub[subLen - 1]));
+    const size_t positions = len - subLen + 1;
+    size_t walk = 0;
+    for (; walk + 16 <= positions; walk += 16) {
+        const uint8x16_t v1 = neon_tolower(vld1q_u8((const uint8_t*)(p + walk)));
+        const uint8x16_t v2 = neon_tolower(vld1q_u8((const uint8_t*)(p + walk + subLen - 1)));
+        uint64_t mask = neon_mask(vandq_u8(vceqq_u8(v1, first), vceqq_u8(v2, last)));
+        for (; mask != 0; mask &= mask - 1) {
+            const size_t at = walk + pfc::findLowestBit64(mask) / 4;
+            if (subLen <= 2 || noopt_equalsI(p + at + 1, sub + 1, subLen - 2)) return at;
+        }
+    }
+    const size_t found = noopt_asciiFindI(p + walk, len - walk, sub, subLen);
+    return found == SIZE_MAX ? SIZE_MAX : walk + found;
+}
+#endif // STRING_ASCII_NEON
+
+static bool g_scalarOnly = false;
+
+namespace pfc {
+    void asciiScalarOnly(bool state) {
+        g_scalarOnly = state;
+    }
+
+    size_t asciiSpan(const char * p, size_t len) {
+        if (g_scalarOnly) return noopt_asciiSpan(p, len);
+#if defined(STRING_ASCII_SSE)
+#if allowAVX2
+        if (haveAVX2) return avx2_asciiSpan(p, len);
+#endif
+        return sse2_asciiSpan(p, len);
+#elif defined(STRING_ASCII_NEON)
+        return neon_asciiSpan(p, len);
+#else
+        return noopt_asciiSpan(p, len);
+#endif
+    }
+
+    size_t asciiCommonPrefixI(const char * p1, const char * p2, size_t len) {
+        if (g_scalarOnly) return noopt_asciiCommonPrefixI(p1, p2, len);
+#if defined(STRING_ASCII_SSE)
+#if allowAVX2
+        if (haveAVX2) return avx2_asciiCommonPrefixI(p1, p2, len);
+#endif
+        return sse2_asciiCommonPrefixI(p1, p2, len);
+#elif defined(STRING_ASCII_NEON)
+        return neon_asciiCommonPrefixI(p1, p2, len);
+#else
+        return noopt_asciiCommonPrefixI(p1, p2, len);
+#endif
+    }
+
+    size_t asciiFindI(const char * p, size_t len, const char * sub, size_t subLen) {
+        if (subLen == 0 || subLen > len) return SIZE_MAX;
+        if (g_scalarOnly) return noopt_asciiFindI(p, len, sub, subLen);
+#if defined(STRING_ASCII_SSE)
+#if allowAVX2
+        if (haveAVX2) return avx2_asciiFindI(p, len, sub, subLen);
+#endif
+        return sse2_asciiFindI(p, len, sub, subLen);
+#elif defined(STRING_ASCII_NEON)
+        return neon_asciiFindI(p, len, sub, subLen);
+#else
+        return noopt_asciiFindI(p, len, sub, subLen);
+#endif
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Scans over ASCII text 16 or 32 bytes at a time: SSE2, AVX2 when the CPU has it, Neon on ARM64,
+// plain loops elsewhere. They take explicit lengths and never read past p + len,
+// callers holding null terminated strings pay one strlen() to use them.
+
+namespace pfc {
+	//! Length of the leading run of ASCII (below 0x80) bytes in p[0 ... len-1].
+	size_t asciiSpan(const char * p, size_t len);
+	inline bool isPureASCII(const char * p, size_t len) { return asciiSpan(p, len) == len; }
+
+	//! Length of the common prefix of p1[0 ... len-1] and p2[0 ... len-1] compared with ascii_tolower(). \n
+	//! Stops at the first null char, no null char is ever part of the prefix.
+	size_t asciiCommonPrefixI(const char * p1, const char * p2, size_t len);
+
+	//! Offset of the first occurrence of sub in p[0 ... len-1], bytes compared with ascii_tolower(). \n
+	//! Returns SIZE_MAX if not found or if sub is empty.
+	size_t asciiFindI(const char * p, size_t len, const char * sub, size_t subLen);
+
+	//! Makes the functions above run their plain loops instead of SSE2 / AVX2 / Neon, so that benchmark() can time both. \n
+	//! Not thread safe, only for use while nothing else calls them.
+	void asciiScalarOnly(bool state);
+}
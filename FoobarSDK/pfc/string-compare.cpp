@@ -1,6 +1,7 @@
 #include "pfc-lite.h"
 
 #include "string-compare.h"
+#include "string-ascii.h"
 #include "string_base.h"
 #include "debug.h"
 #include "bsearch_inline.h"
@@ -36,6 +37,16 @@ namespace pfc {
         }
     }
 
+    // Most strings differ or end within a few chars and the plain loops settle them. Once this many chars are equal,
+    // the rest of the common part is skipped a block at a time.
+    static constexpr t_size asciiBlockCompareAfter = 16;
+
+    static t_size skipCommonPrefixI(const char* s1, t_size len1, const char* s2, t_size len2, t_size walk) {
+        // lengths are upper bounds (often ~0), the block compare must not run past either terminator
+        const t_size rem1 = strlen_max(s1 + walk, len1 - walk), rem2 = strlen_max(s2 + walk, len2 - walk);
+        return walk + asciiCommonPrefixI(s1 + walk, s2 + walk, min_t(rem1, rem2));
+    }
+
     bool stringEqualsI_ascii_ex(const char* s1, size_t len1, const char* s2, size_t len2) throw() {
         t_size walk1 = 0, walk2 = 0;
         for (;;) {
@@ -46,6 +57,7 @@ namespace pfc {
             if (c1 == 0) return true;
             walk1++;
             walk2++;
+            if (walk1 == asciiBlockCompareAfter) walk2 = walk1 = skipCommonPrefixI(s1, len1, s2, len2, walk1);
         }
     }
 
@@ -60,6 +72,7 @@ namespace pfc {
             else if (c1 == 0) return 0;
             walk1++;
             walk2++;
+            if (walk1 == asciiBlockCompareAfter) walk2 = walk1 = skipCommonPrefixI(s1, len1, s2, len2, walk1);
         }
     }
 
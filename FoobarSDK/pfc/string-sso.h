@@ -0,0 +1,116 @@
+#pragma once
+
+#include "string-interface.h"
+#include "alloc.h"
+
+namespace pfc {
+
+	//! string_base keeping values shorter than inline_size bytes inside the object, longer ones on the heap. \n
+	//! For scratch strings that are mostly short, formatted tags and titles: stringLite allocates for any non-empty value,
+	//! this one only once a value outgrows the inline buffer. The heap buffer is kept until destruction, reset() and truncate() never shrink.
+	template<t_size inline_size>
+	class string_sso_t : public string_base {
+	public:
+		string_sso_t() { init(); }
+		string_sso_t(const string_sso_t & p_source) { init(); set_string(p_source.m_ptr, p_source.m_length); }
+		string_sso_t(string_sso_t && p_source) noexcept { init(); move(p_source); }
+		string_sso_t(const char * p_source, t_size p_length = SIZE_MAX) { init(); set_string(p_source, p_length); }
+		string_sso_t(const string_base & p_source) { init(); set_string(p_source.get_ptr(), p_source.get_length()); }
+		~string_sso_t() { if (m_ptr != m_inline) raw_free(m_ptr); }
+
+		string_sso_t const & operator=(const string_sso_t & p_source) { set_string(p_source.m_ptr, p_source.m_length); return *this; }
+		string_sso_t const & operator=(string_sso_t && p_source) noexcept { if (this != &p_source) move(p_source); return *this; }
+		string_sso_t const & operator=(const char * p_source) { set_string(p_source); return *this; }
+		string_sso_t const & operator=(const string_base & p_source) { set_string(p_source.get_ptr(), p_source.get_length()); return *this; }
+
+		const char * get_ptr() const { return m_ptr; }
+		operator const char * () const { return m_ptr; }
+		const char * c_str() const { return m_ptr; }
+		t_size get_length() const { return m_length; }
+
+		//! True while the value lives in the inline buffer.
+		bool is_inline() const { return m_ptr == m_inline; }
+
+		void add_string(const char * p_string, t_size p_length = SIZE_MAX) {
+			p_length = strlen_max(p_string, p_length);
+			if (m_length + p_length < m_length) throw exception_overflow();
+			p_string = make_room(m_length + p_length, p_string);
+			memcpy(m_ptr + m_length, p_string, p_length);
+			m_length += p_length;
+			m_ptr[m_length] = 0;
+		}
+		void set_string(const char * p_string, t_size p_length = SIZE_MAX) {
+			p_length = strlen_max(p_string, p_length);
+			p_string = make_room(p_length, p_string);
+			// may be a part of this very string
+			memmove(m_ptr, p_string, p_length);
+			m_length = p_length;
+			m_ptr[m_length] = 0;
+		}
+		void truncate(t_size p_length) {
+			if (p_length < m_length) {
+				m_length = p_length;
+				m_ptr[p_length] = 0;
+			}
+		}
+		char * lock_buffer(t_size p_requested_length) {
+			make_room(p_requested_length, NULL);
+			memset(m_ptr, 0, p_requested_length + 1);
+			return m_ptr;
+		}
+		void unlock_buffer() {
+			m_length = strlen(m_ptr);
+		}
+		void prealloc(t_size p_length) {
+			make_room(p_length, NULL);
+		}
+	private:
+		void init() {
+			PFC_STATIC_ASSERT(inline_size > 1);
+			m_ptr = m_inline; m_length = 0; m_capacity = inline_size; m_inline[0] = 0;
+		}
+
+		// room for p_length chars and the null; returns p_source, adjusted if it pointed into the buffer that moved
+		const char * make_room(t_size p_length, const char * p_source) {
+			if (p_length < m_capacity) return p_source;
+			if (p_length + 1 == 0) throw exception_overflow();
+
+			t_size capacity = m_capacity + m_capacity / 2;
+			if (capacity < p_length + 1) capacity = p_length + 1;
+
+			const bool own = p_source >= m_ptr && p_source <= m_ptr + m_length;
+			const t_size offset = own ? p_source - m_ptr : 0;
+
+			if (m_ptr == m_inline) {
+				char * mem = (char*) raw_malloc(capacity);
+				memcpy(mem, m_inline, m_length + 1);
+				m_ptr = mem;
+			} else {
+				m_ptr = (char*) raw_realloc(m_ptr, capacity);
+			}
+			m_capacity = capacity;
+
+			return own ? m_ptr + offset : p_source;
+		}
+
+		void move(string_sso_t & p_source) {
+			if (m_ptr != m_inline) raw_free(m_ptr);
+			if (p_source.m_ptr == p_source.m_inline) {
+				m_ptr = m_inline; m_capacity = inline_size;
+				memcpy(m_inline, p_source.m_inline, p_source.m_length + 1);
+			} else {
+				m_ptr = p_source.m_ptr; m_capacity = p_source.m_capacity;
+			}
+			m_length = p_source.m_length;
+			p_source.init();
+		}
+
+		char * m_ptr;
+		t_size m_length;
+		t_size m_capacity;
+		char m_inline[inline_size];
+	};
+
+	//! Scratch string for formatted tag values, the usual ones need no allocation.
+	typedef string_sso_t<48> string8_sso;
+}
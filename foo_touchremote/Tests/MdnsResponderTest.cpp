@@ -0,0 +1,372 @@
+/*
+Drives MdnsResponder against a private multicast group on the local host instead of 224.0.0.251:5353:
+the announcement on start, a legacy unicast PTR query, a query for another service and the goodbye on stop,
+then a host without any address, from the start and after losing the one it had.
+POSIX sockets, the stdafx.h next to this file replaces the plugin's precompiled header. From the repository root:
+
+  P=FoobarSDK/pfc
+  g++ -std=c++17 -D_DEBUG -include limits.h -Ifoo_touchremote/Tests -I$P -o mdns_test foo_touchremote/Tests/MdnsResponderTest.cpp \
+      foo_touchremote/foo_touchremote/MdnsResponder.cpp $P/string-lite.cpp $P/string_base.cpp $P/string-compare.cpp \
+      $P/string-ascii.cpp $P/threads.cpp $P/timers.cpp $P/sort.cpp $P/bit_array.cpp $P/other.cpp $P/nix-objects.cpp \
+      $P/synchro_nix.cpp $P/utf8.cpp $P/cpuid.cpp $P/filehandle.cpp $P/splitString2.cpp $P/crashWithMessage.cpp \
+      $P/pathUtils.cpp $P/pfc-fb2k-hooks.cpp -lpthread && ./mdns_test
+
+pathUtils.cpp takes NAME_MAX from limits.h, which nothing else includes on Linux.
+Prints every check and exits with 1 if one failed.
+*/
+
+#include "stdafx.h"
+#include "../foo_touchremote/MdnsResponder.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <stdio.h>
+
+using namespace foo_touchremote;
+
+namespace
+{
+	const char * GROUP = "239.255.42.99";
+	const t_uint16 PORT = 15353;
+
+	enum
+	{
+		TYPE_A = 1,
+		TYPE_PTR = 12,
+		TYPE_TXT = 16,
+		TYPE_SRV = 33,
+	};
+
+	struct record_t
+	{
+		pfc::string8 Name;
+		unsigned Type;
+		t_uint32 Ttl;
+		pfc::string8 Data;		// PTR and SRV target, TXT strings separated by ';', A as a dotted quad
+		unsigned Port;			// SRV only
+	};
+
+	struct packet_t
+	{
+		unsigned Id;
+		unsigned Flags;
+		pfc::list_t<pfc::string8> Questions;
+		pfc::list_t<record_t> Answers;
+		pfc::list_t<record_t> Additionals;
+	};
+
+	unsigned failures = 0;
+
+	void check(bool condition, const char * what)
+	{
+		printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+		if (!condition) failures++;
+	}
+
+	unsigned get16(const t_uint8 * p) { return (p[0] << 8) | p[1]; }
+	t_uint32 get32(const t_uint8 * p) { return ((t_uint32)get16(p) << 16) | get16(p + 2); }
+
+	// dotted name at offset, following compression pointers; offset moves past the name as it is stored
+	bool read_name(const t_uint8 * p, t_size size, t_size & offset, pfc::string8 & out)
+	{
+		out.reset();
+		t_size at = offset;
+		bool jumped = false;
+		for (unsigned hops = 0; ; )
+		{
+			if (at >= size) return false;
+			unsigned length = p[at];
+			if ((length & 0xC0) == 0xC0)
+			{
+				if (at + 1 >= size || ++hops > 16) return false;
+				if (!jumped) offset = at + 2;
+				jumped = true;
+				at = ((length & 0x3F) << 8) | p[at + 1];
+				continue;
+			}
+			at++;
+			if (length == 0) break;
+			if (at + length > size) return false;
+			out.add_string((const char *)p + at, length);
+			out.add_char('.');
+			at += length;
+		}
+		if (!jumped) offset = at;
+		return true;
+	}
+
+	bool parse(const t_uint8 * p, t_size size, packet_t & out)
+	{
+		if (size < 12) return false;
+		out.Id = get16(p);
+		out.Flags = get16(p + 2);
+		const unsigned questions = get16(p + 4);
+		const unsigned answers = get16(p + 6);
+		const unsigned records = answers + get16(p + 8) + get16(p + 10);
+
+		t_size offset = 12;
+		for (unsigned i = 0; i < questions; i++)
+		{
+			pfc::string8 name;
+			if (!read_name(p, size, offset, name) || offset + 4 > size) return false;
+			offset += 4;
+			out.Questions.add_item(name);
+		}
+
+		for (unsigned i = 0; i < records; i++)
+		{
+			record_t r;
+			r.Port = 0;
+			if (!read_name(p, size, offset, r.Name) || offset + 10 > size) return false;
+			r.Type = get16(p + offset);
+			r.Ttl = get32(p + offset + 4);
+			const t_size length = get16(p + offset + 8);
+			offset += 10;
+			if (offset + length > size) return false;
+
+			t_size data = offset;
+			switch (r.Type)
+			{
+			case TYPE_PTR:
+				if (!read_name(p, size, data, r.Data)) return false;
+				break;
+			case TYPE_SRV:
+				if (length < 7) return false;
+				r.Port = get16(p + offset + 4);
+				data += 6;
+				if (!read_name(p, size, data, r.Data)) return false;
+				break;
+			case TYPE_TXT:
+				for (t_size at = offset; at < offset + length; at += 1 + p[at])
+				{
+					if (at + 1 + p[at] > offset + length) return false;
+					r.Data.add_string((const char *)p + at + 1, p[at]);
+					r.Data.add_char(';');
+				}
+				break;
+			case TYPE_A:
+				if (length == 4) r.Data << p[offset] << "." << p[offset + 1] << "." << p[offset + 2] << "." << p[offset + 3];
+				break;
+			}
+			offset += length;
+
+			if (i < answers) out.Answers.add_item(r);
+			else out.Additionals.add_item(r);
+		}
+		return true;
+	}
+
+	const record_t * find(const pfc::list_t<record_t> & records, unsigned type, const char * name)
+	{
+		for (t_size i = 0; i < records.get_count(); i++)
+			if (records[i].Type == type && pfc::stricmp_ascii(records[i].Name, name) == 0) return &records[i];
+		return NULL;
+	}
+
+	// The next response on the socket, queries from the test itself are skipped. False on timeout.
+	bool receive(int s, packet_t & out, double seconds)
+	{
+		pfc::hires_timer timer;
+		timer.start();
+		for (;;)
+		{
+			const double left = seconds - timer.query();
+			if (left <= 0) return false;
+
+			fd_set set;
+			FD_ZERO(&set);
+			FD_SET(s, &set);
+			timeval timeout = { (long)left, (long)((left - (long)left) * 1000000) };
+			if (select(s + 1, &set, NULL, NULL, &timeout) <= 0) return false;
+
+			t_uint8 buffer[9000];
+			const ssize_t size = recv(s, buffer, sizeof(buffer), 0);
+			if (size <= 0) return false;
+
+			packet_t packet;
+			if (!parse(buffer, size, packet) || (packet.Flags & 0x8000) == 0) continue;
+			out = packet;
+			return true;
+		}
+	}
+
+	// Listens on the group the way another mDNS host would. Bound to the group address, not INADDR_ANY,
+	// so that unicast queries sent to the responder's port on loopback do not end up on this socket.
+	int open_listener()
+	{
+		const int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (s < 0) return -1;
+
+		int on = 1;
+		setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(PORT);
+		addr.sin_addr.s_addr = inet_addr(GROUP);
+
+		ip_mreq mreq = {};
+		mreq.imr_multiaddr.s_addr = inet_addr(GROUP);
+		mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+		if (bind(s, (const sockaddr *)&addr, sizeof(addr)) != 0 ||
+			setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0)
+		{
+			close(s);
+			return -1;
+		}
+		return s;
+	}
+
+	// Legacy unicast query from an ephemeral port, RFC 6762 section 6.7.
+	void send_query(int s, unsigned id, const char * name, unsigned type, const char * to_address = "127.0.0.1")
+	{
+		pfc::array_t<t_uint8> packet;
+		const t_uint8 header[] = { (t_uint8)(id >> 8), (t_uint8)id, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0 };
+		packet.append_fromptr(header, sizeof(header));
+
+		pfc::list_t<pfc::string8> labels;
+		pfc::splitStringSimple_toList(labels, '.', name);
+		for (t_size i = 0; i < labels.get_count(); i++)
+		{
+			packet.append_single((t_uint8)labels[i].length());
+			packet.append_fromptr((const t_uint8 *)labels[i].get_ptr(), labels[i].length());
+		}
+		const t_uint8 footer[] = { 0, (t_uint8)(type >> 8), (t_uint8)type, 0, 1 };
+		packet.append_fromptr(footer, sizeof(footer));
+
+		sockaddr_in to = {};
+		to.sin_family = AF_INET;
+		to.sin_port = htons(PORT);
+		to.sin_addr.s_addr = inet_addr(to_address);
+		sendto(s, packet.get_ptr(), packet.get_size(), 0, (const sockaddr *)&to, sizeof(to));
+	}
+
+	// Reports no address at all, or only the loopback one; switchable while running.
+	class TestResponder : public MdnsResponder
+	{
+	public:
+		TestResponder(bool loopback) : m_loopback(loopback), m_lookups(0) {}
+		~TestResponder() { Stop(); }
+
+		void SetLoopback(bool loopback) { m_loopback = loopback; }
+		unsigned Lookups() const { return m_lookups; }
+
+	protected:
+		virtual void GetAddresses(pfc::list_t<t_uint32> & out) override
+		{
+			if (m_loopback) out.add_item(inet_addr("127.0.0.1"));
+			m_lookups++;
+		}
+
+	private:
+		volatile bool m_loopback;
+		volatile unsigned m_lookups;
+	};
+}
+
+int main()
+{
+	const char * TYPE_NAME = "_touch-able._tcp.local.";
+	const char * INSTANCE_NAME = "ABCDEF0123._touch-able._tcp.local.";
+	const char * HOST_NAME = "testhost.local.";
+
+	const int listener = open_listener();
+	const int querier = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	check(listener >= 0 && querier >= 0, "sockets open");
+	if (listener < 0 || querier < 0) return 1;
+
+	MdnsResponder::Service service;
+	service.Instance = "ABCDEF0123";
+	service.Type = "_touch-able._tcp";
+	service.Host = "testhost.local.";
+	service.Port = 3689;
+	service.Txt.add_item("txtvers=1");
+	service.Txt.add_item("CtlN=foobar2000");
+
+	MdnsResponder responder;
+	responder.Start(service, GROUP, PORT);
+	check(responder.IsRunning(), "responder running");
+
+	packet_t packet;
+	{
+		const bool received = receive(listener, packet, 3);
+		check(received, "announcement received on the group");
+		const record_t * ptr = find(packet.Answers, TYPE_PTR, TYPE_NAME);
+		const record_t * srv = find(packet.Answers, TYPE_SRV, INSTANCE_NAME);
+		const record_t * txt = find(packet.Answers, TYPE_TXT, INSTANCE_NAME);
+		check(received && packet.Id == 0, "announcement has id 0");
+		check(ptr != NULL && strcmp(ptr->Data, INSTANCE_NAME) == 0 && ptr->Ttl > 0, "announcement: PTR to the instance");
+		check(srv != NULL && srv->Port == 3689 && strcmp(srv->Data, HOST_NAME) == 0, "announcement: SRV to the host on port 3689");
+		check(txt != NULL && strstr(txt->Data, "CtlN=foobar2000;") != NULL, "announcement: TXT with the library name");
+		check(find(packet.Answers, TYPE_A, HOST_NAME) != NULL, "announcement: A record for the host");
+	}
+
+	{
+		send_query(querier, 0x1234, TYPE_NAME, TYPE_PTR);
+		const bool received = receive(querier, packet, 2);
+		check(received, "legacy unicast query answered");
+		const record_t * ptr = find(packet.Answers, TYPE_PTR, TYPE_NAME);
+		check(received && packet.Id == 0x1234, "reply echoes the query id");
+		check(packet.Questions.get_count() == 1 && pfc::stricmp_ascii(packet.Questions[0], TYPE_NAME) == 0, "reply echoes the question");
+		check(ptr != NULL && strcmp(ptr->Data, INSTANCE_NAME) == 0 && ptr->Ttl == 10, "reply: PTR with a 10 second TTL");
+		check(find(packet.Additionals, TYPE_SRV, INSTANCE_NAME) != NULL, "reply: SRV in the additionals");
+		check(find(packet.Additionals, TYPE_TXT, INSTANCE_NAME) != NULL, "reply: TXT in the additionals");
+		check(find(packet.Additionals, TYPE_A, HOST_NAME) != NULL, "reply: A in the additionals");
+	}
+
+	{
+		send_query(querier, 0x4321, "_other._tcp.local.", TYPE_PTR);
+		check(!receive(querier, packet, 0.5), "no reply for another service");
+	}
+
+	{
+		responder.Stop();
+		check(!responder.IsRunning(), "responder stopped");
+		bool goodbye = false;
+		while (!goodbye && receive(listener, packet, 2))
+		{
+			const record_t * ptr = find(packet.Answers, TYPE_PTR, TYPE_NAME);
+			goodbye = ptr != NULL && ptr->Ttl == 0;
+		}
+		check(goodbye, "goodbye with TTL 0 after stop");
+	}
+
+	close(listener);
+
+	// Nothing else on the host is in the group now, so a query sent to it only arrives through the responder's own
+	// membership, which has to be on the default interface when there is no address.
+	{
+		TestResponder none(false);
+		none.Start(service, GROUP, PORT);
+		send_query(querier, 0x5555, TYPE_NAME, TYPE_PTR, GROUP);
+		const bool received = receive(querier, packet, 2);
+		check(received && packet.Id == 0x5555, "no address: query to the group answered");
+	}
+
+	{
+		TestResponder lost(true);
+		lost.Start(service, GROUP, PORT);
+		const unsigned lookups = lost.Lookups();
+		lost.SetLoopback(false);
+
+		// the next refresh drops the loopback membership and joins the default interface instead
+		pfc::hires_timer timer;
+		timer.start();
+		while (lost.Lookups() == lookups && timer.query() < 10) usleep(50000);
+		usleep(100000);
+
+		send_query(querier, 0x6666, TYPE_NAME, TYPE_PTR, GROUP);
+		const bool received = receive(querier, packet, 2);
+		check(received && packet.Id == 0x6666, "address lost: query to the group answered");
+	}
+
+	close(querier);
+
+	printf("%u check(s) failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+﻿using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Text.RegularExpressions;
+using TouchRemote.Core.Dacp;
+using TouchRemote.Core.Http;
+
+namespace TouchRemote.Tests
+{
+    /// <summary>
+    /// Route resolution throughput of RouteTable against the PathMapper it replaced: a cascade of
+    /// literal compares and StartsWith calls, then the responder's regex for the ids and command names.
+    /// Responders are not created on either side, only the path is resolved to its values.
+    /// </summary>
+    internal static class Program
+    {
+        private struct Route
+        {
+            public int Id;
+            public string Query;
+            public int? Id2;
+            public string Query2;
+
+            public override string ToString()
+            {
+                return string.Format("{0}/{1}/{2}/{3}", Id, Query, Id2, Query2);
+            }
+        }
+
+        // what a remote sends while showing the now playing screen and browsing, playstatusupdate dominating
+        private static readonly string[] paths =
+        {
+            "/ctrl-int/1/playstatusupdate",
+            "/ctrl-int/1/playstatusupdate",
+            "/ctrl-int/1/playstatusupdate",
+            "/ctrl-int/1/getproperty",
+            "/ctrl-int/1/nowplayingartwork",
+            "/ctrl-int/1/setproperty",
+            "/databases/38/containers",
+            "/databases/38/containers/41/items",
+            "/databases/38/groups",
+            "/databases/38/groups/1257/extra_data/artwork",
+            "/databases/38/items/88123/extra_data/artwork",
+            "/databases/38/browse/artists",
+            "/databases",
+            "/server-info",
+            "/update",
+            "/login",
+        };
+
+        private const int Iterations = 2000000;
+
+        // PathMapper.CreateRoutes, with handlers that only pick up the values
+        private static RouteTable CreateRoutes(Route[] result)
+        {
+            var table = new RouteTable();
+
+            foreach (var path in new[] { "/server-info", "/login", "/logout", "/fp-setup", "/update", "/stream.wav", "/stats", "/databases", "/ctrl-int" })
+                table.Add(path, (r, v) => { result[0] = new Route(); return null; });
+
+            table.Add("/databases/{id}/{name}", (r, v) => { result[0] = new Route { Id = v.Id, Query = v.Name }; return null; });
+            table.Add("/databases/{id}/{name}/{id}/{name}", (r, v) => { result[0] = new Route { Id = v.Id, Query = v.Name, Id2 = v.Id2, Query2 = v.Name2 }; return null; });
+            table.Add("/databases/{id}/{name}/{id}/extra_data/{name}", (r, v) => { result[0] = new Route { Id = v.Id, Query = v.Name, Id2 = v.Id2, Query2 = v.Name2 == "artwork" ? "extra_data/artwork" : "extra_data/" + v.Name2 }; return null; });
+            table.Add("/databases/{id}/browse/{name}", (r, v) => { result[0] = new Route { Id = v.Id, Query = "browse", Query2 = v.Name }; return null; });
+            table.Add("/ctrl-int/{id}/{name}", (r, v) => { result[0] = new Route { Id = v.Id, Query = v.Name }; return null; });
+
+            return table;
+        }
+
+        // the regexes DatabaseInstanceResponder and CtrlIntInstanceResponder had
+        private static readonly Regex databaseRegex = new Regex(@"^/databases/(\d+)/([a-z]+)(/(\d+)/((extra_data/)?[a-z]+))?$");
+        private static readonly Regex databaseRegex2 = new Regex(@"^/databases/(\d+)/browse/([a-z]+)$");
+        private static readonly Regex ctrlIntRegex = new Regex(@"^/ctrl-int/(\d+)/([a-z\-]+)$");
+
+        private static bool MapRoutes(RouteTable routes, Route[] result, HttpRequest request, out Route route)
+        {
+            result[0] = new Route { Id = -1 };
+            routes.Map(request);
+            route = result[0];
+            return route.Id != -1;
+        }
+
+        private static bool MapLegacy(HttpRequest request, out Route route)
+        {
+            route = new Route();
+            var path = request.Path;
+
+            if (path == "/server-info" || path == "/login" || path == "/logout" || path == "/fp-setup" || path == "/update" || path == "/databases")
+                return true;
+
+            if (path.StartsWith("/databases/"))
+            {
+                var match = databaseRegex.Match(path);
+                if (match.Success)
+                {
+                    route.Id = int.Parse(match.Groups[1].Value);
+                    route.Query = match.Groups[2].Value;
+                    if (match.Groups[3].Success)
+                    {
+                        route.Id2 = int.Parse(match.Groups[4].Value);
+                        route.Query2 = match.Groups[5].Value;
+                    }
+                    return true;
+                }
+
+                match = databaseRegex2.Match(path);
+                if (!match.Success) return false;
+                route.Id = int.Parse(match.Groups[1].Value);
+                route.Query = "browse";
+                route.Query2 = match.Groups[2].Value;
+                return true;
+            }
+
+            if (path == "/ctrl-int")
+                return true;
+
+            if (path.StartsWith("/ctrl-int/"))
+            {
+                var match = ctrlIntRegex.Match(path);
+                if (!match.Success) return false;
+                route.Id = int.Parse(match.Groups[1].Value);
+                route.Query = match.Groups[2].Value;
+                return true;
+            }
+
+            return path == "/stream.wav";
+        }
+
+        private static int Main()
+        {
+            var requests = Array.ConvertAll(paths, p => new HttpRequest(p));
+            var result = new Route[1];
+            var routes = CreateRoutes(result);
+
+            // both sides must agree before their speed means anything
+            int failures = 0;
+            foreach (var path in new[] { "/databases/38/items/5/extra_data/other", "/databases/x/items", "/ctrl-int/1", "/ctrl-int/1/Play", "/nothing" }
+                .Concat(paths))
+            {
+                var request = new HttpRequest(path);
+                Route legacy, route;
+                bool legacyMapped = MapLegacy(request, out legacy);
+                bool mapped = MapRoutes(routes, result, request, out route);
+
+                if (mapped != legacyMapped || (mapped && route.ToString() != legacy.ToString()))
+                {
+                    Console.WriteLine("FAIL: {0} resolves to {1}, was {2}", path, mapped ? route.ToString() : "no route", legacyMapped ? legacy.ToString() : "no route");
+                    failures++;
+                }
+            }
+
+            if (failures > 0) return 1;
+
+            for (int pass = 0; pass < 2; pass++)
+            {
+                Measure("regex cascade", requests, r => { Route route; MapLegacy(r, out route); });
+                Measure("route table", requests, r => routes.Map(r));
+            }
+
+            return 0;
+        }
+
+        private static void Measure(string label, HttpRequest[] requests, Action<HttpRequest> map)
+        {
+            // warm-up, also fills the route name cache
+            for (int i = 0; i < 100000; i++)
+                map(requests[i % requests.Length]);
+
+            GC.Collect();
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            var timer = Stopwatch.StartNew();
+
+            for (int i = 0; i < Iterations; i++)
+                map(requests[i % requests.Length]);
+
+            timer.Stop();
+            allocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            Console.WriteLine("{0,-14} {1,8:N0} ns/route {2,12:N0} routes/s {3,8:N1} bytes/route",
+                label, timer.Elapsed.TotalMilliseconds * 1000000 / Iterations, Iterations / timer.Elapsed.TotalSeconds, (double)allocated / Iterations);
+        }
+    }
+}
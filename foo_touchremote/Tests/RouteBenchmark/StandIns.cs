@@ -0,0 +1,26 @@
+﻿using System;
+using TouchRemote.Core.Misc;
+
+// The parts of the request and responder types RouteTable uses, so it builds without the HTTP server.
+
+namespace TouchRemote.Core.Http
+{
+    public class HttpRequest
+    {
+        public HttpRequest(string path)
+        {
+            Path = path;
+        }
+
+        public string Path { get; private set; }
+
+        internal Histogram RouteLatency { get; set; }
+    }
+}
+
+namespace TouchRemote.Core.Dacp.Responders
+{
+    public interface IResponder
+    {
+    }
+}
@@ -0,0 +1,152 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Runtime.CompilerServices;
+using System.Text;
+
+namespace TouchRemote.Tests
+{
+    /// <summary>
+    /// Managed heap held by the artist, album artist, genre and composer values of a 100k track library: one string
+    /// per track and field, as Track::ReadInfo made them before, against the values shared through StringPool.
+    /// StringPool is C++/CLI, Pool below is its GetId/GetValue part (the trigram index is left out, it is there for search).
+    /// </summary>
+    internal static class Program
+    {
+        private const int Tracks = 100000;
+        private const int TracksPerAlbum = 10;
+        private const int Artists = 8000;
+        private const int Genres = 300;
+        private const int Composers = 3000;
+
+        private sealed class Pool
+        {
+            private readonly Dictionary<string, int> ids = new Dictionary<string, int>(StringComparer.Ordinal);
+            private string[] values = new string[256];
+            private int count = 1;
+
+            public Pool()
+            {
+                values[0] = string.Empty;
+            }
+
+            public string Intern(string value)
+            {
+                if (string.IsNullOrEmpty(value)) return string.Empty;
+
+                int id;
+                if (!ids.TryGetValue(value, out id))
+                {
+                    if (count == values.Length)
+                        Array.Resize(ref values, values.Length * 2);
+
+                    id = count++;
+                    values[id] = value;
+                    ids.Add(value, id);
+                }
+
+                return values[id];
+            }
+        }
+
+        // what a track keeps of its tags
+        private sealed class Row
+        {
+            public string Artist;
+            public string AlbumArtist;
+            public string Genre;
+            public string Composer;
+        }
+
+        private static string Word(Random random, int min, int max)
+        {
+            var text = new StringBuilder();
+            int length = random.Next(min, max + 1);
+            for (int i = 0; i < length; i++)
+                text.Append(i > 0 && random.Next(6) == 0 ? ' ' : (char)('a' + random.Next(26)));
+            return text.ToString();
+        }
+
+        private static string[] Words(Random random, int count, int min, int max)
+        {
+            var words = new string[count];
+            for (int i = 0; i < count; i++)
+                words[i] = Word(random, min, max);
+            return words;
+        }
+
+        // every track reads its values from the tags again, a fresh string per track and field
+        private static string Read(string tag)
+        {
+            return tag.Length == 0 ? string.Empty : new string(tag.AsSpan());
+        }
+
+        private static Row[] Load(string[][] tags, Pool pool)
+        {
+            var rows = new Row[Tracks];
+            for (int i = 0; i < Tracks; i++)
+            {
+                var t = tags[i / TracksPerAlbum];
+                var row = new Row { Artist = Read(t[0]), AlbumArtist = Read(t[1]), Genre = Read(t[2]), Composer = Read(t[3]) };
+                if (pool != null)
+                {
+                    row.Artist = pool.Intern(row.Artist);
+                    row.AlbumArtist = pool.Intern(row.AlbumArtist);
+                    row.Genre = pool.Intern(row.Genre);
+                    row.Composer = pool.Intern(row.Composer);
+                }
+                rows[i] = row;
+            }
+            return rows;
+        }
+
+        private static object retained;
+
+        // heap still held by what build returns, after a full collection on both sides
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static long Retained(Func<object> build)
+        {
+            retained = null;
+            long before = GC.GetTotalMemory(true);
+            retained = build();
+            long after = GC.GetTotalMemory(true);
+            retained = null;
+            return after - before;
+        }
+
+        private static void Main()
+        {
+            // albums of ten tracks sharing their tags; most albums have no composer, a few are compilations
+            var random = new Random(1);
+            var artists = Words(random, Artists, 6, 24);
+            var genres = Words(random, Genres, 4, 14);
+            var composers = Words(random, Composers, 8, 28);
+
+            var tags = new string[Tracks / TracksPerAlbum][];
+            for (int i = 0; i < tags.Length; i++)
+            {
+                var artist = artists[random.Next(Artists)];
+                tags[i] = new[]
+                {
+                    artist,
+                    random.Next(10) == 0 ? "Various Artists" : artist,
+                    genres[random.Next(Genres)],
+                    random.Next(3) == 0 ? composers[random.Next(Composers)] : string.Empty,
+                };
+            }
+
+            long copiesHeap = 0, pooledHeap = 0;
+
+            // the first round warms up the JIT and the heap
+            for (int round = 0; round < 2; round++)
+            {
+                copiesHeap = Retained(() => Load(tags, null));
+                pooledHeap = Retained(() => { var pool = new Pool(); return new object[] { pool, Load(tags, pool) }; });
+            }
+
+            Console.WriteLine("{0:N0} tracks, {1:N0} artists, {2:N0} genres, {3:N0} composers", Tracks, Artists, Genres, Composers);
+            Console.WriteLine("string per track: {0,10:N0} bytes {1,6:N1} bytes/track", copiesHeap, (double)copiesHeap / Tracks);
+            Console.WriteLine("StringPool:       {0,10:N0} bytes {1,6:N1} bytes/track", pooledHeap, (double)pooledHeap / Tracks);
+            Console.WriteLine("saved:            {0,10:N0} bytes ({1:P0})", copiesHeap - pooledHeap, (double)(copiesHeap - pooledHeap) / copiesHeap);
+        }
+    }
+}
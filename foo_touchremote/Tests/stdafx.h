@@ -0,0 +1,4 @@
+#pragma once
+
+// Stands in for the plugin's precompiled header when the native classes are built on their own, see MdnsResponderTest.cpp.
+#include "../../FoobarSDK/pfc/pfc.h"
@@ -0,0 +1,186 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+
+namespace TouchRemote.Core
+{
+
+    /// <summary>
+    /// Bounded log of library and playlist changes, so database requests carrying delta=N can be answered
+    /// with what changed since revision N instead of the whole listing.
+    ///
+    /// Changes are recorded after they have been applied and belong to the revision committed next
+    /// by <see cref="SessionManager.DatabaseUpdated"/>. When the log is full the oldest entries are dropped,
+    /// and clients that far behind get full listings again.
+    /// </summary>
+    public static class ChangeJournal
+    {
+        private const int Capacity = 16384;
+
+        private struct Entry
+        {
+            public uint Revision;
+            public ChangeKind Kind;
+            public int Id;
+        }
+
+        private static readonly object sync = new object();
+        private static readonly Entry[] entries = new Entry[Capacity];
+        private static int start;
+        private static int count;
+        private static int revision = 1;   // the first revision remotes are handed out, committing is lock-free
+        private static uint floor;          // entries up to this revision may have been dropped
+
+        /// <summary>
+        /// Returns the last committed revision
+        /// </summary>
+        public static uint Revision
+        {
+            get { return unchecked((uint)Thread.VolatileRead(ref revision)); }
+        }
+
+        public static void ItemChanged(int id)
+        {
+            Add(ChangeKind.ItemChanged, id);
+        }
+
+        public static void ItemRemoved(int id)
+        {
+            Add(ChangeKind.ItemRemoved, id);
+        }
+
+        // added, renamed or some other property changed
+        public static void ContainerChanged(int id)
+        {
+            Add(ChangeKind.ContainerChanged, id);
+        }
+
+        public static void ContainerRemoved(int id)
+        {
+            Add(ChangeKind.ContainerRemoved, id);
+        }
+
+        // tracks were added, removed or reordered
+        public static void ContainerItemsChanged(int id)
+        {
+            Add(ChangeKind.ContainerItemsChanged, id);
+        }
+
+        private static void Add(ChangeKind kind, int id)
+        {
+            lock (sync)
+            {
+                if (count == Capacity)
+                {
+                    floor = entries[start].Revision;
+                    start = (start + 1) % Capacity;
+                    count--;
+                }
+
+                entries[(start + count) % Capacity] = new Entry { Revision = Revision + 1, Kind = kind, Id = id };
+                count++;
+            }
+        }
+
+        internal static uint Commit()
+        {
+            return unchecked((uint)Interlocked.Increment(ref revision));
+        }
+
+        /// <summary>
+        /// Collects the changes made after the given revision
+        /// </summary>
+        /// <returns>Changes, or <value>null</value> when the journal does not reach back that far</returns>
+        internal static ChangeSet GetChanges(uint since)
+        {
+            lock (sync)
+            {
+                if (since < floor || since > Revision) return null;
+
+                var changes = new ChangeSet();
+
+                // entries are in revision order
+                int first = 0, last = count;
+                while (first < last)
+                {
+                    int middle = (first + last) / 2;
+                    if (entries[(start + middle) % Capacity].Revision <= since)
+                        first = middle + 1;
+                    else
+                        last = middle;
+                }
+
+                for (int i = first; i < count; i++)
+                {
+                    var entry = entries[(start + i) % Capacity];
+                    changes.Add(entry.Kind, entry.Id);
+                }
+
+                return changes;
+            }
+        }
+
+    }
+
+    internal enum ChangeKind : byte
+    {
+        ItemChanged,
+        ItemRemoved,
+        ContainerChanged,
+        ContainerRemoved,
+        ContainerItemsChanged
+    }
+
+    /// <summary>
+    /// Net effect of a run of journal entries, the last change of an id wins
+    /// </summary>
+    internal sealed class ChangeSet
+    {
+        public readonly HashSet<int> ChangedItems = new HashSet<int>();
+        public readonly HashSet<int> RemovedItems = new HashSet<int>();
+        public readonly HashSet<int> ChangedContainers = new HashSet<int>();
+        public readonly HashSet<int> RemovedContainers = new HashSet<int>();
+        public readonly HashSet<int> RestructuredContainers = new HashSet<int>();
+
+        public void Add(ChangeKind kind, int id)
+        {
+            switch (kind)
+            {
+                case ChangeKind.ItemChanged:
+                    RemovedItems.Remove(id);
+                    ChangedItems.Add(id);
+                    break;
+
+                case ChangeKind.ItemRemoved:
+                    ChangedItems.Remove(id);
+                    RemovedItems.Add(id);
+                    break;
+
+                case ChangeKind.ContainerChanged:
+                    RemovedContainers.Remove(id);
+                    ChangedContainers.Add(id);
+                    break;
+
+                case ChangeKind.ContainerRemoved:
+                    ChangedContainers.Remove(id);
+                    RestructuredContainers.Remove(id);
+                    RemovedContainers.Add(id);
+                    break;
+
+                case ChangeKind.ContainerItemsChanged:
+                    RemovedContainers.Remove(id);
+                    ChangedContainers.Add(id);
+                    RestructuredContainers.Add(id);
+                    break;
+            }
+        }
+
+        public bool HasItemChanges
+        {
+            get { return ChangedItems.Count > 0 || RemovedItems.Count > 0; }
+        }
+
+    }
+}
@@ -8,6 +8,7 @@ using System.Linq;
 using System.Collections;
 using System.Collections.ObjectModel;
 using System.IO.Compression;
+using TouchRemote.Core.Misc;
 
 namespace TouchRemote.Core.Dacp
 {
@@ -16,11 +17,18 @@ namespace TouchRemote.Core.Dacp
 
         static readonly Dictionary<Type, int> m_estimates = new Dictionary<Type, int>();
 
+        static readonly Histogram m_serializeTime = Stats.Latency("serialize");
+        static readonly Histogram m_serializeSize = Stats.Size("serialize");
+        static readonly Histogram m_compressTime = Stats.Latency("compress");
+        static readonly Histogram m_compressSize = Stats.Size("compress");
+
         public static byte[] Serialize(object value, bool withCompression)
         {
             if (value == null)
                 throw new ArgumentNullException("value");
 
+            var start = Histogram.Start();
+
             int initialSize;
             if (!m_estimates.TryGetValue(value.GetType(), out initialSize))
                 initialSize = 128;
@@ -37,7 +45,10 @@ namespace TouchRemote.Core.Dacp
 
                 m_estimates[value.GetType()] = Math.Max(initialSize, (int)ms.Length);
 
-                return ms.ToArray();
+                var result = ms.ToArray();
+                m_serializeTime.Stop(start);
+                m_serializeSize.Add(result.Length);
+                return result;
             }
         }
 
@@ -46,6 +57,25 @@ namespace TouchRemote.Core.Dacp
             return Serialize(value, false);
         }
 
+        public static byte[] Compress(byte[] data)
+        {
+            if (data == null)
+                throw new ArgumentNullException("data");
+
+            var start = Histogram.Start();
+
+            using (var ms = new MemoryStream(data.Length))
+            {
+                using (var gzip = new GZipStream(ms, CompressionMode.Compress, true))
+                    gzip.Write(data, 0, data.Length);
+
+                var result = ms.ToArray();
+                m_compressTime.Stop(start);
+                m_compressSize.Add(result.Length);
+                return result;
+            }
+        }
+
         private static void Serialize(object value, Stream stream)
         {
             if (value == null)
@@ -13,6 +13,7 @@ namespace TouchRemote.Core.Dacp
     public class DmapResponse : HttpResponse
     {
         private readonly object m_value;
+        private readonly byte[] m_data;
 
         public DmapResponse(object value) 
         {
@@ -20,7 +21,21 @@ namespace TouchRemote.Core.Dacp
                 throw new ArgumentNullException("value");
 
             m_value = value;
-            
+            SetHeaders();
+        }
+
+        // body serialized beforehand (uncompressed)
+        public DmapResponse(byte[] data)
+        {
+            if (data == null)
+                throw new ArgumentNullException("data");
+
+            m_data = data;
+            SetHeaders();
+        }
+
+        private void SetHeaders()
+        {
             Code = 200;
             Reason = "OK";
             Headers["DAAP-Server"] = "TouchRemote v2";
@@ -35,6 +50,10 @@ namespace TouchRemote.Core.Dacp
 
             var withCompression = (dacpServer != null) ? dacpServer.Player.Preferences.CompressNetworkTraffic : false;
             Headers["Content-Encoding"] = (withCompression) ? "gzip" : "binary/octet-stream";
+
+            if (m_data != null)
+                return (withCompression) ? DataSerializer.Compress(m_data) : m_data;
+
             return DataSerializer.Serialize(m_value, withCompression);
         }
 
@@ -3,56 +3,49 @@ using System.Collections.Generic;
 using System.Text;
 using TouchRemote.Core.Dacp.Responders;
 using TouchRemote.Core.Http;
-using System.Text.RegularExpressions;
 
 namespace TouchRemote.Core.Dacp
 {
     public static class PathMapper
     {
+        private static readonly RouteTable routes = CreateRoutes();
+
+        private static RouteTable CreateRoutes()
+        {
+            var table = new RouteTable();
+
+            table.Add("/server-info", (r, v) => new ServerInfoResponder(r));
+            table.Add("/login", (r, v) => new LoginResponder(r));
+            table.Add("/logout", (r, v) => new LogoutResponder(r));
+            table.Add("/fp-setup", (r, v) => new FpSetupResponder(r));
+            table.Add("/update", (r, v) => new UpdateResponder(r));
+            table.Add("/stream.wav", (r, v) => new AudioStreamResponder(r));
+            table.Add("/stats", (r, v) => new StatsResponder(r));
+
+            table.Add("/databases", (r, v) => new DatabasesResponder(r));
+            table.Add("/databases/{id}/{name}", (r, v) => new DatabaseInstanceResponder(r, v.Id, v.Name, null, null));
+            table.Add("/databases/{id}/{name}/{id}/{name}", (r, v) => new DatabaseInstanceResponder(r, v.Id, v.Name, v.Id2, v.Name2));
+            table.Add("/databases/{id}/{name}/{id}/extra_data/{name}", (r, v) => new DatabaseInstanceResponder(r, v.Id, v.Name, v.Id2, ExtraData(v.Name2)));
+            table.Add("/databases/{id}/browse/{name}", (r, v) => new DatabaseInstanceResponder(r, v.Id, "browse", null, v.Name));
+
+            table.Add("/ctrl-int", (r, v) => new CtrlIntResponder(r));
+            table.Add("/ctrl-int/{id}/{name}", (r, v) => new CtrlIntInstanceResponder(r, v.Id, v.Name));
+
+            return table;
+        }
+
+        // artwork is the only extra_data query remotes send, anything else reaches the responder to be refused there
+        private static string ExtraData(string name)
+        {
+            return name == "artwork" ? "extra_data/artwork" : "extra_data/" + name;
+        }
 
         public static IResponder Map(HttpRequest request)
         {
             if (request == null) return null;
 
-            if (request.Path == "/server-info")
-            {
-                return new ServerInfoResponder(request);
-            }
-            else if (request.Path == "/login")
-            {
-                return new LoginResponder(request);
-            }
-            else if (request.Path == "/logout")
-            {
-                return new LogoutResponder(request);
-            }
-            else if (request.Path == "/fp-setup")
-            {
-                return new FpSetupResponder(request);
-            }
-            else if (request.Path == "/update")
-            {
-                return new UpdateResponder(request);
-            }
-            else if (request.Path == "/databases")
-            {
-                return new DatabasesResponder(request);
-            }
-            else if (request.Path.StartsWith("/databases/"))
-            {
-                return new DatabaseInstanceResponder(request);
-            }
-            else if (request.Path == "/ctrl-int")
-            {
-                return new CtrlIntResponder(request);
-            }
-            else if (request.Path.StartsWith("/ctrl-int/"))
-            {
-                return new CtrlIntInstanceResponder(request);
-            }
-
-            // no handler :(
-            return null;
+            // null when there is no handler
+            return routes.Map(request);
         }
 
     }
@@ -0,0 +1,40 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using TouchRemote.Core.Http;
+using TouchRemote.Core.Http.Response;
+using TouchRemote.Interfaces;
+
+namespace TouchRemote.Core.Dacp.Responders
+{
+
+    /// <summary>
+    /// Answers the /stream.wav requests with the live output as 16-bit PCM, only for paired remotes (session-id required)
+    /// </summary>
+    internal class AudioStreamResponder : SessionBoundResponder
+    {
+
+        public AudioStreamResponder(HttpRequest request) : base(request)
+        {
+        }
+
+        public override bool IsValid
+        {
+            get
+            {
+                var source = Player as IAudioStreamSource;
+                return base.IsValid && source != null && source.IsAudioStreamEnabled;
+            }
+        }
+
+        public override HttpResponse GetResponse()
+        {
+            var stream = ((IAudioStreamSource)Player).OpenAudioStream();
+            if (stream == null)
+                return new ServiceUnavailableResponse(TimeSpan.FromSeconds(10));
+
+            return new WaveStreamResponse(stream);
+        }
+
+    }
+}
@@ -0,0 +1,174 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Net;
+using TouchRemote.Interfaces;
+using TouchRemote.Core.Misc;
+
+namespace TouchRemote.Core.Dacp.Responders
+{
+    internal partial class CtrlIntInstanceResponder
+    {
+
+        /// <summary>
+        /// Serialized play status (cmst) of one Now Playing snapshot, shared by all sessions.
+        /// Only the revision, the database id and the remaining time differ between responses, they are patched into a copy.
+        /// </summary>
+        private sealed class PlayStatus
+        {
+            private static readonly HitCounter cache = Stats.Cache("play status");
+
+            private static PlayStatus current;
+
+            private readonly NowPlaying snapshot;
+            private readonly byte[] data;
+            private readonly int revisionOffset = -1;
+            private readonly int databaseIdOffset = -1;
+            private readonly int remainingOffset = -1;
+
+            public static PlayStatus Get(IPlayer player)
+            {
+                var snapshot = player.NowPlaying;
+
+                // two threads may build the same snapshot at once, either result is fine to keep
+                var status = current;
+                if (status == null || !ReferenceEquals(status.snapshot, snapshot))
+                {
+                    cache.Miss();
+                    status = new PlayStatus(player, snapshot);
+                    current = status;
+                }
+                else
+                    cache.Hit();
+
+                return status;
+            }
+
+            private PlayStatus(IPlayer player, NowPlaying snapshot)
+            {
+                this.snapshot = snapshot;
+
+                data = DataSerializer.Serialize(new
+                {
+                    cmst = Build(player, snapshot)
+                });
+
+                // children of cmst start after its tag and length
+                for (int offset = 8; offset + 8 <= data.Length; )
+                {
+                    var tag = Encoding.ASCII.GetString(data, offset, 4);
+                    var length = ReadInt(data, offset + 4);
+
+                    switch (tag)
+                    {
+                        case "cmsr":
+                            revisionOffset = offset + 8;
+                            break;
+                        case "canp":
+                            databaseIdOffset = offset + 8;
+                            break;
+                        case "cant":
+                            if (!IsLive(snapshot.Track))
+                                remainingOffset = offset + 8;
+                            break;
+                    }
+
+                    offset += 8 + length;
+                }
+            }
+
+            public byte[] Render(uint revision, int databaseId)
+            {
+                var result = (byte[])data.Clone();
+
+                if (revisionOffset >= 0)
+                    WriteInt(result, revisionOffset, unchecked((int)revision));
+
+                if (databaseIdOffset >= 0)
+                    WriteInt(result, databaseIdOffset, databaseId);
+
+                if (remainingOffset >= 0)
+                {
+                    var remaining = snapshot.Track.Duration - snapshot.Position;
+                    if (remaining < TimeSpan.Zero) remaining = TimeSpan.Zero;
+                    WriteInt(result, remainingOffset, unchecked((int)(uint)Math.Round(remaining.TotalMilliseconds)));
+                }
+
+                return result;
+            }
+
+            private static Dictionary<string, object> Build(IPlayer player, NowPlaying snapshot)
+            {
+                var state = new Dictionary<string, object>()
+                {
+                    { "mstt", 200 },
+                    { "cmsr", 0u },                             // patched
+                    { "caps", (byte)snapshot.State },
+                    { "cash", (byte)snapshot.Shuffle },
+                    { "carp", (byte)snapshot.Repeat },
+                    { "cavc", true }, // volume controllable
+                    { "caas", (int)player.AvailableShuffleModes << 1 },
+                    { "caar", (int)player.AvailableRepeatModes << 1 },
+                    { "casu", false },
+                    { "ceGS", false },
+                };
+
+                var track = snapshot.Track;
+
+                if (track != null)
+                {
+                    state["cmmk"] = 1;
+
+                    state["canp"] = new CanpData
+                    {
+                        DatabaseId = 0,                         // patched
+                        ContainerId = snapshot.ContainerId,
+                        ContainerItemId = track.Id,
+                        TrackId = track.Id
+                    }.Data;
+
+                    if (track.Album != null)
+                        state["asai"] = track.Album.PersistentId;
+
+                    state["cann"] = track.Title;
+                    state["cana"] = track.ArtistName;
+                    state["canl"] = track.AlbumName;
+                    state["cang"] = track.GenreName;
+
+                    if (!IsLive(track))
+                    {
+                        state["cast"] = (uint)Math.Round(track.Duration.TotalMilliseconds);
+                        state["cant"] = 0u;                     // patched
+                    }
+                    else
+                        state["cant"] = uint.MaxValue;
+
+                    state["casu"] = true;
+                }
+                state["ceQu"] = false;
+
+                return state;
+            }
+
+            private static bool IsLive(ITrack track)
+            {
+                var liveTrack = track as ILiveTrack;
+                return liveTrack != null && liveTrack.IsLiveStream;
+            }
+
+            private static int ReadInt(byte[] buffer, int offset)
+            {
+                return IPAddress.NetworkToHostOrder(BitConverter.ToInt32(buffer, offset));
+            }
+
+            private static void WriteInt(byte[] buffer, int offset, int value)
+            {
+                buffer[offset + 0] = (byte)((value >> 24) & 0xFF);
+                buffer[offset + 1] = (byte)((value >> 16) & 0xFF);
+                buffer[offset + 2] = (byte)((value >> 8) & 0xFF);
+                buffer[offset + 3] = (byte)(value & 0xFF);
+            }
+        }
+
+    }
+}
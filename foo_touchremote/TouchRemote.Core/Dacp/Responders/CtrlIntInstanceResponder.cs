@@ -22,21 +22,13 @@ namespace TouchRemote.Core.Dacp.Responders
     /// </summary>
     internal partial class CtrlIntInstanceResponder : SessionBoundResponder
     {
-        private static readonly Regex ctrlIntRegex = new Regex(@"^/ctrl-int/(\d+)/([a-z\-]+)$");
-
         private int id;
         private string query;
 
-        public CtrlIntInstanceResponder(HttpRequest request) : base(request)
+        public CtrlIntInstanceResponder(HttpRequest request, int id, string query) : base(request)
         {
-            var match = ctrlIntRegex.Match(request.Path);
-            if (match.Success)
-            {
-                id = int.Parse(match.Groups[1].Value);
-                query = match.Groups[2].Value;
-            }
-            else
-                throw new ArgumentException("Not a valid request for this responder", "request");
+            this.id = id;
+            this.query = query;
         }
 
         public override HttpResponse GetResponse()
@@ -161,117 +153,38 @@ namespace TouchRemote.Core.Dacp.Responders
             uint revisionNumber = 0;
             if (!string.IsNullOrEmpty(revisionStr) && uint.TryParse(revisionStr, out revisionNumber))
             {
-                if (Session.CtrlIntRevision > 0)
+                while (revisionNumber > Session.CtrlIntRevision)
                 {
-                    while (revisionNumber > Session.CtrlIntRevision)
+                    Thread.Sleep(50);
+                    if (!Request.IsClientConnected)
                     {
-                        Thread.Sleep(50);
-                        if (!Request.IsClientConnected)
-                        {
-                            using (Player.BeginRead())
-                                return new DmapResponse(new
+                        using (Player.BeginRead())
+                            return new DmapResponse(new
+                            {
+                                cmst = new
                                 {
-                                    cmst = new
-                                    {
-                                        mstt = 200,
-                                        cmsr = 0,
-                                        caps = (byte)2,                                     // play status
-                                        cash = (byte)Player.CurrentShuffleMode,             // shuffle status
-                                        carp = (byte)Player.CurrentRepeatMode,              // repeat status
-                                        cavc = true,                                        // 
-                                        caas = (int)Player.AvailableShuffleModes << 1,
-                                        caar = (int)Player.AvailableRepeatModes << 1,
-                                        casu = false,
-                                        //ceQu = false,
-                                        //ceMQ = true,
-                                        //ceNQ = 0
-                                    }
-                                });
-                        }
+                                    mstt = 200,
+                                    cmsr = 0,
+                                    caps = (byte)2,                                     // play status
+                                    cash = (byte)Player.CurrentShuffleMode,             // shuffle status
+                                    carp = (byte)Player.CurrentRepeatMode,              // repeat status
+                                    cavc = true,                                        // 
+                                    caas = (int)Player.AvailableShuffleModes << 1,
+                                    caar = (int)Player.AvailableRepeatModes << 1,
+                                    casu = false,
+                                    //ceQu = false,
+                                    //ceMQ = true,
+                                    //ceNQ = 0
+                                }
+                            });
                     }
+                    Session.Touch();
                 }
-                else
-                    Session.CtrlIntRevision = 1;
             }
 
-            using (Player.BeginRead())
-            {
-                var state = new Dictionary<string, object>()
-                {
-                    { "mstt", 200 },
-                    { "cmsr", Session.CtrlIntRevision + 1 },
-                    { "caps", (byte)Player.CurrentState },
-                    { "cash", (byte)Player.CurrentShuffleMode },
-                    { "carp", (byte)Player.CurrentRepeatMode },
-                    { "cavc", true }, // volume controllable
-                    { "caas", (int)Player.AvailableShuffleModes << 1 },
-                    { "caar", (int)Player.AvailableRepeatModes << 1 },
-                    { "casu", false },
-                    { "ceGS", false },
-                    /*
-                    { "cavs", false },
-                    { "cafs", false },
-                    { "cafe", false },
-                    { "cave", false }*/
-                };
-
-                var track = Player.CurrentTrack;
-
-                if (track != null)
-                {
-                    var liveTrack = track as ILiveTrack;
-                    var isLive = liveTrack != null && liveTrack.IsLiveStream;
-
-                    var container = Player.ActivePlaylist ?? Player.MediaLibrary;
-
-                    /*var containerItemId = container.Id;
-                    var trackList = container.Tracks as IList<ITrack>;
-                    if (trackList != null)
-                        containerItemId = container.Id + 1 + trackList.IndexOf(track);*/
-
-                    state["cmmk"] = 1;
-
-                    state["canp"] = new CanpData
-                    {
-                        DatabaseId = id,
-                        ContainerId = container.Id,
-                        ContainerItemId = track.Id,
-                        TrackId = track.Id
-                    }.Data;
-
-                    if (track.Album != null)
-                        state["asai"] = track.Album.PersistentId;
-
-                    if (!isLive)
-                    {
-                        state["cann"] = track.Title;
-                        state["cana"] = track.ArtistName;
-                        state["canl"] = track.AlbumName;
-                        state["cang"] = track.GenreName;
-                        state["cast"] = (uint)Math.Round(track.Duration.TotalMilliseconds);
-                        state["cant"] = (uint)Math.Round((track.Duration - Player.CurrentPosition).TotalMilliseconds);
-                    }
-                    else
-                    {
-                        state["cann"] = track.Title;
-                        state["cana"] = track.ArtistName;
-                        state["canl"] = track.AlbumName;
-                        state["cang"] = track.GenreName;
-                        state["cant"] = uint.MaxValue;
-                    }
-
-
-                    state["casu"] = true;
-                    //state["ceMQ"] = false;
-                    //state["ceNQ"] = 0;
-                }
-                state["ceQu"] = false;
-
-                return new DmapResponse(new
-                {
-                    cmst = state
-                });
-            }
+            // one reference read, the body is serialized once per snapshot
+            var status = PlayStatus.Get(Player);
+            return new DmapResponse(status.Render(Session.CtrlIntRevision + 1, id));
         }
 
         private HttpResponse CueResponse()
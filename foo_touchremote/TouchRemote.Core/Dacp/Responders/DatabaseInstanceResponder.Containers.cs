@@ -87,6 +87,47 @@ namespace TouchRemote.Core.Dacp.Responders
             };*/
         }
 
+        // Changes since the revision the client passed as delta=, or null when a full listing has to be sent
+        private ChangeSet GetDeltaChanges()
+        {
+            uint delta;
+            if (!uint.TryParse(Request.QueryString["delta"], out delta) || delta == 0)
+                return null;
+
+            // clients are told DatabaseRevision + 1 by /update, which is never ahead of the journal revision
+            return ChangeJournal.GetChanges(delta - 1);
+        }
+
+        // changed tracks still listed go to mlcl, everything else the client may hold to mudl
+        private HttpResponse TrackDeltaResponse(IEnumerable<ITrack> tracks, ChangeSet changes)
+        {
+            var items = new ArrayList();
+            var listed = new HashSet<int>();
+
+            foreach (var t in tracks)
+            {
+                var trackId = t.Id;
+                if (changes.ChangedItems.Contains(trackId) && listed.Add(trackId))
+                    items.Add(GetTrackItem(t, 0));
+            }
+
+            var deleted = new MultiValueTag();
+            foreach (var trackId in changes.ChangedItems.Concat(changes.RemovedItems))
+                if (!listed.Contains(trackId))
+                    deleted.Add("miid", trackId);
+
+            return new DmapResponse(new
+            {
+                apso = new
+                {
+                    mstt = 200,
+                    muty = (byte)1,
+                    mlcl = items,
+                    mudl = deleted
+                }
+            });
+        }
+
         #endregion
 
         private HttpResponse GetContainersResponse()
@@ -110,6 +151,7 @@ namespace TouchRemote.Core.Dacp.Responders
         private HttpResponse Containers()
         {
             var items = new ArrayList(10);
+            var containers = new List<IPlaylist>();
 
             using (Player.MediaLibrary.BeginRead())
             {
@@ -117,16 +159,23 @@ namespace TouchRemote.Core.Dacp.Responders
 
                 if (!Session.GuestMode)
                 {
-                    items.AddRange(Player.GetContainers().Select(x => GetPlaylistItem(x, mlib.Id)).ToArray());
+                    containers.AddRange(Player.GetContainers());
                 }
                 else
                 {
-                    //items.Add(GetPlaylistItem(mlib, 0));
+                    //containers.Add(mlib);
                     if (mlib.Music != null)
-                        items.Add(GetPlaylistItem(mlib.Music, mlib.Id));
+                        containers.Add(mlib.Music);
                     if (mlib.Jukebox != null)
-                        items.Add(GetPlaylistItem(mlib.Jukebox, mlib.Id));
+                        containers.Add(mlib.Jukebox);
                 }
+
+                // read after the containers, which may have recorded changes while being rebuilt
+                var changes = GetDeltaChanges();
+                if (changes != null)
+                    return ContainersDelta(containers, changes, mlib.Id);
+
+                items.AddRange(containers.Select(x => GetPlaylistItem(x, mlib.Id)).ToArray());
             }
 
             return new DmapResponse(new
@@ -140,6 +189,38 @@ namespace TouchRemote.Core.Dacp.Responders
             });
         }
 
+        private HttpResponse ContainersDelta(List<IPlaylist> containers, ChangeSet changes, int libraryId)
+        {
+            var items = new ArrayList();
+            var listed = new HashSet<int>();
+
+            foreach (var p in containers)
+            {
+                var containerId = p.Id;
+
+                // track counts of the library playlists follow every library change
+                var changed = changes.ChangedContainers.Contains(containerId) || (p.Type != PlaylistType.None && changes.HasItemChanges);
+                if (changed && listed.Add(containerId))
+                    items.Add(GetPlaylistItem(p, libraryId));
+            }
+
+            var deleted = new MultiValueTag();
+            foreach (var containerId in changes.ChangedContainers.Concat(changes.RemovedContainers))
+                if (!listed.Contains(containerId))
+                    deleted.Add("miid", containerId);
+
+            return new DmapResponse(new
+            {
+                aply = new
+                {
+                    mstt = 200,
+                    muty = (byte)1,
+                    mlcl = items,
+                    mudl = deleted
+                }
+            });
+        }
+
         private HttpResponse LibraryItems()
         {
             var filter = new FilterExpression<ITrack>(Request.QueryString["query"]);
@@ -148,6 +229,10 @@ namespace TouchRemote.Core.Dacp.Responders
 
             using (Player.MediaLibrary.BeginRead())
             {
+                var changes = GetDeltaChanges();
+                if (changes != null)
+                    return TrackDeltaResponse(filter.Filter(Player.MediaLibrary.Tracks), changes);
+
                 var rawItems = sort.Sort(filter.Filter(Player.MediaLibrary.Tracks));
 
                 Func<ITrack, string> selector;
@@ -213,6 +298,11 @@ namespace TouchRemote.Core.Dacp.Responders
                     {
                         var rawItems = filter.Filter(pl.Tracks);
 
+                        // a playlist whose tracks were added, removed or moved is sent in full
+                        var changes = GetDeltaChanges();
+                        if (changes != null && !changes.RestructuredContainers.Contains(pl.Id) && !changes.RemovedContainers.Contains(pl.Id))
+                            return TrackDeltaResponse(rawItems, changes);
+
                         var items = rawItems.Select<ITrack, object>(GetTrackItem).ToArray();
 
                         return new DmapResponse(new
@@ -19,39 +19,17 @@ namespace TouchRemote.Core.Dacp.Responders
 {
     internal partial class DatabaseInstanceResponder : SessionBoundResponder
     {
-        private static readonly Regex databaseRegex = new Regex(@"^/databases/(\d+)/([a-z]+)(/(\d+)/((extra_data/)?[a-z]+))?$");
-        private static readonly Regex databaseRegex2 = new Regex(@"^/databases/(\d+)/browse/([a-z]+)$");
-
         private int id;
         private string query;
         private int? id2;
         private string query2;
 
-        public DatabaseInstanceResponder(HttpRequest request) : base(request)
+        public DatabaseInstanceResponder(HttpRequest request, int id, string query, int? id2, string query2) : base(request)
         {
-            var match = databaseRegex.Match(request.Path);
-            if (match.Success)
-            {
-                id = int.Parse(match.Groups[1].Value);
-                query = match.Groups[2].Value;
-                if (match.Groups[3].Success)
-                {
-                    id2 = int.Parse(match.Groups[4].Value);
-                    query2 = match.Groups[5].Value;
-                }
-            }
-            else
-            {
-                match = databaseRegex2.Match(request.Path);
-                if (match.Success)
-                {
-                    id = int.Parse(match.Groups[1].Value);
-                    query = "browse";
-                    query2 = match.Groups[2].Value;
-                }
-                else
-                    throw new ArgumentException("Not a valid request for this responder", "request");
-            }
+            this.id = id;
+            this.query = query;
+            this.id2 = id2;
+            this.query2 = query2;
         }
 
         public override HttpResponse GetResponse()
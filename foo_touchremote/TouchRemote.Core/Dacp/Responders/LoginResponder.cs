@@ -50,16 +50,14 @@ namespace TouchRemote.Core.Dacp.Responders
                 return new NotFoundResponse();
             }
 
-            int sessionId = Math.Abs(unchecked((int)~DateTime.UtcNow.ToUnixTime()));
-
-            SessionManager.StartSession(sessionId, guestMode);
+            var session = SessionManager.StartSession(guestMode);
 
             return new DmapResponse(new
             {
                 mlog = new
                 {
                     mstt = 200,
-                    mlid = sessionId
+                    mlid = session.SessionId
                 }
             });
         }
@@ -0,0 +1,38 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using TouchRemote.Core.Http;
+using TouchRemote.Core.Http.Response;
+using TouchRemote.Core.Misc;
+
+namespace TouchRemote.Core.Dacp.Responders
+{
+
+    /// <summary>
+    /// Answers the /stats requests with the performance counters, as text or with format=json as JSON,
+    /// only for paired remotes (session-id required). reset=1 on a POST clears the counters after rendering them.
+    /// </summary>
+    internal class StatsResponder : SessionBoundResponder
+    {
+
+        public StatsResponder(HttpRequest request) : base(request)
+        {
+        }
+
+        public override HttpResponse GetResponse()
+        {
+            HttpResponse response;
+
+            if (string.Equals(Request.QueryString["format"], "json", StringComparison.OrdinalIgnoreCase))
+                response = new TextResponse(Stats.ToJson(), "application/json");
+            else
+                response = new TextResponse(Stats.ToText(), "text/plain");
+
+            // a GET must not change anything, prefetching or retrying clients would wipe the counters
+            if (Request.Method == "POST" && Request.QueryString["reset"] == "1")
+                Stats.Reset();
+
+            return response;
+        }
+    }
+}
@@ -16,26 +16,22 @@ namespace TouchRemote.Core.Dacp.Responders
             uint revisionNumber = 0;
             if (!string.IsNullOrEmpty(revisionStr) && uint.TryParse(revisionStr, out revisionNumber))
             {
-                if (Session.DatabaseRevision > 0)
+                while (revisionNumber > Session.DatabaseRevision)
                 {
-                    while (revisionNumber > Session.DatabaseRevision)
+                    Thread.Sleep(50);
+                    if (!Request.IsClientConnected)
                     {
-                        Thread.Sleep(50);
-                        if (!Request.IsClientConnected)
+                        return new DmapResponse(new
                         {
-                            return new DmapResponse(new
+                            mupd = new
                             {
-                                mupd = new
-                                {
-                                    mstt = 200,
-                                    musr = 0
-                                }
-                            });
-                        }
+                                mstt = 200,
+                                musr = 0
+                            }
+                        });
                     }
+                    Session.Touch();
                 }
-                else
-                    Session.DatabaseRevision = 1;
             }
 
             return new DmapResponse(new
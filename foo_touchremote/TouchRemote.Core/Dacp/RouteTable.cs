@@ -0,0 +1,244 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using TouchRemote.Core.Dacp.Responders;
+using TouchRemote.Core.Http;
+using TouchRemote.Core.Misc;
+
+namespace TouchRemote.Core.Dacp
+{
+    /// <summary>
+    /// Values captured by the {id} and {name} segments of a route, in order of appearance
+    /// </summary>
+    internal struct RouteValues
+    {
+        public int Id;
+        public int Id2;
+        public string Name;
+        public string Name2;
+
+        internal int IdCount;
+        internal int NameCount;
+    }
+
+    internal delegate IResponder RouteHandler(HttpRequest request, RouteValues values);
+
+    /// <summary>
+    /// Maps request paths to responders with a segment trie built once at startup.
+    ///
+    /// Patterns are made of literal segments, {id} (decimal number) and {name} (lowercase word with '-' or '_'),
+    /// with at most two of each. Matching walks the path once, literal segments taking precedence over {id}
+    /// and {name}, and does not allocate: numbers are parsed in place and captured names come from a small
+    /// cache of strings seen before.
+    ///
+    /// Every route has its own latency histogram, handed to the request for the connection to record into.
+    /// </summary>
+    internal sealed class RouteTable
+    {
+        private const int NameCacheSize = 256;
+        private const int NameCacheProbes = 4;
+        private const int MaxCachedNameLength = 32;
+
+        private sealed class Node
+        {
+            public string Literal;
+            public Node[] Literals = new Node[0];
+            public Node Number;
+            public Node Name;
+            public RouteHandler Handler;
+            public Histogram Latency;
+        }
+
+        private static readonly HitCounter nameCache = Stats.Cache("route names");
+
+        private readonly Node root = new Node();
+        private readonly string[] names = new string[NameCacheSize];
+
+        public void Add(string pattern, RouteHandler handler)
+        {
+            if (string.IsNullOrEmpty(pattern) || pattern[0] != '/')
+                throw new ArgumentException("Pattern must start with '/'", "pattern");
+            if (handler == null)
+                throw new ArgumentNullException("handler");
+
+            var node = root;
+            int idCount = 0, nameCount = 0;
+
+            foreach (var segment in pattern.Substring(1).Split('/'))
+            {
+                if (segment == "{id}")
+                {
+                    if (++idCount > 2)
+                        throw new ArgumentException("Too many {id} segments", "pattern");
+                    node = node.Number ?? (node.Number = new Node());
+                }
+                else if (segment == "{name}")
+                {
+                    if (++nameCount > 2)
+                        throw new ArgumentException("Too many {name} segments", "pattern");
+                    node = node.Name ?? (node.Name = new Node());
+                }
+                else
+                {
+                    node = GetLiteral(node, segment);
+                }
+            }
+
+            if (node.Handler != null)
+                throw new ArgumentException("Duplicate route " + pattern, "pattern");
+
+            node.Handler = handler;
+            node.Latency = Stats.Latency("http " + pattern);
+        }
+
+        public IResponder Map(HttpRequest request)
+        {
+            var path = request.Path;
+            if (string.IsNullOrEmpty(path) || path[0] != '/') return null;
+
+            var values = new RouteValues();
+            var node = Match(root, path, 1, ref values);
+            if (node == null) return null;
+
+            request.RouteLatency = node.Latency;
+            return node.Handler(request, values);
+        }
+
+        private static Node GetLiteral(Node parent, string literal)
+        {
+            foreach (var child in parent.Literals)
+                if (child.Literal == literal) return child;
+
+            var node = new Node { Literal = string.Intern(literal) };
+
+            var literals = new Node[parent.Literals.Length + 1];
+            parent.Literals.CopyTo(literals, 0);
+            literals[literals.Length - 1] = node;
+            parent.Literals = literals;
+
+            return node;
+        }
+
+        private Node Match(Node node, string path, int start, ref RouteValues values)
+        {
+            int end = path.IndexOf('/', start);
+            if (end < 0) end = path.Length;
+            int length = end - start;
+
+            Node next;
+
+            foreach (var child in node.Literals)
+            {
+                if (child.Literal.Length == length && string.CompareOrdinal(child.Literal, 0, path, start, length) == 0)
+                {
+                    next = Continue(child, path, end, ref values);
+                    if (next != null) return next;
+                    break;
+                }
+            }
+
+            int number;
+            if (node.Number != null && TryParseNumber(path, start, length, out number))
+            {
+                var saved = values;
+                if (values.IdCount++ == 0) values.Id = number;
+                else values.Id2 = number;
+
+                next = Continue(node.Number, path, end, ref values);
+                if (next != null) return next;
+                values = saved;
+            }
+
+            if (node.Name != null && IsName(path, start, length))
+            {
+                var saved = values;
+                var name = GetName(path, start, length);
+                if (values.NameCount++ == 0) values.Name = name;
+                else values.Name2 = name;
+
+                next = Continue(node.Name, path, end, ref values);
+                if (next != null) return next;
+                values = saved;
+            }
+
+            return null;
+        }
+
+        private Node Continue(Node node, string path, int end, ref RouteValues values)
+        {
+            if (end == path.Length)
+                return node.Handler != null ? node : null;
+
+            return Match(node, path, end + 1, ref values);
+        }
+
+        private static bool TryParseNumber(string path, int start, int length, out int number)
+        {
+            number = 0;
+            if (length == 0 || length > 10) return false;
+
+            long value = 0;
+            for (int i = start; i < start + length; i++)
+            {
+                char c = path[i];
+                if (c < '0' || c > '9') return false;
+                value = value * 10 + (c - '0');
+            }
+
+            if (value > int.MaxValue) return false;
+
+            number = (int)value;
+            return true;
+        }
+
+        private static bool IsName(string path, int start, int length)
+        {
+            if (length == 0) return false;
+
+            for (int i = start; i < start + length; i++)
+            {
+                char c = path[i];
+                if ((c < 'a' || c > 'z') && c != '-' && c != '_') return false;
+            }
+
+            return true;
+        }
+
+        // Remotes only ever send a few dozen distinct command names, so after warm-up every lookup is a hit.
+        // Slots are plain reference writes; two threads racing for one slot only cost a cache miss later.
+        private string GetName(string path, int start, int length)
+        {
+            int hash = length;
+            for (int i = start; i < start + length; i++)
+                hash = hash * 31 + path[i];
+
+            int slot = hash & (NameCacheSize - 1);
+            int free = -1;
+
+            for (int probe = 0; probe < NameCacheProbes; probe++)
+            {
+                int index = (slot + probe) & (NameCacheSize - 1);
+                var cached = names[index];
+                if (cached == null)
+                {
+                    free = index;
+                    break;
+                }
+                if (cached.Length == length && string.CompareOrdinal(cached, 0, path, start, length) == 0)
+                {
+                    nameCache.Hit();
+                    return cached;
+                }
+            }
+
+            nameCache.Miss();
+
+            var name = path.Substring(start, length);
+            if (free >= 0 && length <= MaxCachedNameLength)
+                names[free] = name;
+
+            return name;
+        }
+
+    }
+}
@@ -6,6 +6,7 @@ using System.Text.RegularExpressions;
 using System.Linq.Expressions;
 using System.Globalization;
 using System.Linq.Dynamic;
+using TouchRemote.Interfaces;
 
 namespace TouchRemote.Core.Filter
 {
@@ -15,6 +16,7 @@ namespace TouchRemote.Core.Filter
         private static CompareInfo compareInfo = CultureInfo.InvariantCulture.CompareInfo;
         private const CompareOptions compareOpts = CompareOptions.IgnoreCase | CompareOptions.IgnoreKanaType | CompareOptions.IgnoreNonSpace | CompareOptions.IgnoreWidth;
         private readonly Expression<Func<T, bool>> predicate;
+        private readonly SubstringTerms<T> terms;
 
         public FilterExpression(string filter)
         {
@@ -24,6 +26,8 @@ namespace TouchRemote.Core.Filter
                 return;
             }
 
+            terms = new SubstringTerms<T>(compareInfo, compareOpts);
+
             var output = replaceRegex.Replace(filter, (MatchEvaluator)delegate(Match m)
             {
                 StringBuilder b = new StringBuilder(m.Length);
@@ -44,6 +48,7 @@ namespace TouchRemote.Core.Filter
                 var value = m.Groups["value"].Value;
 
                 value = value.Replace("\\'", "'");
+                var text = value;
                 if (replacement.NeedQuotes)
                     value = value.Replace("\"", "\\\"");
 
@@ -62,7 +67,15 @@ namespace TouchRemote.Core.Filter
                 }
                 else if (value.StartsWith("*"))
                 {
-                    if (value.EndsWith("*"))
+                    if (value.EndsWith("*") && replacement.Property != null && text.Length > 2)
+                    {
+                        // looked up in the source's substring index when it has one, see Filter()
+                        var term = terms.Add(replacement.Property, text.Substring(1, text.Length - 2));
+
+                        if (not) b.Append('!');
+                        b.Append("@2.IsMatch(").Append(term).Append(", it, ").Append(prop).Append(")");
+                    }
+                    else if (value.EndsWith("*"))
                     {
                         value = value.Substring(1, value.Length - 2);
 
@@ -99,7 +112,7 @@ namespace TouchRemote.Core.Filter
 
             FilterString = output;
 
-            predicate = System.Linq.Dynamic.DynamicExpression.ParseLambda<T, bool>(output, compareInfo, compareOpts);
+            predicate = System.Linq.Dynamic.DynamicExpression.ParseLambda<T, bool>(output, compareInfo, compareOpts, terms);
         }
 
         public string FilterString { get; private set; }
@@ -108,6 +121,17 @@ namespace TouchRemote.Core.Filter
         {
             if (source == null || predicate == null) return source;
 
+            var searchable = source as ISearchableTrackCollection;
+            if (searchable != null && terms.Count > 0)
+            {
+                // the predicate is parsed again around terms answered by the index, and only the items
+                // the index leaves over are tested
+                var bound = terms.Bind(searchable);
+                var indexed = System.Linq.Dynamic.DynamicExpression.ParseLambda<T, bool>(FilterString, compareInfo, compareOpts, bound);
+
+                return (bound.Narrow(indexed.Body) ?? source).AsQueryable().Where(indexed);
+            }
+
             return source.AsQueryable().Where(predicate);
         }
 
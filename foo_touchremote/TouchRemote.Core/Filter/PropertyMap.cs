@@ -8,28 +8,37 @@ namespace TouchRemote.Core.Filter
     internal sealed class TypeHintedReplacement
     {
         public TypeHintedReplacement(string name, bool needQuotes)
+            : this(name, needQuotes, null)
+        {
+        }
+
+        public TypeHintedReplacement(string name, bool needQuotes, string property)
         {
             Name = name;
             NeedQuotes = needQuotes;
+            Property = property;
         }
 
         public string Name { get; set; }
         public bool NeedQuotes { get; set; }
+
+        // ITrack property behind a text replacement, for ISearchableTrackCollection.FindContaining
+        public string Property { get; set; }
     }
 
     internal static class PropertyMap
     {
         private static Dictionary<string, TypeHintedReplacement> m_replacements = new Dictionary<string, TypeHintedReplacement>(StringComparer.OrdinalIgnoreCase) {
             { "dmap.itemid", new TypeHintedReplacement("Id", false) },
-            { "dmap.itemname", new TypeHintedReplacement("iif(Title != null, Title, \"\")", true) },
+            { "dmap.itemname", new TypeHintedReplacement("iif(Title != null, Title, \"\")", true, "Title") },
             { "dmap.containeritemid", new TypeHintedReplacement("Id", false) },
-            { "daap.songalbum", new TypeHintedReplacement("iif(AlbumName != null, AlbumName, \"\")", true) },
+            { "daap.songalbum", new TypeHintedReplacement("iif(AlbumName != null, AlbumName, \"\")", true, "AlbumName") },
             { "daap.songalbumid", new TypeHintedReplacement("iif(Album != null, Album.PersistentId, 0)", false) },
-            { "daap.songartist", new TypeHintedReplacement("iif(ArtistName != null, ArtistName, \"\")", true) },
+            { "daap.songartist", new TypeHintedReplacement("iif(ArtistName != null, ArtistName, \"\")", true, "ArtistName") },
             { "daap.songartistid", new TypeHintedReplacement("iif(AlbumArtist != null, AlbumArtist.PersistentId, 0)", false) },
-            { "daap.songalbumartist", new TypeHintedReplacement("iif(AlbumArtistName != null, AlbumArtistName, \"\")", true) },
-            { "daap.songgenre", new TypeHintedReplacement("iif(GenreName != null, GenreName, \"\")", true) },
-            { "daap.songcomposer", new TypeHintedReplacement("iif(ComposerName != null, ComposerName, \"\")", true) },
+            { "daap.songalbumartist", new TypeHintedReplacement("iif(AlbumArtistName != null, AlbumArtistName, \"\")", true, "AlbumArtistName") },
+            { "daap.songgenre", new TypeHintedReplacement("iif(GenreName != null, GenreName, \"\")", true, "GenreName") },
+            { "daap.songcomposer", new TypeHintedReplacement("iif(ComposerName != null, ComposerName, \"\")", true, "ComposerName") },
             { "com.apple.itunes.mediakind", new TypeHintedReplacement("Kind", false) },
 
             // ...
@@ -0,0 +1,152 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Runtime.CompilerServices;
+using System.Text;
+using System.Globalization;
+using TouchRemote.Interfaces;
+using TouchRemote.Core.Misc;
+
+namespace TouchRemote.Core.Filter
+{
+    /// <summary>
+    /// The '*value*' terms of one filter. Bound to an <see cref="ISearchableTrackCollection"/>, each term is looked up
+    /// in the collection's substring index once and filtering only tests set membership; the term sets also tell
+    /// which items can match at all (<see cref="Narrow"/>). Unbound, or for properties the collection does not index,
+    /// terms compare the text like the other filter operators do.
+    /// </summary>
+    /// <remarks>
+    /// Public so filter expressions can call <see cref="IsMatch"/> as @2. Must not implement IEnumerable,
+    /// Dynamic LINQ would treat calls on it as aggregates.
+    /// </remarks>
+    public sealed class SubstringTerms<T>
+    {
+        private static readonly Histogram lookupLatency = Stats.Latency("filter index lookup");
+
+        private readonly List<KeyValuePair<string, string>> terms;
+        private readonly CompareInfo compareInfo;
+        private readonly CompareOptions compareOptions;
+        private readonly HashSet<T>[] matches;
+
+        internal SubstringTerms(CompareInfo compareInfo, CompareOptions compareOptions)
+        {
+            this.terms = new List<KeyValuePair<string, string>>();
+            this.compareInfo = compareInfo;
+            this.compareOptions = compareOptions;
+            this.matches = null;
+        }
+
+        private SubstringTerms(SubstringTerms<T> unbound, ISearchableTrackCollection source)
+        {
+            terms = unbound.terms;
+            compareInfo = unbound.compareInfo;
+            compareOptions = unbound.compareOptions;
+            matches = new HashSet<T>[terms.Count];
+
+            var start = Histogram.Start();
+
+            for (int i = 0; i < terms.Count; i++)
+            {
+                var found = source.FindContaining(terms[i].Key, terms[i].Value) as IEnumerable<T>;
+                if (found != null)
+                    matches[i] = new HashSet<T>(found, ReferenceComparer.Instance);
+            }
+
+            lookupLatency.Stop(start);
+        }
+
+        internal int Count
+        {
+            get { return terms.Count; }
+        }
+
+        // returns the index to pass to IsMatch
+        internal int Add(string property, string value)
+        {
+            terms.Add(new KeyValuePair<string, string>(property, value));
+            return terms.Count - 1;
+        }
+
+        internal SubstringTerms<T> Bind(ISearchableTrackCollection source)
+        {
+            return new SubstringTerms<T>(this, source);
+        }
+
+        public bool IsMatch(int term, T item, string text)
+        {
+            var set = (matches != null) ? matches[term] : null;
+            if (set != null)
+                return set.Contains(item);
+
+            return compareInfo.IndexOf(text, terms[term].Value, compareOptions) >= 0;
+        }
+
+        /// <summary>
+        /// Items a predicate built on these terms can possibly accept, or null when it may accept any item.
+        /// Terms joined by 'and' need the smallest of their sets, terms joined by 'or' the union of all.
+        /// </summary>
+        internal ICollection<T> Narrow(Expression body)
+        {
+            if (matches == null) return null;
+
+            switch (body.NodeType)
+            {
+                case ExpressionType.AndAlso:
+                    {
+                        var binary = (BinaryExpression)body;
+                        var left = Narrow(binary.Left);
+                        var right = Narrow(binary.Right);
+                        if (left == null) return right;
+                        if (right == null) return left;
+                        return (left.Count <= right.Count) ? left : right;
+                    }
+
+                case ExpressionType.OrElse:
+                    {
+                        var binary = (BinaryExpression)body;
+                        var left = Narrow(binary.Left);
+                        if (left == null) return null;
+                        var right = Narrow(binary.Right);
+                        if (right == null) return null;
+
+                        var union = new HashSet<T>(left, ReferenceComparer.Instance);
+                        union.UnionWith(right);
+                        return union;
+                    }
+
+                case ExpressionType.Call:
+                    {
+                        var call = (MethodCallExpression)body;
+                        var instance = call.Object as ConstantExpression;
+                        if (instance == null || !ReferenceEquals(instance.Value, this) || call.Method.Name != "IsMatch") return null;
+
+                        var term = call.Arguments[0] as ConstantExpression;
+                        if (term == null) return null;
+
+                        return matches[(int)term.Value];
+                    }
+
+                default:
+                    return null;
+            }
+        }
+
+        // the sets hold the collection's own track objects, identity is all that matters and is much cheaper
+        // to hash than the tracks' sources
+        private sealed class ReferenceComparer : IEqualityComparer<T>
+        {
+            public static readonly ReferenceComparer Instance = new ReferenceComparer();
+
+            public bool Equals(T x, T y)
+            {
+                return ReferenceEquals(x, y);
+            }
+
+            public int GetHashCode(T obj)
+            {
+                return RuntimeHelpers.GetHashCode(obj);
+            }
+        }
+    }
+}
@@ -11,11 +11,14 @@ using TouchRemote.Core.Http.Response;
 using System.Diagnostics;
 using System.Threading;
 using System.Net;
+using TouchRemote.Core.Misc;
 
 namespace TouchRemote.Core.Http
 {
     public class HttpConnection
     {
+        private static readonly Histogram unrouted = Stats.Latency("http (no route)");
+
         private readonly HttpServer server;
         private readonly Socket client;
 
@@ -32,6 +35,18 @@ namespace TouchRemote.Core.Http
 
         internal HttpServer Server { get { return server; } }
 
+        // like IsClientConnected, but a full send buffer is not taken for a disconnect
+        internal bool IsStreamOpen
+        {
+            get { return server.IsRunning && !server.IsStopping && client.Connected; }
+        }
+
+        internal int SendTimeout
+        {
+            get { return client.SendTimeout; }
+            set { client.SendTimeout = value; }
+        }
+
         public void Work()
         {
             var handler = server.RequestHandler;
@@ -134,6 +149,7 @@ namespace TouchRemote.Core.Http
 
                         var request = new HttpRequest((IPEndPoint)client.RemoteEndPoint, method, path, protocol, version, headers, postData, this);
                         HttpResponse response;
+                        var start = Histogram.Start();
 
                         try
                         {
@@ -147,7 +163,11 @@ namespace TouchRemote.Core.Http
 
                         SendResponse(response);
 
-                        if (response.Code >= 500) break;
+                        // streams last as long as the client listens, their time says nothing
+                        if (!(response is StreamingHttpResponse))
+                            (request.RouteLatency ?? unrouted).Stop(start);
+
+                        if (response.Code >= 500 || response is StreamingHttpResponse) break;
                         
                         if (string.Equals(headers["Connection"], "close", StringComparison.OrdinalIgnoreCase)) break;
 
@@ -206,6 +226,13 @@ namespace TouchRemote.Core.Http
             client.Send(data);
         }
 
+        internal void Send(byte[] data, int offset, int count)
+        {
+            if (data == null || count == 0) return;
+
+            client.Send(data, offset, count, SocketFlags.None);
+        }
+
         internal void Send(Encoding encoding, string data)
         {
             Send((encoding ?? Encoding.UTF8).GetBytes(data));
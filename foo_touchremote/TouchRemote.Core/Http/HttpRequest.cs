@@ -25,6 +25,9 @@ namespace TouchRemote.Core.Http
 
         public byte[] PostData { get; private set; }
 
+        // set by the route that serves the request, the connection records the response time into it
+        internal Misc.Histogram RouteLatency { get; set; }
+
         private readonly HttpConnection m_connection;
 
         internal HttpRequest(IPEndPoint client, string method, string path, string protocol, string version, NameValueCollection headers, byte[] postData, HttpConnection connection)
@@ -39,7 +39,14 @@ namespace TouchRemote.Core.Http
             ServerContext = connection.Server;
 
             byte[] data = null;
-            if (Code < 200 || Code == 204 || Code == 304)
+            var streaming = this as StreamingHttpResponse;
+            if (streaming != null)
+            {
+                // no length known up front, the body ends when the connection closes
+                Headers.Remove("Content-Length");
+                Headers["Connection"] = "close";
+            }
+            else if (Code < 200 || Code == 204 || Code == 304)
             {
                 Headers.Remove("Content-Type");
                 Headers["Content-Length"] = "0";
@@ -62,7 +69,11 @@ namespace TouchRemote.Core.Http
             hdrBuffer.Append("\r\n");
 
             connection.Send(Encoding.ASCII, hdrBuffer.ToString());
-            connection.Send(data);
+
+            if (streaming != null)
+                streaming.WriteBody(connection);
+            else
+                connection.Send(data);
         }
 
         protected abstract byte[] GetData();
@@ -84,4 +95,16 @@ namespace TouchRemote.Core.Http
         }
 
     }
+
+    public abstract class StreamingHttpResponse : HttpResponse
+    {
+
+        protected sealed override byte[] GetData()
+        {
+            return null;
+        }
+
+        protected internal abstract void WriteBody(HttpConnection connection);
+
+    }
 }
@@ -0,0 +1,23 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace TouchRemote.Core.Http.Response
+{
+    public sealed class ServiceUnavailableResponse : TextHttpResponse
+    {
+
+        public ServiceUnavailableResponse(TimeSpan retryAfter)
+        {
+            Code = 503;
+            Reason = "Service Unavailable";
+            Headers["Retry-After"] = Math.Max(1, (int)Math.Ceiling(retryAfter.TotalSeconds)).ToString();
+        }
+
+        protected override string GetText()
+        {
+            return Reason;
+        }
+
+    }
+}
@@ -0,0 +1,25 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace TouchRemote.Core.Http.Response
+{
+    public sealed class TextResponse : TextHttpResponse
+    {
+        public string Text { get; private set; }
+
+        public TextResponse(string text, string contentType)
+        {
+            Code = 200;
+            Reason = "OK";
+            Headers["Content-Type"] = contentType + "; charset=utf-8";
+            Headers["Cache-Control"] = "no-cache";
+            Text = text;
+        }
+
+        protected override string GetText()
+        {
+            return Text;
+        }
+    }
+}
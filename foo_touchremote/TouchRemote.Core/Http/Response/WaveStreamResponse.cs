@@ -0,0 +1,102 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.IO;
+using System.Net.Sockets;
+using TouchRemote.Interfaces;
+
+namespace TouchRemote.Core.Http.Response
+{
+    public sealed class WaveStreamResponse : StreamingHttpResponse
+    {
+        private static readonly TimeSpan PollInterval = TimeSpan.FromMilliseconds(250);
+
+        // a listener that does not take any data for this long is disconnected
+        private const int SendTimeout = 10000;
+
+        private readonly IAudioStream stream;
+
+        public WaveStreamResponse(IAudioStream stream)
+        {
+            if (stream == null)
+                throw new ArgumentNullException("stream");
+
+            this.stream = stream;
+
+            Code = 200;
+            Reason = "OK";
+            Headers["Content-Type"] = "audio/wav";
+            Headers["Cache-Control"] = "no-cache";
+        }
+
+        protected internal override void WriteBody(HttpConnection connection)
+        {
+            try
+            {
+                // while Send() blocks on a slow listener, its reader falls behind and skips ahead on its own
+                connection.SendTimeout = SendTimeout;
+
+                var buffer = new byte[64 * 1024];
+
+                // the WAV header needs the format, which is known once the first audio arrives
+                int read;
+                do
+                {
+                    read = stream.Read(buffer, 0, buffer.Length, PollInterval);
+                }
+                while (read == 0 && connection.IsStreamOpen);
+
+                if (read <= 0) return;
+
+                var header = GetHeader();
+                connection.Send(header, 0, header.Length);
+
+                while (read >= 0 && connection.IsStreamOpen)
+                {
+                    if (read > 0)
+                        connection.Send(buffer, 0, read);
+
+                    read = stream.Read(buffer, 0, buffer.Length, PollInterval);
+                }
+            }
+            catch (SocketException)
+            {
+                // listener went away
+            }
+            finally
+            {
+                stream.Dispose();
+            }
+        }
+
+        private byte[] GetHeader()
+        {
+            int blockAlign = stream.Channels * stream.BitsPerSample / 8;
+
+            using (var data = new MemoryStream(44))
+            using (var writer = new BinaryWriter(data))
+            {
+                // sizes are unknown for a live stream, players accept the maximum
+                writer.Write(Encoding.ASCII.GetBytes("RIFF"));
+                writer.Write(uint.MaxValue);
+                writer.Write(Encoding.ASCII.GetBytes("WAVE"));
+
+                writer.Write(Encoding.ASCII.GetBytes("fmt "));
+                writer.Write(16);
+                writer.Write((short)1);
+                writer.Write((short)stream.Channels);
+                writer.Write(stream.SampleRate);
+                writer.Write(stream.SampleRate * blockAlign);
+                writer.Write((short)blockAlign);
+                writer.Write((short)stream.BitsPerSample);
+
+                writer.Write(Encoding.ASCII.GetBytes("data"));
+                writer.Write(uint.MaxValue - 36);
+
+                writer.Flush();
+                return data.ToArray();
+            }
+        }
+
+    }
+}
@@ -2,59 +2,102 @@
 using System.Collections.Generic;
 using System.Linq;
 using System.Text;
-using System.Timers;
+using System.Threading;
 
 namespace TouchRemote.Core.Misc
 {
+    /// <summary>
+    /// Last-writer-wins setter for properties whose setter is slow, like the ones that wait for the main thread.
+    ///
+    /// SetValue returns at once; a pool thread calls the setter with the newest value, and values set while
+    /// it runs replace each other, so a burst of values costs at most two setter calls. Until the last value
+    /// has been applied, TryGetPending returns it, so snapshots can show what the client asked for.
+    /// </summary>
     public class DelayedPropertySetter<T>
     {
+        private readonly object m_sync = new object();
         private readonly Timer m_timer;
-        private T m_immediateValue;
+        private T m_pendingValue;
+        private bool m_hasPending;      // a value has been set and not applied yet
+        private bool m_dirty;           // m_pendingValue has not been passed to the setter yet
+        private bool m_running;         // the timer or a pool thread owns the drain loop
 
         public DelayedPropertySetter()
         {
-            m_timer = new Timer(100);
-            m_timer.Enabled = false;
-            m_timer.AutoReset = false;
-            m_timer.Elapsed += OnTimerElapsed;
+            m_timer = new Timer(OnTimerElapsed, null, Timeout.Infinite, Timeout.Infinite);
+            Delay = 0;
         }
 
-        private void OnTimerElapsed(object sender, ElapsedEventArgs e)
+        /// <summary>
+        /// Milliseconds to wait after the first value of a burst before applying, 0 to apply at once
+        /// </summary>
+        public double Delay { get; set; }
+
+        /// <summary>
+        /// Applies a value, runs on a pool thread and must not throw
+        /// </summary>
+        public Action<T> Setter { get; set; }
+
+        /// <summary>
+        /// Raised on the pool thread once the last pending value has been applied
+        /// </summary>
+        public event EventHandler Applied;
+
+        public void SetValue(T value)
         {
-            lock (m_timer)
+            lock (m_sync)
             {
-                var action = Setter;
-                if (action != null)
-                    action(m_immediateValue);
+                m_pendingValue = value;
+                m_hasPending = true;
+                m_dirty = true;
+
+                if (m_running) return;
+                m_running = true;
             }
+
+            var delay = Delay;
+            if (delay > 0)
+                m_timer.Change((long)delay, Timeout.Infinite);
+            else
+                ThreadPool.QueueUserWorkItem(OnTimerElapsed);
         }
 
-        public double Delay 
+        public bool TryGetPending(out T value)
         {
-            get { return m_timer.Interval; }
-            set 
+            lock (m_sync)
             {
-                if (m_timer.Interval != value)
-                {
-                    lock (m_timer)
-                    {
-                        m_timer.Stop();
-                        m_timer.Interval = value;
-                    }
-                }
+                value = m_pendingValue;
+                return m_hasPending;
             }
         }
 
-        public Action<T> Setter { get; set; }
-
-        public void SetValue(T value)
+        private void OnTimerElapsed(object state)
         {
-            lock (m_timer)
+            while (true)
             {
-                m_timer.Stop();
-                m_immediateValue = value;
-                m_timer.Start();
+                T value;
+                lock (m_sync)
+                {
+                    if (!m_dirty)
+                    {
+                        m_hasPending = false;
+                        m_pendingValue = default(T);
+                        m_running = false;
+                        break;
+                    }
+
+                    value = m_pendingValue;
+                    m_dirty = false;
+                }
+
+                var action = Setter;
+                if (action != null)
+                    action(value);
             }
+
+            var handler = Applied;
+            if (handler != null)
+                handler(this, EventArgs.Empty);
         }
     }
 }
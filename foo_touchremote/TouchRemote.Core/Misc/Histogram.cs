@@ -0,0 +1,122 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+using System.Diagnostics;
+
+namespace TouchRemote.Core.Misc
+{
+
+    /// <summary>
+    /// Lock-free histogram of non-negative values with power-of-two buckets.
+    /// Recording is a few interlocked adds, so it can stay on in hot paths; readers may see a sample
+    /// counted in one field but not yet in another, which is fine for statistics.
+    /// </summary>
+    public sealed class Histogram
+    {
+        // bucket 0 holds 0, bucket i holds [2^(i-1), 2^i)
+        private const int BucketCount = 48;
+
+        private readonly long[] buckets = new long[BucketCount];
+        private long count;
+        private long total;
+        private long max;
+
+        internal Histogram(string name, string unit)
+        {
+            Name = name;
+            Unit = unit;
+        }
+
+        public string Name { get; private set; }
+
+        public string Unit { get; private set; }
+
+        public long Count { get { return Interlocked.Read(ref count); } }
+
+        public long Total { get { return Interlocked.Read(ref total); } }
+
+        public long Max { get { return Interlocked.Read(ref max); } }
+
+        public double Mean
+        {
+            get
+            {
+                var n = Count;
+                return n > 0 ? (double)Total / n : 0.0;
+            }
+        }
+
+        public static long Start()
+        {
+            return Stopwatch.GetTimestamp();
+        }
+
+        // records the microseconds elapsed since a Start() timestamp
+        public void Stop(long start)
+        {
+            Add((Stopwatch.GetTimestamp() - start) * 1000000 / Stopwatch.Frequency);
+        }
+
+        public void AddSeconds(double seconds)
+        {
+            Add((long)(seconds * 1000000));
+        }
+
+        public void Add(long value)
+        {
+            if (value < 0) value = 0;
+
+            Interlocked.Increment(ref buckets[BucketOf(value)]);
+            Interlocked.Increment(ref count);
+            Interlocked.Add(ref total, value);
+
+            long current;
+            while (value > (current = Interlocked.Read(ref max)))
+            {
+                if (Interlocked.CompareExchange(ref max, value, current) == current) break;
+            }
+        }
+
+        // upper bound of the bucket holding the given fraction of samples, never above the maximum seen
+        public long Percentile(double fraction)
+        {
+            var n = Count;
+            if (n == 0) return 0;
+
+            var rank = (long)Math.Ceiling(n * fraction);
+            if (rank < 1) rank = 1;
+
+            long seen = 0;
+            for (int i = 0; i < BucketCount; i++)
+            {
+                seen += Interlocked.Read(ref buckets[i]);
+                if (seen >= rank)
+                    return Math.Min(i == 0 ? 0 : (1L << i) - 1, Max);
+            }
+
+            return Max;
+        }
+
+        internal void Reset()
+        {
+            for (int i = 0; i < BucketCount; i++)
+                Interlocked.Exchange(ref buckets[i], 0);
+            Interlocked.Exchange(ref count, 0);
+            Interlocked.Exchange(ref total, 0);
+            Interlocked.Exchange(ref max, 0);
+        }
+
+        private static int BucketOf(long value)
+        {
+            int bucket = 0;
+            while (value > 0 && bucket < BucketCount - 1)
+            {
+                value >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+    }
+}
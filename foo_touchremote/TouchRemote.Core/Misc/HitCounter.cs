@@ -0,0 +1,60 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+
+namespace TouchRemote.Core.Misc
+{
+
+    /// <summary>
+    /// Lock-free hit/miss counter of a cache
+    /// </summary>
+    public sealed class HitCounter
+    {
+        private long hits;
+        private long misses;
+
+        internal HitCounter(string name)
+        {
+            Name = name;
+        }
+
+        public string Name { get; private set; }
+
+        public long Hits { get { return Interlocked.Read(ref hits); } }
+
+        public long Misses { get { return Interlocked.Read(ref misses); } }
+
+        public double HitRate
+        {
+            get
+            {
+                long h = Hits, n = h + Misses;
+                return n > 0 ? (double)h / n : 0.0;
+            }
+        }
+
+        public void Hit()
+        {
+            Interlocked.Increment(ref hits);
+        }
+
+        public void Miss()
+        {
+            Interlocked.Increment(ref misses);
+        }
+
+        public void Record(bool hit)
+        {
+            if (hit) Hit();
+            else Miss();
+        }
+
+        internal void Reset()
+        {
+            Interlocked.Exchange(ref hits, 0);
+            Interlocked.Exchange(ref misses, 0);
+        }
+
+    }
+}
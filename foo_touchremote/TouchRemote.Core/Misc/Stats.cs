@@ -0,0 +1,212 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using System.Diagnostics;
+using System.Globalization;
+
+namespace TouchRemote.Core.Misc
+{
+
+    /// <summary>
+    /// Process-wide registry of performance counters, rendered by the /stats endpoint and the periodic console dump.
+    ///
+    /// Counters are created on first use and live forever. Lookups read an immutable dictionary without locking,
+    /// so hot paths should still keep the returned counter in a static field where they can.
+    /// </summary>
+    public static class Stats
+    {
+        public const string Microseconds = "us";
+        public const string Bytes = "bytes";
+
+        private static readonly object sync = new object();
+        private static Dictionary<string, Histogram> histograms = new Dictionary<string, Histogram>(StringComparer.Ordinal);
+        private static Dictionary<string, HitCounter> caches = new Dictionary<string, HitCounter>(StringComparer.Ordinal);
+        private static readonly Stopwatch since = Stopwatch.StartNew();
+
+        public static Histogram Latency(string name)
+        {
+            return GetHistogram(name, Microseconds);
+        }
+
+        public static Histogram Size(string name)
+        {
+            return GetHistogram(name, Bytes);
+        }
+
+        public static HitCounter Cache(string name)
+        {
+            HitCounter counter;
+            if (caches.TryGetValue(name, out counter))
+                return counter;
+
+            lock (sync)
+            {
+                if (!caches.TryGetValue(name, out counter))
+                {
+                    counter = new HitCounter(name);
+                    caches = new Dictionary<string, HitCounter>(caches, StringComparer.Ordinal) { { name, counter } };
+                }
+                return counter;
+            }
+        }
+
+        private static Histogram GetHistogram(string name, string unit)
+        {
+            Histogram histogram;
+            if (histograms.TryGetValue(name, out histogram))
+                return histogram;
+
+            lock (sync)
+            {
+                if (!histograms.TryGetValue(name, out histogram))
+                {
+                    histogram = new Histogram(name, unit);
+                    histograms = new Dictionary<string, Histogram>(histograms, StringComparer.Ordinal) { { name, histogram } };
+                }
+                return histogram;
+            }
+        }
+
+        #region Lock wait
+
+        // The lock helpers try the lock first and only time the wait when it is contended,
+        // so the wait histograms count contended acquisitions only.
+
+        public static void Enter(object lockObject, Histogram wait)
+        {
+            if (Monitor.TryEnter(lockObject)) return;
+
+            var start = Histogram.Start();
+            Monitor.Enter(lockObject);
+            wait.Stop(start);
+        }
+
+        public static void EnterReadLock(ReaderWriterLockSlim lockObject, Histogram wait)
+        {
+            if (lockObject.TryEnterReadLock(0)) return;
+
+            var start = Histogram.Start();
+            lockObject.EnterReadLock();
+            wait.Stop(start);
+        }
+
+        public static void EnterUpgradeableReadLock(ReaderWriterLockSlim lockObject, Histogram wait)
+        {
+            if (lockObject.TryEnterUpgradeableReadLock(0)) return;
+
+            var start = Histogram.Start();
+            lockObject.EnterUpgradeableReadLock();
+            wait.Stop(start);
+        }
+
+        public static void EnterWriteLock(ReaderWriterLockSlim lockObject, Histogram wait)
+        {
+            if (lockObject.TryEnterWriteLock(0)) return;
+
+            var start = Histogram.Start();
+            lockObject.EnterWriteLock();
+            wait.Stop(start);
+        }
+
+        #endregion
+
+        public static void Reset()
+        {
+            foreach (var histogram in histograms.Values)
+                histogram.Reset();
+            foreach (var counter in caches.Values)
+                counter.Reset();
+
+            lock (sync)
+            {
+                since.Reset();
+                since.Start();
+            }
+        }
+
+        public static string ToText()
+        {
+            var sb = new StringBuilder();
+            sb.AppendFormat(CultureInfo.InvariantCulture, "TouchRemote statistics for the last {0:0} s", since.Elapsed.TotalSeconds).AppendLine();
+
+            foreach (var group in histograms.Values.GroupBy(h => h.Unit).OrderByDescending(g => g.Key))
+            {
+                sb.AppendLine();
+                sb.AppendFormat(CultureInfo.InvariantCulture, "{0,-48} {1,9} {2,11} {3,9} {4,9} {5,9} {6,11}",
+                    "(" + group.Key + ")", "count", "mean", "p50", "p90", "p99", "max").AppendLine();
+
+                foreach (var h in group.OrderBy(h => h.Name, StringComparer.Ordinal))
+                {
+                    sb.AppendFormat(CultureInfo.InvariantCulture, "{0,-48} {1,9} {2,11:0.0} {3,9} {4,9} {5,9} {6,11}",
+                        h.Name, h.Count, h.Mean, h.Percentile(0.5), h.Percentile(0.9), h.Percentile(0.99), h.Max).AppendLine();
+                }
+            }
+
+            if (caches.Count > 0)
+            {
+                sb.AppendLine();
+                sb.AppendFormat(CultureInfo.InvariantCulture, "{0,-48} {1,9} {2,11} {3,9}", "(cache)", "hits", "misses", "rate").AppendLine();
+
+                foreach (var c in caches.Values.OrderBy(c => c.Name, StringComparer.Ordinal))
+                {
+                    sb.AppendFormat(CultureInfo.InvariantCulture, "{0,-48} {1,9} {2,11} {3,8:0.0}%",
+                        c.Name, c.Hits, c.Misses, c.HitRate * 100).AppendLine();
+                }
+            }
+
+            return sb.ToString();
+        }
+
+        public static string ToJson()
+        {
+            var sb = new StringBuilder();
+            sb.AppendFormat(CultureInfo.InvariantCulture, "{{\"seconds\":{0:0.###},\"histograms\":[", since.Elapsed.TotalSeconds);
+
+            bool first = true;
+            foreach (var h in histograms.Values.OrderBy(h => h.Name, StringComparer.Ordinal))
+            {
+                if (!first) sb.Append(',');
+                first = false;
+
+                sb.AppendFormat(CultureInfo.InvariantCulture,
+                    "{{\"name\":{0},\"unit\":{1},\"count\":{2},\"total\":{3},\"mean\":{4:0.###},\"p50\":{5},\"p90\":{6},\"p99\":{7},\"max\":{8}}}",
+                    JsonString(h.Name), JsonString(h.Unit), h.Count, h.Total, h.Mean, h.Percentile(0.5), h.Percentile(0.9), h.Percentile(0.99), h.Max);
+            }
+
+            sb.Append("],\"caches\":[");
+
+            first = true;
+            foreach (var c in caches.Values.OrderBy(c => c.Name, StringComparer.Ordinal))
+            {
+                if (!first) sb.Append(',');
+                first = false;
+
+                sb.AppendFormat(CultureInfo.InvariantCulture, "{{\"name\":{0},\"hits\":{1},\"misses\":{2},\"rate\":{3:0.####}}}",
+                    JsonString(c.Name), c.Hits, c.Misses, c.HitRate);
+            }
+
+            sb.Append("]}");
+            return sb.ToString();
+        }
+
+        private static string JsonString(string value)
+        {
+            var sb = new StringBuilder(value.Length + 2);
+            sb.Append('"');
+            foreach (var c in value)
+            {
+                if (c == '"' || c == '\\')
+                    sb.Append('\\').Append(c);
+                else if (c < ' ')
+                    sb.AppendFormat(CultureInfo.InvariantCulture, "\\u{0:x4}", (int)c);
+                else
+                    sb.Append(c);
+            }
+            sb.Append('"');
+            return sb.ToString();
+        }
+
+    }
+}
@@ -15,16 +15,52 @@ namespace TouchRemote.Core
             GuestMode = guestMode;
             m_dbLocks = 0;
             m_stateLocks = 0;
-            CtrlIntRevision = 0;
-            DatabaseRevision = 0;
+            m_stateOffset = 0;
+            m_dbOffset = 0;
+            Touch();
         }
 
         public int SessionId { get; private set; }
 
         public bool GuestMode { get; private set; }
 
-        public uint CtrlIntRevision { get; set; }
-        public uint DatabaseRevision { get; set; }
+        // Revisions follow the global counters of SessionManager, minus the bumps made while this session
+        // held the corresponding lock: a remote is not woken up by the changes it made itself.
+
+        public uint CtrlIntRevision
+        {
+            get
+            {
+                lock (m_sync)
+                    return (m_stateLocks > 0 ? m_stateFrozen : SessionManager.CtrlIntRevision) - m_stateOffset;
+            }
+        }
+
+        public uint DatabaseRevision
+        {
+            get
+            {
+                lock (m_sync)
+                    return (m_dbLocks > 0 ? m_dbFrozen : SessionManager.DatabaseRevision) - m_dbOffset;
+            }
+        }
+
+        #region Activity
+
+        private long m_lastActivity;
+
+        // called for every request of the session and while a long poll waits
+        public void Touch()
+        {
+            Interlocked.Exchange(ref m_lastActivity, DateTime.UtcNow.Ticks);
+        }
+
+        public TimeSpan IdleTime
+        {
+            get { return TimeSpan.FromTicks(DateTime.UtcNow.Ticks - Interlocked.Read(ref m_lastActivity)); }
+        }
+
+        #endregion
 
         #region Session locking
 
@@ -37,27 +73,39 @@ namespace TouchRemote.Core
             {
                 this.session = session;
                 this.mode = mode;
-                if ((mode & 1) == 1)
-                    Interlocked.Increment(ref session.m_stateLocks);
-                if ((mode & 2) == 2)
-                    Interlocked.Increment(ref session.m_dbLocks);
+
+                lock (session.m_sync)
+                {
+                    if ((mode & 1) == 1 && session.m_stateLocks++ == 0)
+                        session.m_stateFrozen = SessionManager.CtrlIntRevision;
+                    if ((mode & 2) == 2 && session.m_dbLocks++ == 0)
+                        session.m_dbFrozen = SessionManager.DatabaseRevision;
+                }
             }
 
             public void Dispose()
             {
-                if ((mode & 1) == 1)
-                    Interlocked.Decrement(ref session.m_stateLocks);
-                if ((mode & 2) == 2)
-                    Interlocked.Decrement(ref session.m_dbLocks);
+                lock (session.m_sync)
+                {
+                    if ((mode & 1) == 1 && --session.m_stateLocks == 0)
+                        session.m_stateOffset += SessionManager.CtrlIntRevision - session.m_stateFrozen;
+                    if ((mode & 2) == 2 && --session.m_dbLocks == 0)
+                        session.m_dbOffset += SessionManager.DatabaseRevision - session.m_dbFrozen;
+                }
             }
         }
 
+        private readonly object m_sync = new object();
         private int m_stateLocks;
         private int m_dbLocks;
+        private uint m_stateFrozen;     // global revision when the outermost lock was taken
+        private uint m_dbFrozen;
+        private uint m_stateOffset;     // bumps skipped while locked
+        private uint m_dbOffset;
 
-        public bool IsStateLocked { get { return Interlocked.CompareExchange(ref m_stateLocks, 0, 0) > 0; } }
+        public bool IsStateLocked { get { lock (m_sync) return m_stateLocks > 0; } }
 
-        public bool IsDbLocked { get { return Interlocked.CompareExchange(ref m_dbLocks, 0, 0) > 0; } }
+        public bool IsDbLocked { get { lock (m_sync) return m_dbLocks > 0; } }
 
         public IDisposable LockState()
         {
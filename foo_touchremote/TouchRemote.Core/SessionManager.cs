@@ -2,49 +2,77 @@
 using System.Collections.Generic;
 using System.Linq;
 using System.Text;
+using System.Threading;
+using System.Security.Cryptography;
 using TouchRemote.Core.Dacp.Responders;
 
 namespace TouchRemote.Core
 {
     public static class SessionManager
     {
+        private static readonly TimeSpan IdleTimeout = TimeSpan.FromMinutes(30);
+        private static readonly TimeSpan SweepInterval = TimeSpan.FromMinutes(5);
 
-        private static readonly Dictionary<int, Session> sessions = new Dictionary<int, Session>();
+        // replaced as a whole under sync, so lookups read it without locking
+        private static volatile Dictionary<int, Session> sessions = new Dictionary<int, Session>();
+        private static readonly object sync = new object();
+        private static readonly RandomNumberGenerator random = RandomNumberGenerator.Create();
+        private static long nextSweep = DateTime.UtcNow.Ticks + SweepInterval.Ticks;
+
+        // starts at 1, so a first status request with revision 1 is answered at once
+        private static int ctrlIntRevision = 1;
+
+        internal static uint CtrlIntRevision
+        {
+            get { return unchecked((uint)Thread.VolatileRead(ref ctrlIntRevision)); }
+        }
+
+        // the database revision is the one of the change journal, so delta=N maps to journal revision N - 1
+        internal static uint DatabaseRevision
+        {
+            get { return ChangeJournal.Revision; }
+        }
 
         internal static Session GetSession(int sessionId)
         {
-            lock (sessions)
-            {
-                Session session;
-                if (sessions.TryGetValue(sessionId, out session))
-                    return session;
-            }
+            SweepIfDue();
+
+            Session session;
+            if (!sessions.TryGetValue(sessionId, out session))
+                return null;
 
-            return null;
+            session.Touch();
+            return session;
         }
 
-        internal static void StartSession(int sessionId, bool guestMode)
+        internal static Session StartSession(bool guestMode)
         {
-            lock (sessions)
+            lock (sync)
             {
-                Session info;
-                if (sessions.TryGetValue(sessionId, out info))
-                {
-                    // TODO: do something with it
-                }
-                else
+                RemoveIdleSessions();
+
+                int sessionId;
+                do
                 {
-                    info = new Session(sessionId, guestMode);
-                    sessions.Add(sessionId, info);
+                    sessionId = NewSessionId();
                 }
+                while (sessions.ContainsKey(sessionId));
+
+                var session = new Session(sessionId, guestMode);
+                sessions = new Dictionary<int, Session>(sessions) { { sessionId, session } };
+                return session;
             }
         }
 
         internal static void TerminateSession(int sessionId)
         {
-            lock (sessions)
+            lock (sync)
             {
-                sessions.Remove(sessionId);
+                if (!sessions.ContainsKey(sessionId)) return;
+
+                var copy = new Dictionary<int, Session>(sessions);
+                copy.Remove(sessionId);
+                sessions = copy;
             }
         }
 
@@ -56,20 +84,50 @@ namespace TouchRemote.Core
 
         public static void DatabaseUpdated()
         {
-            lock (sessions)
-            {
-                foreach (var session in sessions.Where(x => !x.Value.IsDbLocked))
-                    session.Value.DatabaseRevision++;
-            }
+            ChangeJournal.Commit();
         }
 
         public static void StateUpdated()
         {
-            lock (sessions)
+            Interlocked.Increment(ref ctrlIntRevision);
+        }
+
+        // random positive ids, a remote cannot guess the session of another one
+        private static int NewSessionId()
+        {
+            var bytes = new byte[4];
+            int sessionId;
+            do
             {
-                foreach (var session in sessions.Where(x => !x.Value.IsStateLocked))
-                    session.Value.CtrlIntRevision++;
+                random.GetBytes(bytes);
+                sessionId = BitConverter.ToInt32(bytes, 0) & int.MaxValue;
             }
+            while (sessionId == 0);
+
+            return sessionId;
+        }
+
+        private static void SweepIfDue()
+        {
+            var now = DateTime.UtcNow.Ticks;
+            var due = Interlocked.Read(ref nextSweep);
+            if (now < due || Interlocked.CompareExchange(ref nextSweep, now + SweepInterval.Ticks, due) != due)
+                return;
+
+            lock (sync)
+                RemoveIdleSessions();
+        }
+
+        // remotes poll while they are in the foreground, a session not seen for a while belongs to a remote that went away
+        private static void RemoveIdleSessions()
+        {
+            var idle = sessions.Where(x => x.Value.IdleTime > IdleTimeout).Select(x => x.Key).ToList();
+            if (idle.Count == 0) return;
+
+            var copy = new Dictionary<int, Session>(sessions);
+            foreach (var sessionId in idle)
+                copy.Remove(sessionId);
+            sessions = copy;
         }
         
     }
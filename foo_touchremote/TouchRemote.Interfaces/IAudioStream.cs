@@ -0,0 +1,24 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace TouchRemote.Interfaces
+{
+    public interface IAudioStream : IDisposable
+    {
+
+        // format is known after the first successful Read()
+        int SampleRate { get; }
+
+        int Channels { get; }
+
+        int BitsPerSample { get; }
+
+        long DroppedBytes { get; }
+
+        // Reads whole frames of little-endian PCM. Returns 0 when nothing arrived within the timeout,
+        // -1 once the stream has ended because the format changed or the player is shutting down.
+        int Read(byte[] buffer, int offset, int count, TimeSpan timeout);
+
+    }
+}
@@ -0,0 +1,16 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace TouchRemote.Interfaces
+{
+    public interface IAudioStreamSource
+    {
+
+        bool IsAudioStreamEnabled { get; }
+
+        // returns null when too many listeners are connected
+        IAudioStream OpenAudioStream();
+
+    }
+}
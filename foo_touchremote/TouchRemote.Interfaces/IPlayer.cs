@@ -39,6 +39,9 @@ namespace TouchRemote.Interfaces
 
         ITrack CurrentTrack { get; }
 
+        // all of the above as one consistent snapshot, never null
+        NowPlaying NowPlaying { get; }
+
         // -----------------------
 
         IPlaylist ActivePlaylist { get; }
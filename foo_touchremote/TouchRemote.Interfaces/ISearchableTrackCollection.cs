@@ -0,0 +1,20 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace TouchRemote.Interfaces
+{
+    /// <summary>
+    /// Track collection that keeps a substring index over the text properties of its tracks.
+    /// </summary>
+    public interface ISearchableTrackCollection : IEnumerable<ITrack>
+    {
+
+        /// <summary>
+        /// Tracks of this collection whose <paramref name="property"/>, named as on <see cref="ITrack"/>, contains
+        /// <paramref name="value"/> ignoring case, accents and ligatures; null when the property is not indexed.
+        /// </summary>
+        ICollection<ITrack> FindContaining(string property, string value);
+
+    }
+}
@@ -0,0 +1,70 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Diagnostics;
+
+namespace TouchRemote.Interfaces
+{
+    // Immutable view of the player state as of one playback event.
+    // The player publishes a new instance whenever something changes, so readers get a consistent
+    // set of values from one reference read instead of sampling each property separately.
+    public sealed class NowPlaying
+    {
+        public static readonly NowPlaying Stopped = new NowPlaying(null, 0, PlaybackState.Stopped, TimeSpan.Zero, Stopwatch.GetTimestamp(), 0.0, ShuffleMode.None, RepeatMode.None, 0);
+
+        public NowPlaying(ITrack track, int containerId, PlaybackState state, TimeSpan positionBase, long positionTimestamp, double rate, ShuffleMode shuffle, RepeatMode repeat, int volume)
+        {
+            Track = track;
+            ContainerId = containerId;
+            State = state;
+            PositionBase = positionBase;
+            PositionTimestamp = positionTimestamp;
+            Rate = rate;
+            Shuffle = shuffle;
+            Repeat = repeat;
+            Volume = volume;
+        }
+
+        public ITrack Track { get; private set; }
+
+        // id of the playlist (or library) the track is played from
+        public int ContainerId { get; private set; }
+
+        public PlaybackState State { get; private set; }
+
+        // playback position at PositionTimestamp (Stopwatch ticks)
+        public TimeSpan PositionBase { get; private set; }
+
+        public long PositionTimestamp { get; private set; }
+
+        // playback speed while playing, 1.0 for normal playback
+        public double Rate { get; private set; }
+
+        // Exact position right now, extrapolated from the base while playing. Never beyond the track length.
+        public TimeSpan Position
+        {
+            get
+            {
+                if (State != PlaybackState.Playing || Rate == 0.0)
+                    return PositionBase;
+
+                var elapsed = (double)(Stopwatch.GetTimestamp() - PositionTimestamp) / Stopwatch.Frequency;
+                var position = PositionBase + TimeSpan.FromSeconds(elapsed * Rate);
+
+                if (position < TimeSpan.Zero)
+                    return TimeSpan.Zero;
+                if (Track != null && Track.Duration > TimeSpan.Zero && position > Track.Duration)
+                    return Track.Duration;
+
+                return position;
+            }
+        }
+
+        public ShuffleMode Shuffle { get; private set; }
+
+        public RepeatMode Repeat { get; private set; }
+
+        public int Volume { get; private set; }
+
+    }
+}
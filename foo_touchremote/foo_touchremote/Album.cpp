@@ -35,10 +35,11 @@ namespace foo_touchremote
 	bool Album::Equals(IAlbum^ other)
 	{
 		if (other == nullptr) return false;
+		if (ReferenceEquals(other, this)) return true;
 
 		if (!((IEquatable<IArtist^>^)Artist)->Equals(other->Artist)) return false;
 
-		if (!String::Equals(Title, other->Title, StringComparison::InvariantCultureIgnoreCase)) return false;
+		if (!ReferenceEquals(Title, other->Title) && !String::Equals(Title, other->Title, StringComparison::InvariantCultureIgnoreCase)) return false;
 
 		return true;
 	}
@@ -27,6 +27,7 @@ namespace foo_touchremote
 	bool Artist::Equals(IArtist^ other)
 	{
 		if (other == nullptr) return false;
+		if (ReferenceEquals(other, this) || ReferenceEquals(Name, other->Name)) return true;
 
 		return String::Equals(Name, other->Name, StringComparison::InvariantCultureIgnoreCase);
 	}
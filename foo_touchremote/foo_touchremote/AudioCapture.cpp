@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "AudioCapture.h"
+
+namespace foo_touchremote
+{
+	namespace foobar
+	{
+
+		// seconds between captured chunks; shorter means less delay on the listener side
+		static const double CaptureInterval = 0.02;
+
+		AudioCapture::AudioCapture(PcmBroadcast & target) : playback_stream_capture_callback_impl(CaptureInterval), m_target(target)
+		{
+		}
+
+		void AudioCapture::on_chunk(const audio_chunk & chunk)
+		{
+			if (!m_target.HasReaders()) return;
+
+			m_target.Write(chunk.get_data(), chunk.get_sample_count(), chunk.get_channels(), chunk.get_sample_rate());
+		}
+
+	}
+
+	ToneGenerator::ToneGenerator(PcmBroadcast & target) : m_target(target), m_stopping(false)
+	{
+	}
+
+	ToneGenerator::~ToneGenerator()
+	{
+		Stop();
+	}
+
+	void ToneGenerator::Start()
+	{
+		m_stopping = false;
+		start(argBackground());
+	}
+
+	void ToneGenerator::Stop()
+	{
+		m_stopping = true;
+		waitTillDone();
+	}
+
+	void ToneGenerator::threadProc()
+	{
+		const unsigned sampleRate = 44100;
+		const unsigned channels = 2;
+		const unsigned samples = sampleRate / 50;
+		const double step = 2 * 3.14159265358979323846 * 440 / sampleRate;
+
+		pfc::array_t<audio_sample> chunk;
+		chunk.set_size(samples * channels);
+
+		t_uint64 position = 0;
+		pfc::lores_timer clock;
+		clock.start();
+
+		while (!m_stopping)
+		{
+			for (unsigned i = 0; i < samples; i++)
+			{
+				audio_sample value = (audio_sample)(0.25 * sin(step * (double)(position + i)));
+				for (unsigned c = 0; c < channels; c++) chunk[i * channels + c] = value;
+			}
+
+			m_target.Write(chunk.get_ptr(), samples, channels, sampleRate);
+			position += samples;
+
+			double ahead = (double)position / sampleRate - clock.query();
+			if (ahead > 0) pfc::sleepSeconds(ahead);
+		}
+	}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PcmBroadcast.h"
+
+namespace foo_touchremote
+{
+	namespace foobar
+	{
+
+		// Feeds the audio that is currently playing into a PcmBroadcast.
+		// Created and destroyed on the main thread, like the capture API requires.
+		class AudioCapture : public playback_stream_capture_callback_impl
+		{
+
+		public:
+			AudioCapture(PcmBroadcast & target);
+
+			virtual void on_chunk(const audio_chunk & chunk);
+
+		private:
+			PcmBroadcast & m_target;
+		};
+
+	}
+
+	// Synthetic stand-in for AudioCapture: a 440 Hz tone in 20 ms stereo chunks, paced in real time.
+	// Lets the streaming endpoint be tried without anything playing.
+	class ToneGenerator : private pfc::thread
+	{
+
+	public:
+		ToneGenerator(PcmBroadcast & target);
+		~ToneGenerator();
+
+		void Start();
+		void Stop();
+
+	private:
+		void threadProc();
+
+		PcmBroadcast & m_target;
+		volatile bool m_stopping;
+	};
+
+}
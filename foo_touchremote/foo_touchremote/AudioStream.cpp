@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include "AudioStream.h"
+
+#pragma managed
+
+namespace foo_touchremote
+{
+
+	AudioStream::AudioStream(PcmBroadcast * broadcast, PcmBroadcast::Reader * reader)
+	{
+		p_broadcast = broadcast;
+		p_reader = reader;
+	}
+
+	AudioStream::~AudioStream()
+	{
+		this->!AudioStream();
+	}
+
+	AudioStream::!AudioStream()
+	{
+		if (p_reader == NULL) return;
+
+		p_broadcast->Close(p_reader);
+		p_reader = NULL;
+	}
+
+	int AudioStream::SampleRate::get()
+	{
+		return p_reader != NULL ? (int)p_reader->GetSampleRate() : 0;
+	}
+
+	int AudioStream::Channels::get()
+	{
+		return p_reader != NULL ? (int)p_reader->GetChannels() : 0;
+	}
+
+	int AudioStream::BitsPerSample::get()
+	{
+		return 16;
+	}
+
+	__int64 AudioStream::DroppedBytes::get()
+	{
+		return p_reader != NULL ? (__int64)p_reader->GetDroppedBytes() : 0;
+	}
+
+	int AudioStream::Read(array<Byte>^ buffer, int offset, int count, TimeSpan timeout)
+	{
+		if (buffer == nullptr)
+			throw gcnew ArgumentNullException("buffer");
+		if (offset < 0 || count < 0 || offset + count > buffer->Length)
+			throw gcnew ArgumentOutOfRangeException("count");
+		if (p_reader == NULL)
+			throw gcnew ObjectDisposedException("AudioStream");
+
+		if (count == 0) return 0;
+
+		pin_ptr<Byte> data = &buffer[offset];
+		return p_reader->Read(data, count, timeout.TotalSeconds);
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PcmBroadcast.h"
+
+using namespace System;
+using namespace TouchRemote::Interfaces;
+
+namespace foo_touchremote
+{
+
+	// One listener on the PcmBroadcast; disposing it frees the reader slot.
+	private ref class AudioStream : public IAudioStream
+	{
+
+	public:
+		AudioStream(PcmBroadcast * broadcast, PcmBroadcast::Reader * reader);
+		~AudioStream();
+		!AudioStream();
+
+		virtual property int SampleRate
+		{
+			int get();
+		}
+
+		virtual property int Channels
+		{
+			int get();
+		}
+
+		virtual property int BitsPerSample
+		{
+			int get();
+		}
+
+		virtual property __int64 DroppedBytes
+		{
+			__int64 get();
+		}
+
+		virtual int Read(array<Byte>^ buffer, int offset, int count, TimeSpan timeout);
+
+	private:
+		PcmBroadcast * p_broadcast;
+		PcmBroadcast::Reader * p_reader;
+	};
+
+}
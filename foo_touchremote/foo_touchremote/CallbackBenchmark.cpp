@@ -0,0 +1,121 @@
+#include "stdafx.h"
+#include "CallbackBenchmark.h"
+#include "MainThreadCallback.h"
+
+#pragma managed
+
+namespace foo_touchremote
+{
+
+	namespace
+	{
+
+		CALLBACK_START_UU(BenchmarkPooled, int, int)
+			return arg + 1;
+		CALLBACK_END()
+
+		// A callback as CALLBACK_START_UU declared it before callback_pool: allocated per call,
+		// with its own gcroot handle and an event created and closed for each round trip.
+		class BenchmarkUnpooled : public service_impl_t<main_thread_callback>
+		{
+		public:
+			int Run(Object^ p_this, int arg)
+			{
+				m_this = p_this;
+				m_arg = arg;
+				service_add_ref();
+				try
+				{
+					m_hWaitFor = CreateEvent(NULL, TRUE, FALSE, NULL);
+					static_api_ptr_t<main_thread_callback_manager>()->add_callback(this);
+					WaitForSingleObject(m_hWaitFor, INFINITE);
+					CloseHandle(m_hWaitFor);
+					return m_result;
+				}
+				finally
+				{
+					service_release();
+				}
+			}
+
+			virtual void callback_run()
+			{
+				m_result = m_arg + 1;
+				SetEvent(m_hWaitFor);
+			}
+
+		private:
+			HANDLE m_hWaitFor;
+			int m_result;
+			int m_arg;
+			gcroot< Object^ > m_this;
+		};
+
+		int InvokeUnpooled(Object^ p_this, int arg)
+		{
+			return (new BenchmarkUnpooled())->Run(p_this, arg);
+		}
+
+		int InvokePooled(Object^ p_this, int arg)
+		{
+			return BenchmarkPooled::Invoke(p_this, arg);
+		}
+
+		typedef int (*invoke_t)(Object^ p_this, int arg);
+
+		const t_size WARMUP = 200;
+		const t_size ROUND_TRIPS = 5000;
+
+		// false if foobar2000 started shutting down meanwhile
+		bool Measure(const char * label, invoke_t invoke)
+		{
+			Object^ owner = gcnew Object();
+
+			for (t_size i = 0; i < WARMUP; i++)
+			{
+				if (core_api::is_shutting_down()) return false;
+				invoke(owner, (int)i);
+			}
+
+			pfc::array_t<double> times;
+			times.set_size(ROUND_TRIPS);
+
+			int collections = System::GC::CollectionCount(0);
+			pfc::hires_timer total;
+			total.start();
+			for (t_size i = 0; i < ROUND_TRIPS; i++)
+			{
+				if (core_api::is_shutting_down()) return false;
+
+				pfc::hires_timer timer;
+				timer.start();
+				invoke(owner, (int)i);
+				times[i] = timer.query();
+			}
+			double elapsed = total.query();
+			collections = System::GC::CollectionCount(0) - collections;
+
+			pfc::sort_t(times, pfc::compare_t<double, double>, ROUND_TRIPS);
+
+			console::formatter() << "TouchRemote callback benchmark, " << label << ": " << (t_uint32)ROUND_TRIPS << " round trips, mean "
+				<< pfc::format_float(elapsed * 1000000 / ROUND_TRIPS, 0, 1) << " us, median "
+				<< pfc::format_float(times[ROUND_TRIPS / 2] * 1000000, 0, 1) << " us, 99th percentile "
+				<< pfc::format_float(times[ROUND_TRIPS * 99 / 100] * 1000000, 0, 1) << " us, gen 0 collections " << collections;
+			return true;
+		}
+
+	}
+
+	void BenchmarkMainThreadCallbacks()
+	{
+		PFC_ASSERT(!core_api::is_main_thread());
+
+		// twice in turn, so neither side is favoured by what ran before it
+		for (int pass = 0; pass < 2; pass++)
+		{
+			if (!Measure("new per call", &InvokeUnpooled)) return;
+			if (!Measure("pooled", &InvokePooled)) return;
+		}
+	}
+
+}
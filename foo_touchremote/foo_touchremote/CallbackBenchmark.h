@@ -0,0 +1,11 @@
+#pragma once
+
+namespace foo_touchremote
+{
+
+	// Round-trip latency of a main thread callback posted from the calling thread, pooled callbacks against the
+	// new object, event and GC handles per call they replaced. Results go to the console. Must not be called
+	// on the main thread, which has to be free to run the callbacks.
+	void BenchmarkMainThreadCallbacks();
+
+}
@@ -31,3 +31,8 @@ static preferences_page_factory_t<foo_touchremote::foobar::PreferencesPage> _Pre
 
 static advconfig_branch_factory _AdvConfig("TouchRemote DACP Server", foo_touchremote::guids::AdvConfigBranch, advconfig_entry::guid_root, 0);
 advconfig_string_factory _AdvConfig_HostName("Host SRV name", foo_touchremote::guids::AdvConfig_HostName, foo_touchremote::guids::AdvConfigBranch, 0, "", preferences_state::needs_restart);
+advconfig_checkbox_factory _AdvConfig_BuiltInMdns("Use built-in mDNS responder instead of Bonjour", foo_touchremote::guids::AdvConfig_BuiltInMdns, foo_touchremote::guids::AdvConfigBranch, 1, false, preferences_state::needs_restart);
+advconfig_checkbox_factory _AdvConfig_AudioStream("Enable live audio stream at /stream.wav", foo_touchremote::guids::AdvConfig_AudioStream, foo_touchremote::guids::AdvConfigBranch, 2, false, preferences_state::needs_restart);
+advconfig_checkbox_factory _AdvConfig_AudioStreamTone("Stream a test tone instead of playback", foo_touchremote::guids::AdvConfig_AudioStreamTone, foo_touchremote::guids::AdvConfigBranch, 3, false, preferences_state::needs_restart);
+advconfig_integer_factory _AdvConfig_StatsInterval("Print performance statistics to the console every N minutes (0 = never)", foo_touchremote::guids::AdvConfig_StatsInterval, foo_touchremote::guids::AdvConfigBranch, 4, 0, 0, 1440, preferences_state::needs_restart);
+advconfig_checkbox_factory _AdvConfig_CallbackBenchmark("Benchmark main thread callbacks after startup, results in the console", foo_touchremote::guids::AdvConfig_CallbackBenchmark, foo_touchremote::guids::AdvConfigBranch, 5, false, preferences_state::needs_restart);
@@ -18,6 +18,21 @@ namespace foo_touchremote
 		// {EC399DA9-37C6-4552-ABA8-B395E49FC2E8}
 		const GUID AdvConfig_HostName = { 0xec399da9, 0x37c6, 0x4552, { 0xab, 0xa8, 0xb3, 0x95, 0xe4, 0x9f, 0xc2, 0xe8 } };
 
+		// {24DB9DB2-DAF6-4965-AC82-5713CF065E87}
+		const GUID AdvConfig_BuiltInMdns = { 0x24db9db2, 0xdaf6, 0x4965, { 0xac, 0x82, 0x57, 0x13, 0xcf, 0x6, 0x5e, 0x87 } };
+
+		// {C07F06BF-5064-4E2B-B38F-4C9DFA46A46C}
+		const GUID AdvConfig_AudioStream = { 0xc07f06bf, 0x5064, 0x4e2b, { 0xb3, 0x8f, 0x4c, 0x9d, 0xfa, 0x46, 0xa4, 0x6c } };
+
+		// {43260D63-3801-41BF-9E60-08C3D7B06D50}
+		const GUID AdvConfig_AudioStreamTone = { 0x43260d63, 0x3801, 0x41bf, { 0x9e, 0x60, 0x8, 0xc3, 0xd7, 0xb0, 0x6d, 0x50 } };
+
+		// {7A0C2E61-4B7D-4F3A-9E55-1D8B6C2F9A34}
+		const GUID AdvConfig_StatsInterval = { 0x7a0c2e61, 0x4b7d, 0x4f3a, { 0x9e, 0x55, 0x1d, 0x8b, 0x6c, 0x2f, 0x9a, 0x34 } };
+
+		// {EF5E56C9-49ED-4B77-A249-53580CB94DA9}
+		const GUID AdvConfig_CallbackBenchmark = { 0xef5e56c9, 0x49ed, 0x4b77, { 0xa2, 0x49, 0x53, 0x58, 0xc, 0xb9, 0x4d, 0xa9 } };
+
 		// {B11C2B26-1B33-4f82-A995-AB6C5B5CC562}
 		const GUID Setting_DatabaseId = { 0xb11c2b26, 0x1b33, 0x4f82, { 0xa9, 0x95, 0xab, 0x6c, 0x5b, 0x5c, 0xc5, 0x62 } };
 
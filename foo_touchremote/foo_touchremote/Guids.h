@@ -11,6 +11,11 @@ namespace foo_touchremote
 
 		extern const GUID AdvConfigBranch;
         extern const GUID AdvConfig_HostName;
+		extern const GUID AdvConfig_BuiltInMdns;
+		extern const GUID AdvConfig_AudioStream;
+		extern const GUID AdvConfig_AudioStreamTone;
+		extern const GUID AdvConfig_StatsInterval;
+		extern const GUID AdvConfig_CallbackBenchmark;
 
 		extern const GUID Setting_DatabaseId;
 		extern const GUID Setting_Port;
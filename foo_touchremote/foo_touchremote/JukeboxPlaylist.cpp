@@ -45,12 +45,12 @@ namespace foo_touchremote
 		
 		metadb_handle_ptr current;
 		if (static_api_ptr_t<playback_control>()->get_now_playing(current))
-			list->Add(gcnew JukeboxTrack(host->MediaLibrary, current));
+			list->Add(gcnew JukeboxTrack(safe_cast<Track^>(host->GetTrack(current))));
 
 		for(t_size i = 0; i < items.get_count(); i++)
 		{
 			//list->Add(host->GetTrack(items[i].m_handle));
-			list->Add(gcnew JukeboxTrack(host->MediaLibrary, items[i].m_handle));
+			list->Add(gcnew JukeboxTrack(safe_cast<Track^>(host->GetTrack(items[i].m_handle))));
 		}
 
 		return list;
@@ -60,7 +60,7 @@ namespace foo_touchremote
 	{
 		if (m_tracks == nullptr)
 		{
-			m_tracks = (new JukeboxPlaylistTracks_enum())->Run(this);
+			m_tracks = JukeboxPlaylistTracks_enum::Invoke(this);
 			m_trackCount = m_tracks->Count;
 		}
 		return m_tracks;
@@ -75,7 +75,7 @@ namespace foo_touchremote
 		if (m_tracks == nullptr)
 		{
 			if (m_trackCount == -1)
-				m_trackCount = (new JukeboxPlaylistTracks_count())->Run(this);
+				m_trackCount = JukeboxPlaylistTracks_count::Invoke(this);
 			return m_trackCount;
 		}
 		return m_tracks->Count;
@@ -119,7 +119,7 @@ namespace foo_touchremote
 		if (track == nullptr)
 			throw gcnew ArgumentNullException("track");
 
-		(new JukeboxPlaylist_vote())->Run(this, track);
+		JukeboxPlaylist_vote::Invoke(this, track);
 	}
 
 }
\ No newline at end of file
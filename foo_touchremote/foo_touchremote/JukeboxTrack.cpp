@@ -8,6 +8,7 @@
 #include "MainThreadCallback.h"
 #include "ManagedHost.h"
 #include "TitleFormatters.h"
+#include "TrackTable.h"
 
 #pragma managed
 
@@ -16,12 +17,9 @@ using namespace System::IO;
 namespace foo_touchremote
 {
 
-	JukeboxTrack::JukeboxTrack(IMediaLibrary^ library, metadb_handle_ptr &ptr) : Track(library, ptr)
-	{
-	}
-
-	JukeboxTrack::JukeboxTrack(IMediaLibrary^ library, metadb_handle_ptr &ptr, IPlaybackSource^ location) : Track(library, ptr, location)
+	JukeboxTrack::JukeboxTrack(Track^ track) : Track(track->Table, track->Row)
 	{
+		m_track = track;
 	}
 
 	void JukeboxTrack::Extend(System::Collections::Generic::IDictionary<String^, Object^>^ data)
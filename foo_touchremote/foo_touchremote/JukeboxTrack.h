@@ -12,11 +12,14 @@ namespace foo_touchremote
 	public ref class JukeboxTrack : public Track, public IPropertyExtender
 	{
 	public:
-		JukeboxTrack(IMediaLibrary^ library, metadb_handle_ptr &ptr);
-		JukeboxTrack(IMediaLibrary^ library, metadb_handle_ptr &ptr, IPlaybackSource^ location);
+		JukeboxTrack(Track^ track);
 
 		virtual void Extend(System::Collections::Generic::IDictionary<String^, Object^>^ data);
 
+	private:
+		// keeps the shared row from being reused while the queue entry is alive
+		Track^ m_track;
+
 	};
 
 }
\ No newline at end of file
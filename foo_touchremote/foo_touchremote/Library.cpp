@@ -7,6 +7,8 @@
 #include "IDProvider.h"
 #include "Album.h"
 #include "Artist.h"
+#include "StringPool.h"
+#include "TrackTable.h"
 #include "Utils.h"
 
 #pragma managed
@@ -31,27 +33,166 @@ namespace foo_touchremote
 	}
 
 
+	Library::ReadScope::ReadScope(Library^ library)
+	{
+		m_previous = s_readTracks;
+		if (m_previous == nullptr)
+			s_readTracks = library->m_tracks;
+	}
+
+	Library::ReadScope::~ReadScope()
+	{
+		s_readTracks = m_previous;
+	}
+
+	Library::WriteScope::WriteScope(Library^ library)
+	{
+		m_library = library;
+		TouchRemote::Core::Misc::Stats::Enter(m_library->m_writeSync, m_library->m_writeWait);
+		m_library->m_writeDepth++;
+	}
+
+	Library::WriteScope::~WriteScope()
+	{
+		try
+		{
+			if (--m_library->m_writeDepth == 0 && m_library->m_pendingTracks != nullptr)
+			{
+				System::Threading::Interlocked::Exchange(m_library->m_tracks, m_library->m_pendingTracks);
+				m_library->m_pendingTracks = nullptr;
+			}
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(m_library->m_writeSync);
+		}
+	}
+
+	Library::TrackCollection::TrackCollection(TrackTable^ table, Dictionary<IPlaybackSource^, ITrack^>^ tracks)
+	{
+		m_table = table;
+		m_tracks = tracks;
+	}
+
+	IEnumerator<ITrack^>^ Library::TrackCollection::GetEnumerator()
+	{
+		return m_tracks->Values->GetEnumerator();
+	}
+
+	System::Collections::IEnumerator^ Library::TrackCollection::GetEnumeratorUntyped()
+	{
+		return GetEnumerator();
+	}
+
+	int Library::TrackCollection::Count::get()
+	{
+		return m_tracks->Count;
+	}
+
+	bool Library::TrackCollection::IsReadOnly::get()
+	{
+		return true;
+	}
+
+	bool Library::TrackCollection::Contains(ITrack^ item)
+	{
+		if (item == nullptr || item->Source == nullptr) return false;
+
+		ITrack^ track;
+		return m_tracks->TryGetValue(item->Source, track) && track->Equals(item);
+	}
+
+	void Library::TrackCollection::CopyTo(array<ITrack^>^ target, int index)
+	{
+		m_tracks->Values->CopyTo(target, index);
+	}
+
+	void Library::TrackCollection::Add(ITrack^ item)
+	{
+		throw gcnew NotSupportedException();
+	}
+
+	bool Library::TrackCollection::Remove(ITrack^ item)
+	{
+		throw gcnew NotSupportedException();
+	}
+
+	void Library::TrackCollection::Clear()
+	{
+		throw gcnew NotSupportedException();
+	}
+
+	ICollection<ITrack^>^ Library::TrackCollection::FindContaining(String^ property, String^ value)
+	{
+		if (m_table == nullptr) return nullptr;
+
+		List<int>^ rows = m_table->FindRows(property, value);
+		if (rows == nullptr) return nullptr;
+
+		// the table also holds playlist tracks outside the library, and tracks of other versions
+		List<ITrack^>^ tracks = gcnew List<ITrack^>(rows->Count);
+		for each (int row in rows)
+		{
+			IPlaybackSource^ source = m_table->m_sources[row];
+			ITrack^ track;
+			if (source != nullptr && m_tracks->TryGetValue(source, track))
+				tracks->Add(track);
+		}
+
+		return tracks;
+	}
+
 	Library::Library()
 	{
 		m_tracks = gcnew Dictionary<IPlaybackSource^, ITrack^>();
+		m_pendingTracks = nullptr;
+		m_removedSources = nullptr;
+		m_writeSync = gcnew Object();
+		m_writeDepth = 0;
+		m_writeWait = TouchRemote::Core::Misc::Stats::Latency("lock wait Library writer");
 		m_artists = gcnew Dictionary<String^, AAEntry^>(StringComparer::InvariantCultureIgnoreCase);
+		m_artistsWait = TouchRemote::Core::Misc::Stats::Latency("lock wait Library artists");
 
 		m_musicPlaylist = gcnew MusicPlaylist(this, "Music");
 		m_moviesPlaylist = gcnew MoviesPlaylist(this, "Movies");
 		m_jukeboxPlaylist = nullptr; // gcnew JukeboxPlaylist(this, "Foobar DJ");
 		
 		m_idProvider = gcnew IDProvider(this);
-		m_lockObject = gcnew System::Threading::ReaderWriterLockSlim(System::Threading::LockRecursionPolicy::NoRecursion);
+		m_strings = gcnew StringPool();
+		m_table = nullptr;
 	}
 
 	IDisposable^ Library::BeginRead()
 	{
-		return gcnew TouchRemote::Core::Misc::ReadWriteLock(m_lockObject, false);
+		return gcnew ReadScope(this);
 	}
 
 	IDisposable^ Library::BeginWrite()
 	{
-		return gcnew TouchRemote::Core::Misc::ReadWriteLock(m_lockObject, true);
+		return gcnew WriteScope(this);
+	}
+
+	Dictionary<IPlaybackSource^, ITrack^>^ Library::ReadTracks()
+	{
+		Dictionary<IPlaybackSource^, ITrack^>^ tracks = s_readTracks;
+		return (tracks != nullptr) ? tracks : m_tracks;
+	}
+
+	// the writer's copy if it has one, so a batch sees its own earlier changes
+	Dictionary<IPlaybackSource^, ITrack^>^ Library::LatestTracks()
+	{
+		return (m_pendingTracks != nullptr) ? m_pendingTracks : m_tracks;
+	}
+
+	Dictionary<IPlaybackSource^, ITrack^>^ Library::WriteTracks()
+	{
+		if (m_writeDepth == 0)
+			throw gcnew InvalidOperationException("Library is modified outside of BeginWrite()");
+
+		if (m_pendingTracks == nullptr)
+			m_pendingTracks = gcnew Dictionary<IPlaybackSource^, ITrack^>(m_tracks);
+
+		return m_pendingTracks;
 	}
 
 	int Library::Id::get()
@@ -71,7 +212,7 @@ namespace foo_touchremote
 	
 	System::Collections::Generic::IEnumerable<ITrack^>^ Library::Tracks::get()
 	{
-		return m_tracks->Values;
+		return gcnew TrackCollection(m_table, ReadTracks());
 	}
 
 	System::Collections::Generic::IEnumerable<IAlbum^>^ Library::Albums::get()
@@ -101,7 +242,7 @@ namespace foo_touchremote
 
 	int Library::TrackCount::get()
 	{
-		return m_tracks->Count;
+		return ReadTracks()->Count;
 	}
 
 	IPlaylist^ Library::Music::get()
@@ -138,12 +279,12 @@ namespace foo_touchremote
 			ITrack^ track = ManagedHost::Instance->GetUpdatedTrack(handle);
 
 			ITrack^ oldOne;
-			if (!m_tracks->TryGetValue(track->Source, oldOne))
+			if (!LatestTracks()->TryGetValue(track->Source, oldOne))
 				oldOne = nullptr;
 
 			if (!ReferenceEquals(track, oldOne))
 			{
-				m_tracks[track->Source] = track;
+				WriteTracks()[track->Source] = track;
 
 				if (!ReferenceEquals(oldOne, nullptr))
 				{
@@ -166,20 +307,58 @@ namespace foo_touchremote
 
 		IPlaybackSource^ key = gcnew FilePlaybackSource(handle->get_location());
 
-		ITrack^ track;
-		if (m_tracks->TryGetValue(key, track))
+		if (m_removedSources != nullptr)
+			m_removedSources->Add(key);
+
+		if (LatestTracks()->ContainsKey(key))
 		{
-			m_tracks->Remove(key);
+			WriteTracks()->Remove(key);
 			//delete track;
 		}
 	}
 
+	void Library::MergeTracks(Dictionary<IPlaybackSource^, ITrack^>^ tracks)
+	{
+		Dictionary<IPlaybackSource^, ITrack^>^ target = WriteTracks();
+		for each (KeyValuePair<IPlaybackSource^, ITrack^> entry in tracks)
+		{
+			if (!target->ContainsKey(entry.Key) && (m_removedSources == nullptr || !m_removedSources->Contains(entry.Key)))
+				target->Add(entry.Key, entry.Value);
+		}
+	}
+
+	void Library::BeginWarmUp()
+	{
+		IDisposable^ lock = BeginWrite();
+		try
+		{
+			m_removedSources = gcnew HashSet<IPlaybackSource^>();
+		}
+		finally
+		{
+			delete lock;
+		}
+	}
+
+	void Library::EndWarmUp()
+	{
+		IDisposable^ lock = BeginWrite();
+		try
+		{
+			m_removedSources = nullptr;
+		}
+		finally
+		{
+			delete lock;
+		}
+	}
+
 	ITrack^ Library::GetTrackCore(IPlaybackSource^ key)
 	{
 		if (key == nullptr) return nullptr;
 
 		ITrack^ track;
-		if (m_tracks->TryGetValue(key, track))
+		if (ReadTracks()->TryGetValue(key, track))
 			return track;
 
 		return nullptr;
@@ -192,7 +371,11 @@ namespace foo_touchremote
 		IDisposable^ lock = BeginWrite();
 		try
 		{
-			m_tracks->Remove(key);
+			if (m_removedSources != nullptr)
+				m_removedSources->Add(key);
+
+			if (LatestTracks()->ContainsKey(key))
+				WriteTracks()->Remove(key);
 		}
 		finally
 		{
@@ -205,6 +388,21 @@ namespace foo_touchremote
 		return m_idProvider;
 	}
 
+	StringPool^ Library::Strings::get()
+	{
+		return m_strings;
+	}
+
+	TrackTable^ Library::Table::get()
+	{
+		return m_table;
+	}
+
+	void Library::Table::set(TrackTable^ value)
+	{
+		m_table = value;
+	}
+
 	void Library::RegisterAlbumAndArtist(String^ artistName, String^ albumName, IArtist^ %artist, IAlbum^ %album)
 	{
 		artist = nullptr;
@@ -212,27 +410,39 @@ namespace foo_touchremote
 
 		if (String::IsNullOrEmpty(artistName)) return;
 
-		AAEntry^ t_artist;
-		if (!m_artists->TryGetValue(artistName, t_artist))
+		artistName = m_strings->Intern(artistName);
+		albumName = m_strings->Intern(albumName);
+
+		// tracks are refreshed lazily from any thread
+		TouchRemote::Core::Misc::Stats::Enter(m_artists, m_artistsWait);
+		try
 		{
-			t_artist = gcnew AAEntry(gcnew Artist(this, artistName));
+			AAEntry^ t_artist;
+			if (!m_artists->TryGetValue(artistName, t_artist))
+			{
+				t_artist = gcnew AAEntry(gcnew Artist(this, artistName));
 
-			m_artists[artistName] = t_artist;
-		}
+				m_artists[artistName] = t_artist;
+			}
 
-		artist = t_artist->Artist;
+			artist = t_artist->Artist;
 
-		if (String::IsNullOrEmpty(albumName)) return;
+			if (String::IsNullOrEmpty(albumName)) return;
 
-		IAlbum^ t_album;
-		if (!t_artist->Albums->TryGetValue(albumName, t_album))
-		{
-			t_album = gcnew Album(this, t_artist->Artist, albumName);
+			IAlbum^ t_album;
+			if (!t_artist->Albums->TryGetValue(albumName, t_album))
+			{
+				t_album = gcnew Album(this, t_artist->Artist, albumName);
 			
-			t_artist->Albums[albumName] = t_album;
-		}
+				t_artist->Albums[albumName] = t_album;
+			}
 
-		album = t_album;
+			album = t_album;
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(m_artists);
+		}
 	}
 
 	bool Library::Equals(IPlaylist^ other)
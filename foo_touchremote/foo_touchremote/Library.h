@@ -10,6 +10,8 @@ namespace foo_touchremote
 {
 
 	ref class IDProvider;
+	ref class StringPool;
+	ref class TrackTable;
 
 	public ref class Library : public IMediaLibrary, public IPropertyExtender
 	{
@@ -100,15 +102,96 @@ namespace foo_touchremote
 			IDProvider^ get();
 		}
 
+		property StringPool^ Strings
+		{
+			StringPool^ get();
+		}
+
+		// set by the TrackPool, whose rows the library's tracks are
+		property TrackTable^ Table
+		{
+			TrackTable^ get();
+			void set(TrackTable^ value);
+		}
+
 		void AddTrack(metadb_handle_ptr &handle);
 		void RemoveTrack(metadb_handle_ptr &handle);
 
+		// Adds tracks that were read outside of a write scope, sources the library has by now are left alone,
+		// as are sources removed since BeginWarmUp(). Called inside BeginWrite(), the whole batch costs a single
+		// copy of the track map.
+		void MergeTracks(Dictionary<IPlaybackSource^, ITrack^>^ tracks);
+
+		// Between these, removed sources are remembered, so that merging tracks read from an older snapshot
+		// of the media library does not bring them back.
+		void BeginWarmUp();
+		void EndWarmUp();
+
 		ITrack^ GetTrackCore(IPlaybackSource^ key);
 		void RemoveTrackCore(IPlaybackSource^ key);
 
 		void RegisterAlbumAndArtist(String^ artistName, String^ albumName, IArtist^ %artist, IAlbum^ %album);
 
 	private:
+		// keeps the version of the track map that was current when the first read scope on this thread began
+		ref class ReadScope
+		{
+		public:
+			ReadScope(Library^ library);
+			~ReadScope();
+
+		private:
+			Dictionary<IPlaybackSource^, ITrack^>^ m_previous;
+		};
+
+		// serializes writers; the copy they modified becomes visible when the outermost scope ends
+		ref class WriteScope
+		{
+		public:
+			WriteScope(Library^ library);
+			~WriteScope();
+
+		private:
+			Library^ m_library;
+		};
+
+		// Tracks returns one version of the track map, read only; searches run against the table's indexes
+		// and keep the tracks of that version
+		ref class TrackCollection : public ISearchableTrackCollection, public ICollection<ITrack^>
+		{
+		public:
+			TrackCollection(TrackTable^ table, Dictionary<IPlaybackSource^, ITrack^>^ tracks);
+
+			virtual IEnumerator<ITrack^>^ GetEnumerator();
+			virtual System::Collections::IEnumerator^ GetEnumeratorUntyped() = System::Collections::IEnumerable::GetEnumerator;
+
+			virtual property int Count
+			{
+				int get();
+			}
+
+			virtual property bool IsReadOnly
+			{
+				bool get();
+			}
+
+			virtual bool Contains(ITrack^ item);
+			virtual void CopyTo(array<ITrack^>^ target, int index);
+			virtual void Add(ITrack^ item);
+			virtual bool Remove(ITrack^ item);
+			virtual void Clear();
+
+			virtual ICollection<ITrack^>^ FindContaining(String^ property, String^ value);
+
+		private:
+			TrackTable^ m_table;
+			Dictionary<IPlaybackSource^, ITrack^>^ m_tracks;
+		};
+
+		Dictionary<IPlaybackSource^, ITrack^>^ ReadTracks();
+		Dictionary<IPlaybackSource^, ITrack^>^ LatestTracks();
+		Dictionary<IPlaybackSource^, ITrack^>^ WriteTracks();
+
 		ref class AAEntry
 		{
 		public:
@@ -129,10 +212,20 @@ namespace foo_touchremote
 			Dictionary<String^, IAlbum^>^ m_albums;
 		};
 
-		System::Threading::ReaderWriterLockSlim^ m_lockObject;
-
+		// Published track map, never modified once readers can see it. Writers copy it on their first change
+		// and swap the copy in, so a long tag update does not hold browsing requests back.
 		Dictionary<IPlaybackSource^, ITrack^>^ m_tracks;
+		Dictionary<IPlaybackSource^, ITrack^>^ m_pendingTracks;
+		Object^ m_writeSync;
+		int m_writeDepth;
+		TouchRemote::Core::Misc::Histogram^ m_writeWait;
+		HashSet<IPlaybackSource^>^ m_removedSources;	// only while warming up, guarded by the write lock
+
+		[ThreadStatic]
+		static Dictionary<IPlaybackSource^, ITrack^>^ s_readTracks;
+
 		Dictionary<String^, AAEntry^>^ m_artists;
+		TouchRemote::Core::Misc::Histogram^ m_artistsWait;
 
 		IPlaylist^ m_musicPlaylist;
 		IPlaylist^ m_moviesPlaylist;
@@ -140,6 +233,8 @@ namespace foo_touchremote
 		IPlaylist^ m_jukeboxPlaylist;
 
 		IDProvider^ m_idProvider;
+		StringPool^ m_strings;
+		TrackTable^ m_table;
 
 	};
 
@@ -4,6 +4,7 @@
 #include "ManagedHost.h"
 #include "Library.h"
 #include "Track.h"
+#include "StringPool.h"
 
 #pragma managed
 
@@ -35,6 +36,14 @@ namespace foo_touchremote
 				_console::print("Changes merged into library");
 			}
 
+			ManagedHost^ host = ManagedHost::Instance;
+			for (t_size i = 0; i < p_data.get_count(); i++)
+			{
+				ITrack^ track = host->GetTrack(p_data[i]);
+				if (track != nullptr)
+					TouchRemote::Core::ChangeJournal::ItemChanged(track->Id);
+			}
+
 			TouchRemote::Core::SessionManager::DatabaseUpdated();
 		}
 
@@ -44,6 +53,15 @@ namespace foo_touchremote
 
 			Library^ lib = (Library^)ManagedHost::Instance->MediaLibrary;
 
+			// ids are looked up first, the track views may go away with the library entries
+			List<int>^ removed = gcnew List<int>((int)p_data.get_count());
+			for (t_size i = 0; i < p_data.get_count(); i++)
+			{
+				ITrack^ track = ManagedHost::Instance->FindTrack(p_data[i]);
+				if (track != nullptr)
+					removed->Add(track->Id);
+			}
+
 			IDisposable^ lock = lib->BeginWrite();
 			try
 			{
@@ -56,6 +74,9 @@ namespace foo_touchremote
 				_console::print("Changes merged into library");
 			}
 
+			for each (int id in removed)
+				TouchRemote::Core::ChangeJournal::ItemRemoved(id);
+
 			TouchRemote::Core::SessionManager::DatabaseUpdated();
 		}
 
@@ -63,19 +84,10 @@ namespace foo_touchremote
 		{
 			_console::printf("Modified {0} items", p_data.get_count());
 
-			Library^ lib = (Library^)ManagedHost::Instance->MediaLibrary;
-
-			IDisposable^ lock = lib->BeginWrite();
-			try
-			{
-				for (t_size i = 0; i < p_data.get_count(); i++)
-					lib->AddTrack(p_data[i]);
-			}
-			finally
-			{
-				delete lock;
-				_console::print("Changes merged into library");
-			}
+			// only flagged here, tags are re-read when a remote asks for the track or in the background
+			ManagedHost^ host = ManagedHost::Instance;
+			for (t_size i = 0; i < p_data.get_count(); i++)
+				host->LazyUpdateTrack(p_data[i]);
 
 			/*static_api_ptr_t<playlist_manager> m;
 			
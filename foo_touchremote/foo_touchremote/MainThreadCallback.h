@@ -8,6 +8,95 @@
 #define CALLBACK_TRACE(x) 
 #endif
 
+// Callback objects are recycled instead of deleted: each keeps its wait event and
+// gcroot handles, and goes back to the pool of its type when the last reference is released.
+class pooled_main_thread_callback : public main_thread_callback {
+public:
+	pooled_main_thread_callback() : m_async(false) { m_hWaitFor = CreateEvent(NULL, FALSE, FALSE, NULL); }
+	virtual ~pooled_main_thread_callback() { CloseHandle(m_hWaitFor); }
+	virtual void recycle() = 0;
+protected:
+	HANDLE m_hWaitFor;
+	bool m_async;
+	pfc::hires_timer m_queued;		// started when posted from another thread
+};
+
+template<typename class_t>
+class service_impl_pooled_t : public implement_service_query<class_t> {
+public:
+	int service_release() throw() {
+		int ret = (int) --m_counter;
+		if (ret == 0) this->recycle();
+		return ret;
+	}
+	int service_add_ref() throw() { return (int) ++m_counter; }
+private:
+	pfc::refcounter m_counter;
+};
+
+template<typename T>
+class callback_pool {
+public:
+	enum { max_count = 16 };
+
+	static T * get() {
+		{
+			insync(s_sync);
+			t_size count = s_items.get_count();
+			if (count > 0) {
+				T * obj = s_items[count - 1];
+				s_items.remove_by_idx(count - 1);
+				return obj;
+			}
+		}
+		return new T();
+	}
+
+	static void put(T * obj) {
+		{
+			insync(s_sync);
+			if (s_items.get_count() < max_count) {
+				s_items.add_item(obj);
+				return;
+			}
+		}
+		delete obj;
+	}
+
+private:
+	static critical_section_static s_sync;
+	static pfc::list_t<T*> s_items;
+};
+
+template<typename T> critical_section_static callback_pool<T>::s_sync;
+template<typename T> pfc::list_t<T*> callback_pool<T>::s_items;
+
+// Latency counters of a callback type, looked up by name on first use only. Stats::Latency returns
+// the same counter for a name, so threads racing to fill a slot store the same object.
+template<typename T>
+class callback_stats {
+public:
+	static TouchRemote::Core::Misc::Histogram^ wait(const char * p_name) { return get(s_wait, p_name); }
+	static TouchRemote::Core::Misc::Histogram^ run(const char * p_name) { return get(s_run, p_name); }
+
+private:
+	static TouchRemote::Core::Misc::Histogram^ get(gcroot<TouchRemote::Core::Misc::Histogram^> & p_slot, const char * p_name) {
+		TouchRemote::Core::Misc::Histogram^ histogram = p_slot;
+		if (histogram == nullptr) {
+			histogram = TouchRemote::Core::Misc::Stats::Latency(gcnew System::String(p_name));
+			p_slot = histogram;
+		}
+		return histogram;
+	}
+
+	static gcroot<TouchRemote::Core::Misc::Histogram^> s_wait;
+	static gcroot<TouchRemote::Core::Misc::Histogram^> s_run;
+};
+
+template<typename T> gcroot<TouchRemote::Core::Misc::Histogram^> callback_stats<T>::s_wait;
+template<typename T> gcroot<TouchRemote::Core::Misc::Histogram^> callback_stats<T>::s_run;
+
+
 #define CALLBACK_COMMON(name, T, A) \
 		CALLBACK_TRACE("TouchRemote Debug: entered " #name) \
 		m_this = p_this; \
@@ -16,20 +105,13 @@
 		try \
 		{ \
 			if (core_api::is_main_thread()) { \
-				m_hWaitFor = NULL; \
+				m_async = false; \
 				callback_run(); \
 			} else { \
-				/*System::Threading::Monitor::Enter(p_this);*/ \
-				try { \
-					m_hWaitFor = CreateEvent(NULL, TRUE, FALSE, NULL); \
-					static_api_ptr_t<main_thread_callback_manager>()->add_callback(this); \
-					WaitForSingleObject(m_hWaitFor, INFINITE); \
-					CloseHandle(m_hWaitFor); \
-				} \
-				finally \
-				{ \
-					/*System::Threading::Monitor::Exit(p_this);*/ \
-				} \
+				m_async = true; \
+				m_queued.start(); \
+				static_api_ptr_t<main_thread_callback_manager>()->add_callback(this); \
+				WaitForSingleObject(m_hWaitFor, INFINITE); \
 			} \
 			return (T) m_result; \
 		} finally { \
@@ -37,49 +119,68 @@
 			CALLBACK_TRACE("TouchRemote Debug: leaved " #name) \
 		} \
 	} \
+	static T Invoke(Object^ p_this, A arg) { \
+		return callback_pool< name >::get()->Run(p_this, arg); \
+	} \
+	static T Invoke(Object^ p_this) { \
+		return callback_pool< name >::get()->Run(p_this); \
+	} \
+	virtual void recycle() { \
+		reset(); \
+		callback_pool< name >::put(this); \
+	} \
+	static TouchRemote::Core::Misc::Histogram^ wait_stats() { \
+		return callback_stats< name >::wait("main thread wait " #name); \
+	} \
+	static TouchRemote::Core::Misc::Histogram^ run_stats() { \
+		return callback_stats< name >::run("main thread run " #name); \
+	} \
 private: T DoWork(A arg) {
 
 
-#define CALLBACK_START_MU(name, T, A) \
-class name : public service_impl_t<main_thread_callback> { \
+#define CALLBACK_CLASS(name) \
+class name : public service_impl_pooled_t<pooled_main_thread_callback> { \
+public: \
+	name() { reset(); } \
 private: \
-	HANDLE m_hWaitFor; \
+
+
+#define CALLBACK_START_MU(name, T, A) \
+CALLBACK_CLASS(name) \
 	gcroot< T > m_result; \
 	A m_arg; \
 	gcroot< Object^ > m_this; \
+	void reset() { m_result = nullptr; m_arg = A(); m_this = nullptr; } \
 public: T Run(Object^ p_this, A arg = NULL) { \
 	CALLBACK_COMMON(name, T, A)
 
 
 #define CALLBACK_START_MM(name, T, A) \
-class name : public service_impl_t<main_thread_callback> { \
-private: \
-	HANDLE m_hWaitFor; \
+CALLBACK_CLASS(name) \
 	gcroot< T > m_result; \
 	gcroot< A > m_arg; \
 	gcroot< Object^ > m_this; \
+	void reset() { m_result = nullptr; m_arg = nullptr; m_this = nullptr; } \
 public: T Run(Object^ p_this, A arg = nullptr) { \
 	CALLBACK_COMMON(name, T, A)
 
 
 #define CALLBACK_START_UU(name, T, A) \
-class name : public service_impl_t<main_thread_callback> { \
-private: \
-	HANDLE m_hWaitFor; \
+CALLBACK_CLASS(name) \
 	T m_result; \
 	A m_arg; \
 	gcroot< Object^ > m_this; \
+	void reset() { m_result = T(); m_arg = A(); m_this = nullptr; } \
 public: T Run(Object^ p_this, A arg = NULL) { \
 	CALLBACK_COMMON(name, T, A)
 
 
 #define CALLBACK_START_UM(name, T, A) \
-class name : public service_impl_t<main_thread_callback> { \
-private: \
-	HANDLE m_hWaitFor; \
+CALLBACK_CLASS(name) \
 	T m_result; \
 	gcroot< A > m_arg; \
 	gcroot< Object^ > m_this; \
+	void reset() { m_result = T(); m_arg = nullptr; m_this = nullptr; } \
 public: T Run(Object^ p_this, A arg = nullptr) { \
 	CALLBACK_COMMON(name, T, A)
 
@@ -88,6 +189,9 @@ public: T Run(Object^ p_this, A arg = nullptr) { \
 	} \
 public: virtual void callback_run() { \
 		CALLBACK_TRACE("TouchRemote Debug: in callback") \
+		if (m_async) wait_stats()->AddSeconds(m_queued.query()); \
+		pfc::hires_timer timer; \
+		timer.start(); \
 		try { \
 			m_result = DoWork(m_arg); \
 		} catch (Exception^ ex) { \
@@ -96,7 +200,8 @@ public: virtual void callback_run() { \
 			console::error(ex.what()); \
 		} finally { \
 			CALLBACK_TRACE("TouchRemote Debug: out of callback") \
-			if (m_hWaitFor != NULL) SetEvent(m_hWaitFor); \
+			run_stats()->AddSeconds(timer.query()); \
+			if (m_async) SetEvent(m_hWaitFor); \
 		} \
 	} \
-};
\ No newline at end of file
+};
@@ -12,6 +12,12 @@
 #include "PlaylistLock.h"
 #include "TrackPool.h"
 #include "PlaylistPool.h"
+#include "RatingWriter.h"
+#include "MdnsResponder.h"
+#include "PcmBroadcast.h"
+#include "AudioCapture.h"
+#include "AudioStream.h"
+#include "CallbackBenchmark.h"
 
 #pragma managed
 
@@ -22,6 +28,11 @@ using namespace System::Collections::Specialized;
 //#define USE_AUTOPLAYLIST 
 
 extern advconfig_string_factory _AdvConfig_HostName;
+extern advconfig_checkbox_factory _AdvConfig_BuiltInMdns;
+extern advconfig_checkbox_factory _AdvConfig_AudioStream;
+extern advconfig_checkbox_factory _AdvConfig_AudioStreamTone;
+extern advconfig_integer_factory _AdvConfig_StatsInterval;
+extern advconfig_checkbox_factory _AdvConfig_CallbackBenchmark;
 
 namespace foo_touchremote
 {
@@ -42,6 +53,10 @@ namespace foo_touchremote
 			}
 		}
 
+		// library requests wait for the warm-up, server-info and login are answered right away
+		if (ManagedHost::Instance->State != StartupState::Ready && request->Path->StartsWith("/databases"))
+			return gcnew Core::Http::Response::ServiceUnavailableResponse(TimeSpan::FromSeconds(2));
+
         try
         {
 			Core::Dacp::Responders::IResponder^ responder = Core::Dacp::PathMapper::Map(request);
@@ -85,10 +100,28 @@ namespace foo_touchremote
 		m_mediaLibrary = gcnew Library();
 		m_trackPool = gcnew TrackPool(m_mediaLibrary);
 		m_playlistPool = gcnew PlaylistPool(m_mediaLibrary);
+		m_ratingWriter = gcnew RatingWriter();
+		m_volumeSetter = gcnew TouchRemote::Core::Misc::DelayedPropertySetter<float>();
+		m_volumeSetter->Setter = gcnew Action<float>(this, &ManagedHost::ApplyVolume);
+		m_volumeSetter->Applied += gcnew EventHandler(this, &ManagedHost::OnSetterApplied);
+		m_seekSetter = gcnew TouchRemote::Core::Misc::DelayedPropertySetter<double>();
+		m_seekSetter->Setter = gcnew Action<double>(this, &ManagedHost::ApplySeek);
+		m_seekSetter->Applied += gcnew EventHandler(this, &ManagedHost::OnSetterApplied);
+		m_seekTimestamp = 0;
 		m_currentTrack = nullptr;
+		m_nowPlaying = TouchRemote::Interfaces::NowPlaying::Stopped;
+		m_currentContainerId = 0;
+		m_currentPositionTimestamp = Stopwatch::GetTimestamp();
+		m_nowPlayingSync = gcnew Object();
 
 		m_dacpServer = nullptr;
 		m_dnsServer = nullptr;
+		m_mdnsResponder = NULL;
+		m_statsTimer = nullptr;
+
+		p_broadcast = NULL;
+		p_capture = NULL;
+		p_toneGenerator = NULL;
 
 		m_syncObject = gcnew System::Threading::ReaderWriterLockSlim(System::Threading::LockRecursionPolicy::NoRecursion);
 
@@ -96,6 +129,9 @@ namespace foo_touchremote
 		m_currentPlaylistValid = false;
 		m_currentPlaylistSync = gcnew Object();
 		m_initialized = false;
+		m_state = (int)StartupState::Stopped;
+		m_startupSync = gcnew Object();
+		m_startupThread = nullptr;
 	}
 
 	ManagedHost^ ManagedHost::Instance::get()
@@ -103,6 +139,11 @@ namespace foo_touchremote
 		return m_instance;
 	}
 
+	StartupState ManagedHost::State::get()
+	{
+		return (StartupState)System::Threading::Thread::VolatileRead(m_state);
+	}
+
 	IDisposable^ ManagedHost::BeginRead()
 	{
 		return gcnew TouchRemote::Core::Misc::ReadWriteLock(m_syncObject, false);
@@ -164,6 +205,21 @@ namespace foo_touchremote
 			SetCurrentPlaybackOrder(pm->playback_order_get_active());
 		}
 
+		if (_AdvConfig_AudioStream.get())
+		{
+			// capture callbacks are registered on the main thread, they cost nothing while nobody listens
+			p_broadcast = new PcmBroadcast();
+			if (_AdvConfig_AudioStreamTone.get())
+			{
+				p_toneGenerator = new ToneGenerator(*p_broadcast);
+				p_toneGenerator->Start();
+			}
+			else
+			{
+				p_capture = new foobar::AudioCapture(*p_broadcast);
+			}
+		}
+
         m_name = displayName;
 
 		NameValueCollection^ props = gcnew NameValueCollection();
@@ -176,18 +232,242 @@ namespace foo_touchremote
 		props["iV"] = "196613";
 		props["Ver" ] = "131074";
 
-		m_dacpServer = gcnew Core::Dacp::DacpServer(this, portNumber);
-		m_dacpServer->RequestHandler = gcnew Core::HandleRequestDelegate(&HttpHandler);
-		m_dacpServer->Start();
+		m_serviceName = strDatabaseId;
+		m_hostName = hostName;
+		m_port = portNumber;
+		m_serviceProperties = props;
+
+		// network and library bring-up happen off the main thread so the player is not held up
+		m_state = (int)StartupState::Starting;
+		m_startupThread = gcnew System::Threading::Thread(gcnew System::Threading::ThreadStart(this, &ManagedHost::RunStartup));
+		m_startupThread->Name = "TouchRemote startup";
+		m_startupThread->IsBackground = true;
+		m_startupThread->Start();
+
+		Logger->LogMessage("TouchRemote initialization scheduled");
+	}
+
+	void ManagedHost::RunStartup()
+	{
+		Stopwatch^ total = Stopwatch::StartNew();
+		Stopwatch^ phase = Stopwatch::StartNew();
+
+		try
+		{
+			Core::Dacp::DacpServer^ dacpServer = gcnew Core::Dacp::DacpServer(this, m_port);
+			dacpServer->RequestHandler = gcnew Core::HandleRequestDelegate(&HttpHandler);
+			dacpServer->Start();
+
+			if (!EnterPhase(StartupState::Starting))
+			{
+				dacpServer->Stop();
+				return;
+			}
+			m_dacpServer = dacpServer;
+			m_initialized = true;
+			System::Threading::Monitor::Exit(m_startupSync);
+
+			if (!Advance(StartupState::Starting, StartupState::Listening)) return;
+			_console::printf("TouchRemote listening on port {0} ({1} ms)", m_port, phase->ElapsedMilliseconds);
 
-		m_dnsServer = gcnew Bonjour::BonjourService();
-		m_dnsServer->Start(strDatabaseId, "_touch-able._tcp", "local.", hostName, portNumber, props);
-		//m_dnsServer->Start(strDatabaseId, "_daap._tcp", "local.", hostName, portNumber, props);
-		//m_dnsServer->Start(strDatabaseId, "_remote-jukebox._tcp", "local.", hostName, portNumber, props);
+			phase->Reset();
+			phase->Start();
+			WarmUpLibrary();
+			if (!Advance(StartupState::Listening, StartupState::Ready)) return;
 
-		m_initialized = true;
+			UpdateCurrentContainer();
+			PublishNowPlaying();
+			_console::printf("TouchRemote library ready: {0} tracks ({1} ms)", m_mediaLibrary->TrackCount, phase->ElapsedMilliseconds);
+			TouchRemote::Core::SessionManager::DatabaseUpdated();
+
+			int statsInterval = (int)_AdvConfig_StatsInterval.get();
+			if (statsInterval > 0)
+			{
+				int period = statsInterval * 60 * 1000;
+				System::Threading::Timer^ statsTimer = gcnew System::Threading::Timer(gcnew System::Threading::TimerCallback(this, &ManagedHost::DumpStats), nullptr, period, period);
+
+				if (!EnterPhase(StartupState::Ready))
+				{
+					delete statsTimer;
+					return;
+				}
+				m_statsTimer = statsTimer;
+				System::Threading::Monitor::Exit(m_startupSync);
+			}
+
+			phase->Reset();
+			phase->Start();
+			if (_AdvConfig_BuiltInMdns.get())
+			{
+				MdnsResponder * responder = StartMdnsResponder();
+
+				if (!EnterPhase(StartupState::Ready))
+				{
+					responder->Stop();
+					delete responder;
+					return;
+				}
+				m_mdnsResponder = responder;
+				System::Threading::Monitor::Exit(m_startupSync);
+			}
+			else
+			{
+				Bonjour::BonjourService^ dnsServer = gcnew Bonjour::BonjourService();
+				dnsServer->Start(m_serviceName, "_touch-able._tcp", "local.", m_hostName, m_port, m_serviceProperties);
+
+				if (!EnterPhase(StartupState::Ready))
+				{
+					dnsServer->Stop();
+					return;
+				}
+				m_dnsServer = dnsServer;
+				System::Threading::Monitor::Exit(m_startupSync);
+			}
+			//m_dnsServer->Start(m_serviceName, "_daap._tcp", "local.", m_hostName, m_port, m_serviceProperties);
+			//m_dnsServer->Start(m_serviceName, "_remote-jukebox._tcp", "local.", m_hostName, m_port, m_serviceProperties);
+			_console::printf("TouchRemote service published ({0} ms)", phase->ElapsedMilliseconds);
 
-		Logger->LogMessage("TouchRemote initialization finished");
+			_console::printf("TouchRemote initialization finished in {0} ms", total->ElapsedMilliseconds);
+
+			if (_AdvConfig_CallbackBenchmark.get())
+				BenchmarkMainThreadCallbacks();
+		}
+		catch (Exception^ ex)
+		{
+			_console::error(ex->ToString());
+
+			// without a listener or a library every /databases request would be put off with 503 for good;
+			// a failed publish leaves a working server that remotes paired before can still reach
+			if (Advance(StartupState::Starting, StartupState::Failed) || Advance(StartupState::Listening, StartupState::Failed))
+			{
+				System::Threading::Monitor::Enter(m_startupSync);
+				Core::Dacp::DacpServer^ dacpServer = m_dacpServer;
+				m_dacpServer = nullptr;
+				m_initialized = false;
+				System::Threading::Monitor::Exit(m_startupSync);
+
+				if (dacpServer != nullptr)
+					dacpServer->Stop();
+
+				_console::error("TouchRemote failed to start, remotes cannot connect until foobar2000 is restarted");
+			}
+		}
+	}
+
+	// Moves the startup on to its next phase, false if the state is no longer 'from': OnQuit has set Stopped meanwhile.
+	bool ManagedHost::Advance(StartupState from, StartupState to)
+	{
+		return System::Threading::Interlocked::CompareExchange(m_state, (int)to, (int)from) == (int)from;
+	}
+
+	// The startup thread starts each service on its own and only then stores it where OnQuit finds it. If the startup is
+	// still in the given phase this returns true holding m_startupSync, the caller stores the service and lets go of it.
+	// Otherwise OnQuit has set Stopped and may already be past the fields, the caller shuts the service down itself.
+	bool ManagedHost::EnterPhase(StartupState phase)
+	{
+		System::Threading::Monitor::Enter(m_startupSync);
+		if (State == phase) return true;
+
+		System::Threading::Monitor::Exit(m_startupSync);
+		return false;
+	}
+
+	void ManagedHost::DumpStats(Object^ state)
+	{
+		_console::print(TouchRemote::Core::Misc::Stats::ToText());
+	}
+
+	void ManagedHost::OnSetterApplied(Object^ sender, EventArgs^ e)
+	{
+		// the snapshot showed the requested value until now, publish what the player actually took
+		PublishNowPlaying();
+		TouchRemote::Core::SessionManager::StateUpdated();
+	}
+
+	MdnsResponder * ManagedHost::StartMdnsResponder()
+	{
+		MdnsResponder::Service service;
+		service.Instance = ToUtf8String(m_serviceName);
+		service.Type = "_touch-able._tcp";
+		service.Host = String::IsNullOrEmpty(m_hostName) ? "" : ToUtf8String(m_hostName);
+		service.Port = (t_uint16)m_port;
+
+		for each (String^ key in m_serviceProperties->AllKeys)
+		{
+			service.Txt.add_item(ToUtf8String(String::Format("{0}={1}", key, m_serviceProperties[key])));
+		}
+
+		MdnsResponder * responder = new MdnsResponder();
+		try
+		{
+			responder->Start(service);
+		}
+		catch (const std::exception & ex)
+		{
+			delete responder;
+			throw gcnew InvalidOperationException(FromUtf8String(ex.what()));
+		}
+		return responder;
+	}
+
+	CALLBACK_START_UU(Library_get_all, pfc::list_t<metadb_handle_ptr>*, int)
+		pfc::list_t<metadb_handle_ptr> * items = new pfc::list_t<metadb_handle_ptr>();
+		static_api_ptr_t<library_manager>()->get_all_items(*items);
+		return items;
+	CALLBACK_END()
+
+	void ManagedHost::WarmUpLibrary()
+	{
+		// Tags are read outside of the library lock, so library callbacks on the main thread are not stalled.
+		// Every merge copies the track map, so batches grow with the library: it fills up from the start
+		// while the copying stays linear in the number of tracks.
+		static const int firstBatch = 256;
+
+		// removals that come in after the snapshot below are kept out of the merged batches
+		Library^ lib = (Library^)m_mediaLibrary;
+		lib->BeginWarmUp();
+
+		pfc::list_t<metadb_handle_ptr> * items = NULL;
+		try
+		{
+			items = Library_get_all::Invoke(this);
+			if (items == NULL) return;
+
+			t_size count = items->get_count();
+			Dictionary<IPlaybackSource^, ITrack^>^ batch = gcnew Dictionary<IPlaybackSource^, ITrack^>(firstBatch);
+
+			for (t_size i = 0; i < count && State != StartupState::Stopped; i++)
+			{
+				try
+				{
+					ITrack^ track = GetUpdatedTrack((*items)[i]);
+					batch[track->Source] = track;
+				}
+				catch (Exception^ ex)
+				{
+					_console::error(ex->ToString());
+				}
+
+				if (batch->Count < Math::Max(firstBatch, lib->TrackCount) && i + 1 < count)
+					continue;
+
+				IDisposable^ lock = lib->BeginWrite();
+				try
+				{
+					lib->MergeTracks(batch);
+				}
+				finally
+				{
+					delete lock;
+				}
+				batch->Clear();
+			}
+		}
+		finally
+		{
+			delete items;
+			lib->EndWarmUp();
+		}
 	}
 
 	void ManagedHost::OnQuit()
@@ -195,6 +475,24 @@ namespace foo_touchremote
 		Logger->LogMessage("TouchRemote shutdown started");
 
 		m_initialized = false;
+		System::Threading::Interlocked::Exchange(m_state, (int)StartupState::Stopped);
+
+		// the worker may be waiting for the main thread, so it is not waited for too long
+		if (m_startupThread != nullptr)
+			m_startupThread->Join(TimeSpan::FromSeconds(1));
+
+		// from here on the startup thread cannot hand anything over any more (see EnterPhase),
+		// what it started is either in the fields below or shut down by the thread itself
+		System::Threading::Monitor::Enter(m_startupSync);
+		System::Threading::Monitor::Exit(m_startupSync);
+
+		if (m_statsTimer != nullptr)
+		{
+			delete m_statsTimer;
+			m_statsTimer = nullptr;
+		}
+
+		m_ratingWriter->Flush();
 
 		SetCurrentState(false, false);
 		SetCurrentTrack(metadb_handle_ptr());
@@ -203,15 +501,55 @@ namespace foo_touchremote
 		if (m_dnsServer != nullptr)
 			m_dnsServer->Stop();
 
+		if (m_mdnsResponder != NULL)
+		{
+			m_mdnsResponder->Stop();
+			delete m_mdnsResponder;
+			m_mdnsResponder = NULL;
+		}
+
+		if (p_broadcast != NULL)
+		{
+			delete p_capture;
+			p_capture = NULL;
+			delete p_toneGenerator;
+			p_toneGenerator = NULL;
+
+			// ends the open /stream.wav responses
+			p_broadcast->Shutdown();
+		}
+
 		if (m_dacpServer != nullptr)
 		{
 			m_dacpServer->Stop();
 			m_dacpServer->WaitForConnectionsClosed(TimeSpan::FromSeconds(1));
 		}
 
+		// a listener thread that has not let go of its reader yet keeps the ring alive
+		if (p_broadcast != NULL && !p_broadcast->HasReaders())
+		{
+			delete p_broadcast;
+			p_broadcast = NULL;
+		}
+
 		Logger->LogMessage("TouchRemote shutdown finished");		
 	}
 
+	bool ManagedHost::IsAudioStreamEnabled::get()
+	{
+		return p_broadcast != NULL;
+	}
+
+	IAudioStream^ ManagedHost::OpenAudioStream()
+	{
+		if (p_broadcast == NULL) return nullptr;
+
+		PcmBroadcast::Reader * reader = p_broadcast->Open();
+		if (reader == NULL) return nullptr;
+
+		return gcnew AudioStream(p_broadcast, reader);
+	}
+
 	String^ ManagedHost::Name::get()
 	{
 		return m_name;
@@ -250,9 +588,19 @@ namespace foo_touchremote
 		return m_trackPool->GetTrack(ptr, true);
 	}
 
+	ITrack^ ManagedHost::FindTrack(metadb_handle_ptr &ptr)
+	{
+		return m_trackPool->GetTrack(ptr, false, true);
+	}
+
 	void ManagedHost::LazyUpdateTrack(metadb_handle_ptr &ptr)
 	{
-		m_trackPool->GetTrack(ptr, true, true);
+		m_trackPool->MarkModified(ptr);
+
+		// a track without a view is in no listing a remote has seen
+		ITrack^ track = FindTrack(ptr);
+		if (track != nullptr)
+			TouchRemote::Core::ChangeJournal::ItemChanged(track->Id);
 	}
 
 	IPlaylist^ ManagedHost::GetPlaylist(t_size index)
@@ -273,7 +621,10 @@ namespace foo_touchremote
 
 		Playlist^ pl = m_playlistPool[index];
 		if (pl != nullptr)
+		{
 			pl->Invalidate();
+			TouchRemote::Core::ChangeJournal::ContainerItemsChanged(pl->Id);
+		}
 	}
 
 	void ManagedHost::AddPlaylist(t_size index, System::String ^newName)
@@ -292,7 +643,13 @@ namespace foo_touchremote
 
 		Playlist^ pl = m_playlistPool[index];
 		if (pl != nullptr)
+		{
+			// playlist ids follow the name
+			int oldId = pl->Id;
 			pl->Name = newName;
+			TouchRemote::Core::ChangeJournal::ContainerRemoved(oldId);
+			TouchRemote::Core::ChangeJournal::ContainerChanged(pl->Id);
+		}
 	}
 
 #pragma endregion
@@ -332,7 +689,7 @@ namespace foo_touchremote
 
 	System::Collections::Generic::IEnumerable<IPlaylist^>^ ManagedHost::Playlists::get()
 	{
-		//return (new Playlists_get())->Run(this);
+		//return Playlists_get::Invoke(this);
 		array<Playlist^>^ raw = m_playlistPool->Playlists;
 		List<IPlaylist^>^ items = gcnew List<IPlaylist^>(raw->Length);
 		for each (Playlist^ pl in raw)
@@ -387,7 +744,7 @@ namespace foo_touchremote
 			throw gcnew ArgumentOutOfRangeException("value");
 		}
 
-		(new ActivePlaybackOrder_set())->Run(this, mode);
+		ActivePlaybackOrder_set::Invoke(this, mode);
 	}
 
 	ShuffleMode ManagedHost::AvailableShuffleModes::get()
@@ -434,7 +791,7 @@ namespace foo_touchremote
 			throw gcnew ArgumentOutOfRangeException("value");
 		}
 
-		(new ActivePlaybackOrder_set())->Run(this, mode);
+		ActivePlaybackOrder_set::Invoke(this, mode);
 	}
     
    	CALLBACK_START_UU(CurrentVolume_get, float, int)
@@ -444,9 +801,11 @@ namespace foo_touchremote
 
 	int ManagedHost::CurrentVolume::get()
 	{
-		float vol = m_currentVolume;
+		float vol;
+		if (!m_volumeSetter->TryGetPending(vol))
+			vol = m_currentVolume;
 
-        //float vol = (new CurrentVolume_get())->Run(this, 0);
+        //float vol = CurrentVolume_get::Invoke(this, 0);
 
 		if (vol >= 0.0f) return 100;
 
@@ -470,7 +829,20 @@ namespace foo_touchremote
 		else
 			vol = log(value / 100.0f) * 10.0f / log(2.0f);
 
-		m_currentVolume = (new CurrentVolume_set())->Run(this, vol);
+		m_volumeSetter->SetValue(vol);
+		PublishNowPlaying();
+	}
+
+	void ManagedHost::ApplyVolume(float volume)
+	{
+		try
+		{
+			m_currentVolume = CurrentVolume_set::Invoke(this, volume);
+		}
+		catch (Exception^ ex)
+		{
+			_console::error(ex->ToString());
+		}
 	}
 
 	ITrack^ ManagedHost::CurrentTrack::get()
@@ -480,7 +852,13 @@ namespace foo_touchremote
 
 	void ManagedHost::SetCurrentTrack(metadb_handle_ptr & track)
 	{
-        SetCurrentTrack(GetTrack(track));
+        if (m_currentTrack != nullptr)
+            ((Track^)m_currentTrack)->CancelDynamic();
+
+		// a new track may come from another playlist
+		m_currentTrack = GetTrack(track);
+		UpdateCurrentContainer();
+		PublishNowPlaying();
 	}
 
 	void ManagedHost::SetCurrentTrack(ITrack^ track)
@@ -489,6 +867,7 @@ namespace foo_touchremote
             ((Track^)m_currentTrack)->CancelDynamic();
 
 		m_currentTrack = track;
+		PublishNowPlaying();
 	}
 
     void ManagedHost::SetCurrentTrackDynamic(const file_info & info)
@@ -496,29 +875,92 @@ namespace foo_touchremote
         if (m_currentTrack == nullptr) return;
 
         ((Track^)m_currentTrack)->SetDynamic(info);
+		PublishNowPlaying();
     }
 
 	void ManagedHost::SetCurrentPosition(double position)
 	{
 		m_currentPosition = position;
+		m_currentPositionTimestamp = Stopwatch::GetTimestamp();
+		PublishNowPlaying();
 	}
 
 	void ManagedHost::SetCurrentState(bool isPlaying, bool isPaused)
 	{
+		// rebased on every state change, readers extrapolate from here while playing
+		m_currentPosition = (isPlaying) ? static_api_ptr_t<playback_control>()->playback_get_position() : 0.0;
+		m_currentPositionTimestamp = Stopwatch::GetTimestamp();
+
 		if (isPlaying)
 			m_currentState = (isPaused) ? PlaybackState::Paused : PlaybackState::Playing;
 		else
 			m_currentState = PlaybackState::Stopped;
+
+		PublishNowPlaying();
 	}
 
 	void ManagedHost::SetCurrentVolume(float volume)
 	{
 		m_currentVolume = volume;
+		PublishNowPlaying();
 	}
 
 	void ManagedHost::SetCurrentPlaybackOrder(t_size order)
 	{
 		m_currentPlaybackOrder = order;
+		PublishNowPlaying();
+	}
+
+	void ManagedHost::UpdateCurrentContainer()
+	{
+		// the playlist pool is not touched while the library is still warming up
+		IPlaylist^ playlist = nullptr;
+		if (m_currentTrack != nullptr && State == StartupState::Ready)
+			playlist = ActivePlaylist;
+
+		m_currentContainerId = (playlist != nullptr) ? playlist->Id : m_mediaLibrary->Id;
+	}
+
+	void ManagedHost::PublishNowPlaying()
+	{
+		// setters run on the main thread, except the one after startup, hence the lock;
+		// it is never held while waiting for the main thread
+		System::Threading::Monitor::Enter(m_nowPlayingSync);
+		try
+		{
+			double position = m_currentPosition;
+			Int64 timestamp = m_currentPositionTimestamp;
+
+			// a seek still on its way to the main thread
+			double seek;
+			if (m_seekSetter->TryGetPending(seek))
+			{
+				position = seek;
+				timestamp = System::Threading::Interlocked::Read(m_seekTimestamp);
+			}
+
+			TouchRemote::Interfaces::NowPlaying^ snapshot = gcnew TouchRemote::Interfaces::NowPlaying(
+				m_currentTrack,
+				m_currentContainerId,
+				m_currentState,
+				TimeSpan::FromSeconds(position),
+				timestamp,
+				(m_currentState == PlaybackState::Playing) ? 1.0 : 0.0,
+				CurrentShuffleMode,
+				CurrentRepeatMode,
+				CurrentVolume);
+
+			System::Threading::Interlocked::Exchange<TouchRemote::Interfaces::NowPlaying^>(m_nowPlaying, snapshot);
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(m_nowPlayingSync);
+		}
+	}
+
+	TouchRemote::Interfaces::NowPlaying^ ManagedHost::NowPlaying::get()
+	{
+		return m_nowPlaying;
 	}
 
 	//CALLBACK_START(CurrentPlaybackState_get, PlaybackState, int)
@@ -540,7 +982,7 @@ namespace foo_touchremote
 
 	TimeSpan ManagedHost::CurrentPosition::get()
 	{
-		return TimeSpan::FromSeconds(m_currentPosition);
+		return m_nowPlaying->Position;
 	}
 
 	CALLBACK_START_UU(CurrentPosition_set, bool, double)
@@ -557,9 +999,22 @@ namespace foo_touchremote
 
 	void ManagedHost::CurrentPosition::set(TimeSpan value)
 	{
-		bool r = (new CurrentPosition_set())->Run(this, value.TotalSeconds);
-		if (r)
-			m_currentPosition = value.TotalSeconds;
+		// returns at once, on_playback_seek publishes the position once the newest seek has been applied
+		System::Threading::Interlocked::Exchange(m_seekTimestamp, Stopwatch::GetTimestamp());
+		m_seekSetter->SetValue(value.TotalSeconds);
+		PublishNowPlaying();
+	}
+
+	void ManagedHost::ApplySeek(double position)
+	{
+		try
+		{
+			CurrentPosition_set::Invoke(this, position);
+		}
+		catch (Exception^ ex)
+		{
+			_console::error(ex->ToString());
+		}
 	}
 
 	CALLBACK_START_UU(ActivePlaylist_get, t_size, int)
@@ -579,7 +1034,7 @@ namespace foo_touchremote
 			System::Threading::Monitor::Exit(m_currentPlaylistSync);
 		}
 
-		t_size index = (new ActivePlaylist_get())->Run(this);
+		t_size index = ActivePlaylist_get::Invoke(this);
 		
 		IPlaylist^ pl = m_playlistPool[index];
 		if (pl != nullptr && pl->Name == SELECTION_PLAYLIST_NAME)
@@ -628,7 +1083,7 @@ namespace foo_touchremote
 
 	void ManagedHost::ClearPlaybackSource()
 	{
-		(new PlaybackSource_set())->Run(this);
+		PlaybackSource_set::Invoke(this);
 	}
 
 	void ManagedHost::SetPlaybackSource(cli::array<ITrack^>^ tracks)
@@ -637,7 +1092,7 @@ namespace foo_touchremote
 			throw gcnew ArgumentNullException("tracks");
 
 		m_sourceTracks = tracks;
-		(new PlaybackSource_set())->Run(this, tracks);
+		PlaybackSource_set::Invoke(this, tracks);
 	}
 
 	array<ITrack^>^ ManagedHost::GetPlaybackSource()
@@ -680,7 +1135,7 @@ namespace foo_touchremote
 	{
 		if (index == -1)
 			CurrentShuffleMode = ShuffleMode::Shuffle;
-		return (new PlaybackSource_play())->Run(this, (t_size)index);
+		return PlaybackSource_play::Invoke(this, (t_size)index);
 	}
 
 	CALLBACK_START_UU(PlayControl_play, int, int)
@@ -707,17 +1162,17 @@ namespace foo_touchremote
 
 	void ManagedHost::PlayPause()
 	{
-		(new PlayControl_play())->Run(this, 1);
+		PlayControl_play::Invoke(this, 1);
 	}
 
 	void ManagedHost::PlayNext()
 	{
-		(new PlayControl_play())->Run(this, 2);
+		PlayControl_play::Invoke(this, 2);
 	}
 
 	void ManagedHost::PlayPrevious()
 	{
-		(new PlayControl_play())->Run(this, 3);
+		PlayControl_play::Invoke(this, 3);
 	}
 
 	void ManagedHost::SetCurrentPlaylistInvalid()
@@ -726,6 +1181,14 @@ namespace foo_touchremote
 		m_currentPlaylistValid = false;
 		m_currentPlaylist = nullptr;
 		System::Threading::Monitor::Exit(m_currentPlaylistSync);
+
+		UpdateCurrentContainer();
+		PublishNowPlaying();
+	}
+
+	void ManagedHost::SetTrackRating(Track^ track, TouchRemote::Interfaces::Rating value)
+	{
+		m_ratingWriter->Queue(track, value);
 	}
 
 	CALLBACK_START_MM(Playlist_create, IPlaylist^, String^)
@@ -763,7 +1226,7 @@ namespace foo_touchremote
 		if (String::IsNullOrEmpty(name))
 			throw gcnew ArgumentNullException("name");
 
-		return (new Playlist_create())->Run(this, name);
+		return Playlist_create::Invoke(this, name);
 	}
 
 	CALLBACK_START_UM(Playlist_delete, int, String^)
@@ -783,7 +1246,7 @@ namespace foo_touchremote
 		if (playlist == nullptr)
 			throw gcnew ArgumentNullException("playlist");
 
-		(new Playlist_delete())->Run(this, playlist->Name);
+		Playlist_delete::Invoke(this, playlist->Name);
 	}
 
 }
\ No newline at end of file
@@ -11,8 +11,23 @@ namespace foo_touchremote
 	// forward declaration
 	ref class TrackPool;
 	ref class PlaylistPool;
+	ref class RatingWriter;
+	ref class Track;
+	class MdnsResponder;
+	class PcmBroadcast;
+	class ToneGenerator;
+	namespace foobar { class AudioCapture; }
+
+	public enum class StartupState
+	{
+		Stopped,
+		Starting,
+		Listening,
+		Ready,
+		Failed
+	};
 
-	public ref class ManagedHost : public IPlayer
+	public ref class ManagedHost : public IPlayer, public IAudioStreamSource
 	{
 	private:
 		static ManagedHost();
@@ -102,6 +117,11 @@ namespace foo_touchremote
 			ITrack^ get();
 		}
 
+		virtual property TouchRemote::Interfaces::NowPlaying^ NowPlaying
+		{
+			TouchRemote::Interfaces::NowPlaying^ get();
+		}
+
 		virtual property IPlaylist^ ActivePlaylist
 		{
 			IPlaylist^ get();
@@ -125,8 +145,19 @@ namespace foo_touchremote
 
 		virtual IPlaylist^ CreatePlaylist(String^ name);
 
+		virtual property bool IsAudioStreamEnabled
+		{
+			bool get();
+		}
+
+		virtual IAudioStream^ OpenAudioStream();
+
 	internal:
 
+		property StartupState State
+		{
+			StartupState get();
+		}
 
 		void DeletePlaylist(IPlaylist^ playlist);
 
@@ -138,8 +169,11 @@ namespace foo_touchremote
 		void SetCurrentPosition(double position);
 		void SetCurrentState(bool isPlaying, bool isPaused);
 		void SetCurrentPlaylistInvalid();
+		void PublishNowPlaying();
+		void SetTrackRating(Track^ track, TouchRemote::Interfaces::Rating value);
 
 		ITrack^ GetTrack(metadb_handle_ptr &ptr);
+		ITrack^ FindTrack(metadb_handle_ptr &ptr);
 		ITrack^ GetUpdatedTrack(metadb_handle_ptr &ptr);
 		void LazyUpdateTrack(metadb_handle_ptr &ptr);
 
@@ -150,8 +184,26 @@ namespace foo_touchremote
 		void AddPlaylist(t_size index, String^ newName);
 		
 	private:
+		void RunStartup();
+		bool Advance(StartupState from, StartupState to);
+		bool EnterPhase(StartupState phase);
+		void WarmUpLibrary();
+		MdnsResponder * StartMdnsResponder();
+		void UpdateCurrentContainer();
+		void DumpStats(Object^ state);
+		void ApplyVolume(float volume);
+		void ApplySeek(double position);
+		void OnSetterApplied(Object^ sender, EventArgs^ e);
+
 		static ManagedHost ^m_instance;
 		bool m_initialized;
+		int m_state;							// a StartupState, changed with Interlocked only
+		Object^ m_startupSync;					// taken by the startup thread to hand over what it started, see EnterPhase
+		System::Threading::Thread^ m_startupThread;
+		String^ m_serviceName;
+		String^ m_hostName;
+		t_uint32 m_port;
+		System::Collections::Specialized::NameValueCollection^ m_serviceProperties;
 
 		String^ m_name;
 		String^ m_databaseId;
@@ -161,20 +213,38 @@ namespace foo_touchremote
 		IMediaLibrary^ m_mediaLibrary;
 		TrackPool^ m_trackPool;
 		PlaylistPool^ m_playlistPool;
+		RatingWriter^ m_ratingWriter;
+
+		// volume and seek requests of a slider drag, only the newest value goes to the main thread
+		TouchRemote::Core::Misc::DelayedPropertySetter<float>^ m_volumeSetter;
+		TouchRemote::Core::Misc::DelayedPropertySetter<double>^ m_seekSetter;
+		Int64 m_seekTimestamp;
 		
 		volatile t_size m_currentPlaybackOrder;
 		volatile float m_currentVolume;
 		ITrack^ m_currentTrack;
 		volatile double m_currentPosition;
+		Int64 m_currentPositionTimestamp;
 		volatile PlaybackState m_currentState;
 		array<ITrack^>^ m_sourceTracks;
 
+		// rebuilt from the fields above by PublishNowPlaying, readers only ever see whole snapshots
+		TouchRemote::Interfaces::NowPlaying^ m_nowPlaying;
+		int m_currentContainerId;
+		Object^ m_nowPlayingSync;
+
 		IPlaylist^ m_currentPlaylist;
 		bool m_currentPlaylistValid;
 		Object^ m_currentPlaylistSync;
 
 		TouchRemote::Core::Dacp::DacpServer^ m_dacpServer;
 		TouchRemote::Bonjour::BonjourService^ m_dnsServer;
+		MdnsResponder * m_mdnsResponder;
+		System::Threading::Timer^ m_statsTimer;
+
+		PcmBroadcast * p_broadcast;
+		foobar::AudioCapture * p_capture;
+		ToneGenerator * p_toneGenerator;
 
 		System::Threading::ReaderWriterLockSlim^ m_syncObject;
 	};
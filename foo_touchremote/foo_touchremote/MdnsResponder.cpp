@@ -0,0 +1,598 @@
+#include "stdafx.h"
+#include "MdnsResponder.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef int socklen_t;
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define closesocket ::close
+#endif
+
+namespace foo_touchremote
+{
+
+	namespace
+	{
+		typedef pfc::list_t<pfc::string8> name_t;
+		typedef pfc::array_t<t_uint8, pfc::alloc_fast_aggressive> packet_t;
+
+		enum
+		{
+			TYPE_A = 1,
+			TYPE_PTR = 12,
+			TYPE_TXT = 16,
+			TYPE_SRV = 33,
+			TYPE_ANY = 255,
+
+			CLASS_IN = 1,
+			CLASS_FLUSH = 0x8000,		// cache-flush bit on answers
+			CLASS_UNICAST = 0x8000,		// unicast-response bit on questions
+
+			TTL_HOST = 120,
+			TTL_OTHER = 4500,
+
+			MAX_PACKET = 9000,
+		};
+
+		// seconds
+		const double ANNOUNCE_INTERVAL = 1.0;
+		const double REFRESH_INTERVAL = 5.0;
+		const double POLL_INTERVAL = 0.25;
+
+		const t_size INVALID = ~(t_size)0;
+
+		void split_name(name_t & out, const char * name)
+		{
+			out.remove_all();
+			const char * start = name;
+			for (const char * walk = name; ; ++walk)
+			{
+				if (*walk == '.' || *walk == 0)
+				{
+					if (walk > start) out.add_item(pfc::string8(start, walk - start));
+					if (*walk == 0) break;
+					start = walk + 1;
+				}
+			}
+		}
+
+		bool same_name(const name_t & a, const name_t & b)
+		{
+			if (a.get_count() != b.get_count()) return false;
+			for (t_size i = 0; i < a.get_count(); i++)
+				if (pfc::stricmp_ascii(a[i], b[i]) != 0) return false;
+			return true;
+		}
+
+		void put8(packet_t & p, t_uint8 v)
+		{
+			p.append_single(v);
+		}
+
+		void put16(packet_t & p, t_uint16 v)
+		{
+			put8(p, (t_uint8)(v >> 8));
+			put8(p, (t_uint8)v);
+		}
+
+		void put32(packet_t & p, t_uint32 v)
+		{
+			put16(p, (t_uint16)(v >> 16));
+			put16(p, (t_uint16)v);
+		}
+
+		void put_name(packet_t & p, const name_t & name)
+		{
+			for (t_size i = 0; i < name.get_count(); i++)
+			{
+				t_size len = pfc::min_t<t_size>(name[i].length(), 63);
+				put8(p, (t_uint8)len);
+				p.append_fromptr((const t_uint8 *)name[i].get_ptr(), len);
+			}
+			put8(p, 0);
+		}
+
+		// Reads a possibly compressed name; returns the offset after it or 0 on malformed input.
+		t_size read_name(const t_uint8 * data, t_size size, t_size offset, name_t & out)
+		{
+			out.remove_all();
+			t_size end = 0;
+			unsigned jumps = 0;
+
+			while (offset < size)
+			{
+				t_uint8 len = data[offset];
+				if (len == 0)
+					return end != 0 ? end : offset + 1;
+
+				if ((len & 0xC0) == 0xC0)
+				{
+					if (offset + 1 >= size || ++jumps > 16) return 0;
+					if (end == 0) end = offset + 2;
+					offset = ((len & 0x3F) << 8) | data[offset + 1];
+					continue;
+				}
+
+				if ((len & 0xC0) != 0 || offset + 1 + len > size) return 0;
+				out.add_item(pfc::string8((const char *)data + offset + 1, len));
+				offset += 1 + len;
+			}
+
+			return 0;
+		}
+
+		t_uint16 get16(const t_uint8 * data)
+		{
+			return (t_uint16)((data[0] << 8) | data[1]);
+		}
+
+		void begin_record(packet_t & p, const name_t & name, t_uint16 type, bool cacheFlush, t_uint32 ttl)
+		{
+			put_name(p, name);
+			put16(p, type);
+			put16(p, (t_uint16)(CLASS_IN | (cacheFlush ? CLASS_FLUSH : 0)));
+			put32(p, ttl);
+		}
+	}
+
+	MdnsResponder::MdnsResponder() : m_port(0), m_socket(INVALID), m_running(false), m_stopping(false), m_announcements(0), m_nextAnnounce(0), m_nextRefresh(0)
+	{
+	}
+
+	MdnsResponder::~MdnsResponder()
+	{
+		Stop();
+	}
+
+	bool MdnsResponder::IsRunning() const
+	{
+		return m_running;
+	}
+
+	void MdnsResponder::Start(const Service & service, const char * group, t_uint16 port)
+	{
+		if (m_running) throw std::runtime_error("mDNS responder is already running");
+
+		m_service = service;
+		m_group = group;
+		m_port = port;
+
+		pfc::string8 host = service.Host;
+		if (host.is_empty())
+		{
+			char buffer[256];
+			if (gethostname(buffer, sizeof(buffer)) == 0)
+			{
+				buffer[sizeof(buffer) - 1] = 0;
+				// keep the first label only, the responder owns the .local name
+				host = pfc::string8(buffer, strcspn(buffer, "."));
+			}
+			if (host.is_empty()) host = "foobar2000";
+		}
+		else
+		{
+			// accept the Bonjour style "name.local." as well
+			if (host.ends_with('.')) host.truncate(host.length() - 1);
+			if (host.length() > 6 && pfc::stricmp_ascii(host.get_ptr() + host.length() - 6, ".local") == 0) host.truncate(host.length() - 6);
+		}
+
+		split_name(m_typeName, pfc::string8(service.Type) + ".local");
+		m_instanceName.remove_all();
+		m_instanceName.add_item(service.Instance);
+		m_instanceName.add_items(m_typeName);
+		split_name(m_hostName, host + ".local");
+		split_name(m_enumName, "_services._dns-sd._udp.local");
+
+#ifdef _WIN32
+		WSADATA wsa;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) throw std::runtime_error("WSAStartup failed");
+#endif
+
+		if (!OpenSocket())
+		{
+#ifdef _WIN32
+			WSACleanup();
+#endif
+			throw std::runtime_error("could not open mDNS socket");
+		}
+
+		m_stopping = false;
+		m_running = true;
+		m_announcements = 2;
+		m_clock.start();
+		m_nextAnnounce = 0;
+		m_nextRefresh = REFRESH_INTERVAL;
+
+		// announcing and answering happen on the thread, Start() never waits on the network
+		start(argBackground());
+	}
+
+	void MdnsResponder::Stop()
+	{
+		if (!m_running) return;
+
+		m_stopping = true;
+		waitTillDone();
+
+		CloseSocket();
+		m_running = false;
+
+#ifdef _WIN32
+		WSACleanup();
+#endif
+	}
+
+	bool MdnsResponder::OpenSocket()
+	{
+		SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (s == INVALID_SOCKET) return false;
+
+		int on = 1;
+		setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on));
+#ifdef SO_REUSEPORT
+		setsockopt(s, SOL_SOCKET, SO_REUSEPORT, (const char *)&on, sizeof(on));
+#endif
+
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_ANY);
+		addr.sin_port = htons(m_port);
+		if (bind(s, (const sockaddr *)&addr, sizeof(addr)) != 0)
+		{
+			closesocket(s);
+			return false;
+		}
+
+		int ttl = 255;
+		setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, (const char *)&ttl, sizeof(ttl));
+		int loop = 1;
+		setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, (const char *)&loop, sizeof(loop));
+
+		m_socket = (t_size)s;
+		m_addresses.remove_all();
+		m_memberships.remove_all();
+		RefreshAddresses();
+
+		return true;
+	}
+
+	void MdnsResponder::CloseSocket()
+	{
+		if (m_socket == INVALID) return;
+
+		closesocket((SOCKET)m_socket);
+		m_socket = INVALID;
+	}
+
+	void MdnsResponder::GetAddresses(pfc::list_t<t_uint32> & out)
+	{
+		char hostname[256];
+		if (gethostname(hostname, sizeof(hostname)) == 0)
+		{
+			hostname[sizeof(hostname) - 1] = 0;
+
+			addrinfo hints = {};
+			hints.ai_family = AF_INET;
+			hints.ai_socktype = SOCK_DGRAM;
+
+			addrinfo * result = NULL;
+			if (getaddrinfo(hostname, NULL, &hints, &result) == 0)
+			{
+				for (addrinfo * walk = result; walk != NULL; walk = walk->ai_next)
+				{
+					t_uint32 address = ((const sockaddr_in *)walk->ai_addr)->sin_addr.s_addr;
+					if (out.find_item(address) == pfc_infinite) out.add_item(address);
+				}
+				freeaddrinfo(result);
+			}
+		}
+	}
+
+	bool MdnsResponder::RefreshAddresses()
+	{
+		pfc::list_t<t_uint32> current;
+		GetAddresses(current);
+
+		// without a resolvable host address the group is joined on the default interface
+		pfc::list_t<t_uint32> memberships = current;
+		if (memberships.get_count() == 0) memberships.add_item(htonl(INADDR_ANY));
+
+		SOCKET s = (SOCKET)m_socket;
+		t_uint32 group = inet_addr(m_group);
+
+		for (t_size i = 0; i < m_memberships.get_count(); i++)
+		{
+			if (memberships.find_item(m_memberships[i]) != pfc_infinite) continue;
+			ip_mreq mreq = {};
+			mreq.imr_multiaddr.s_addr = group;
+			mreq.imr_interface.s_addr = m_memberships[i];
+			setsockopt(s, IPPROTO_IP, IP_DROP_MEMBERSHIP, (const char *)&mreq, sizeof(mreq));
+		}
+
+		for (t_size i = 0; i < memberships.get_count(); i++)
+		{
+			if (m_memberships.find_item(memberships[i]) != pfc_infinite) continue;
+			ip_mreq mreq = {};
+			mreq.imr_multiaddr.s_addr = group;
+			mreq.imr_interface.s_addr = memberships[i];
+			setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq));
+		}
+
+		m_memberships = memberships;
+
+		bool changed = current.get_count() != m_addresses.get_count();
+		for (t_size i = 0; i < current.get_count() && !changed; i++)
+			changed = m_addresses.find_item(current[i]) == pfc_infinite;
+
+		m_addresses = current;
+		return changed;
+	}
+
+	void MdnsResponder::threadProc()
+	{
+		while (!m_stopping)
+		{
+			double now = m_clock.query();
+
+			if (m_announcements > 0 && now >= m_nextAnnounce)
+			{
+				Announce(1);
+				m_announcements--;
+				m_nextAnnounce = now + ANNOUNCE_INTERVAL;
+			}
+
+			if (now >= m_nextRefresh)
+			{
+				if (RefreshAddresses())
+				{
+					m_announcements = 2;
+					m_nextAnnounce = now;
+				}
+				m_nextRefresh = now + REFRESH_INTERVAL;
+			}
+
+			fd_set readable;
+			FD_ZERO(&readable);
+			FD_SET((SOCKET)m_socket, &readable);
+
+			timeval timeout;
+			timeout.tv_sec = 0;
+			timeout.tv_usec = (long)(POLL_INTERVAL * 1000000);
+
+			int r = select((int)m_socket + 1, &readable, NULL, NULL, &timeout);
+			if (r > 0) Receive();
+		}
+
+		// goodbye: the same records with zero TTL
+		Announce(0);
+	}
+
+	void MdnsResponder::Receive()
+	{
+		t_uint8 buffer[MAX_PACKET];
+		sockaddr_in from = {};
+		socklen_t fromLen = sizeof(from);
+
+		int received = recvfrom((SOCKET)m_socket, (char *)buffer, sizeof(buffer), 0, (sockaddr *)&from, &fromLen);
+		if (received <= 0) return;
+
+		Answer(buffer, (t_size)received, &from);
+	}
+
+	void MdnsResponder::Answer(const t_uint8 * data, t_size size, const void * fromPtr)
+	{
+		const sockaddr_in & from = *(const sockaddr_in *)fromPtr;
+
+		if (size < 12) return;
+
+		t_uint16 id = get16(data);
+		t_uint16 flags = get16(data + 2);
+		t_uint16 qdcount = get16(data + 4);
+
+		// responses and non-standard queries are ignored
+		if ((flags & 0x8000) != 0 || (flags & 0x7800) != 0) return;
+
+		// a query not coming from the mDNS port is a legacy unicast resolver, see RFC 6762 section 6.7
+		bool legacy = ntohs(from.sin_port) != m_port;
+		bool unicast = legacy;
+
+		packet_t questions;
+		packet_t answers;
+		packet_t additionals;
+		t_uint16 questionCount = 0;
+		t_uint16 answerCount = 0;
+		t_uint16 additionalCount = 0;
+
+		t_size offset = 12;
+		for (t_uint16 q = 0; q < qdcount; q++)
+		{
+			name_t name;
+			offset = read_name(data, size, offset, name);
+			if (offset == 0 || offset + 4 > size) return;
+
+			t_uint16 type = get16(data + offset);
+			t_uint16 qclass = get16(data + offset + 2);
+			offset += 4;
+
+			if ((qclass & 0x7FFF) != CLASS_IN && (qclass & 0x7FFF) != TYPE_ANY) continue;
+			if ((qclass & CLASS_UNICAST) != 0) unicast = true;
+
+			t_uint16 before = answerCount;
+			AddRecords(answers, answerCount, type, name, false, 1, !legacy);
+			if (answerCount == before) continue;
+
+			if (legacy)
+			{
+				put_name(questions, name);
+				put16(questions, type);
+				put16(questions, CLASS_IN);
+				questionCount++;
+			}
+
+			AddRecords(additionals, additionalCount, type, name, true, 1, !legacy);
+		}
+
+		if (answerCount == 0) return;
+
+		packet_t packet;
+		put16(packet, legacy ? id : 0);
+		put16(packet, 0x8400);
+		put16(packet, questionCount);
+		put16(packet, answerCount);
+		put16(packet, 0);
+		put16(packet, additionalCount);
+		packet.append(questions);
+		packet.append(answers);
+		packet.append(additionals);
+
+		Send(packet, unicast ? &from : NULL);
+	}
+
+	// ttlScale: 1 for normal records, 0 for goodbye packets
+	void MdnsResponder::Announce(t_uint32 ttlScale)
+	{
+		packet_t records;
+		t_uint16 count = 0;
+
+		AddRecords(records, count, TYPE_PTR, m_typeName, false, ttlScale, true);
+		AddRecords(records, count, TYPE_ANY, m_instanceName, false, ttlScale, true);
+		AddRecords(records, count, TYPE_A, m_hostName, false, ttlScale, true);
+		AddRecords(records, count, TYPE_PTR, m_enumName, false, ttlScale, true);
+
+		packet_t packet;
+		put16(packet, 0);
+		put16(packet, 0x8400);
+		put16(packet, 0);
+		put16(packet, count);
+		put16(packet, 0);
+		put16(packet, 0);
+		packet.append(records);
+
+		Send(packet, NULL);
+	}
+
+	// Appends the records answering (type, name). With additional set, appends the records a resolver
+	// will ask for next instead: SRV/TXT/A after a PTR answer, A after an SRV answer.
+	void MdnsResponder::AddRecords(packet_t & packet, t_uint16 & count, t_uint16 type, const name_t & name, bool additional, t_uint32 ttlScale, bool cacheFlush)
+	{
+		const bool any = type == TYPE_ANY;
+		// legacy unicast answers get short TTLs, RFC 6762 section 6.7
+		const t_uint32 ttlHost = ttlScale * (cacheFlush ? TTL_HOST : 10);
+		const t_uint32 ttlOther = ttlScale * (cacheFlush ? TTL_OTHER : 10);
+
+		if (same_name(name, m_enumName) && (any || type == TYPE_PTR))
+		{
+			if (additional) return;
+			begin_record(packet, m_enumName, TYPE_PTR, false, ttlOther);
+			packet_t target; put_name(target, m_typeName);
+			put16(packet, (t_uint16)target.get_size());
+			packet.append(target);
+			count++;
+		}
+		else if (same_name(name, m_typeName) && (any || type == TYPE_PTR))
+		{
+			if (additional)
+			{
+				AddRecords(packet, count, TYPE_ANY, m_instanceName, false, ttlScale, cacheFlush);
+				AddRecords(packet, count, TYPE_A, m_hostName, false, ttlScale, cacheFlush);
+				return;
+			}
+			begin_record(packet, m_typeName, TYPE_PTR, false, ttlOther);
+			packet_t target; put_name(target, m_instanceName);
+			put16(packet, (t_uint16)target.get_size());
+			packet.append(target);
+			count++;
+		}
+		else if (same_name(name, m_instanceName))
+		{
+			if (additional)
+			{
+				if (any || type == TYPE_SRV)
+					AddRecords(packet, count, TYPE_A, m_hostName, false, ttlScale, cacheFlush);
+				return;
+			}
+			if (any || type == TYPE_SRV)
+			{
+				begin_record(packet, m_instanceName, TYPE_SRV, cacheFlush, ttlHost);
+				packet_t target; put_name(target, m_hostName);
+				put16(packet, (t_uint16)(6 + target.get_size()));
+				put16(packet, 0);
+				put16(packet, 0);
+				put16(packet, m_service.Port);
+				packet.append(target);
+				count++;
+			}
+			if (any || type == TYPE_TXT)
+			{
+				packet_t txt;
+				for (t_size i = 0; i < m_service.Txt.get_count(); i++)
+				{
+					t_size len = pfc::min_t<t_size>(m_service.Txt[i].length(), 255);
+					put8(txt, (t_uint8)len);
+					txt.append_fromptr((const t_uint8 *)m_service.Txt[i].get_ptr(), len);
+				}
+				// an empty TXT record still carries one zero-length string
+				if (txt.get_size() == 0) put8(txt, 0);
+
+				begin_record(packet, m_instanceName, TYPE_TXT, cacheFlush, ttlOther);
+				put16(packet, (t_uint16)txt.get_size());
+				packet.append(txt);
+				count++;
+			}
+		}
+		else if (same_name(name, m_hostName) && (any || type == TYPE_A))
+		{
+			if (additional) return;
+			for (t_size i = 0; i < m_addresses.get_count(); i++)
+			{
+				begin_record(packet, m_hostName, TYPE_A, cacheFlush, ttlHost);
+				put16(packet, 4);
+				packet.append_fromptr((const t_uint8 *)&m_addresses[i], 4);
+				count++;
+			}
+		}
+	}
+
+	void MdnsResponder::Send(const packet_t & packet, const void * to)
+	{
+		SOCKET s = (SOCKET)m_socket;
+
+		if (to != NULL)
+		{
+			sendto(s, (const char *)packet.get_ptr(), (int)packet.get_size(), 0, (const sockaddr *)to, sizeof(sockaddr_in));
+			return;
+		}
+
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = inet_addr(m_group);
+		addr.sin_port = htons(m_port);
+
+		if (m_addresses.get_count() == 0)
+		{
+			sendto(s, (const char *)packet.get_ptr(), (int)packet.get_size(), 0, (const sockaddr *)&addr, sizeof(addr));
+			return;
+		}
+
+		// one copy per interface, so every attached network hears it
+		for (t_size i = 0; i < m_addresses.get_count(); i++)
+		{
+			in_addr itf;
+			itf.s_addr = m_addresses[i];
+			setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF, (const char *)&itf, sizeof(itf));
+			sendto(s, (const char *)packet.get_ptr(), (int)packet.get_size(), 0, (const sockaddr *)&addr, sizeof(addr));
+		}
+	}
+
+}
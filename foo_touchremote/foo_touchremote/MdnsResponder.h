@@ -0,0 +1,73 @@
+#pragma once
+
+namespace foo_touchremote
+{
+
+	// Small multicast DNS responder publishing a single DNS-SD service, used instead of the Bonjour service when enabled.
+	// Answers PTR, SRV, TXT and A questions, announces the service on start and whenever the local addresses change,
+	// and sends goodbye packets on stop. There is no probing: the instance name is the database id, which is unique already.
+	class MdnsResponder : private pfc::thread
+	{
+
+	public:
+		struct Service
+		{
+			pfc::string8 Instance;
+			pfc::string8 Type;
+			pfc::string8 Host;
+			t_uint16 Port;
+			pfc::list_t<pfc::string8> Txt;
+		};
+
+		MdnsResponder();
+		~MdnsResponder();
+
+		// The group and port can be changed to run against a private multicast group, e.g. on loopback.
+		void Start(const Service & service, const char * group = "224.0.0.251", t_uint16 port = 5353);
+		void Stop();
+
+		bool IsRunning() const;
+
+	protected:
+		// IPv4 addresses of the host in network order, looked up again every few seconds.
+		// Virtual so that a test can make interfaces come and go; a derived class has to call Stop() in its destructor.
+		virtual void GetAddresses(pfc::list_t<t_uint32> & out);
+
+	private:
+		typedef pfc::list_t<pfc::string8> name_t;
+		typedef pfc::array_t<t_uint8, pfc::alloc_fast_aggressive> packet_t;
+
+		void threadProc();
+
+		bool OpenSocket();
+		void CloseSocket();
+		bool RefreshAddresses();
+		void Receive();
+		void Answer(const t_uint8 * data, t_size size, const void * from);
+		void Announce(t_uint32 ttlScale);
+
+		void AddRecords(packet_t & packet, t_uint16 & count, t_uint16 type, const name_t & name, bool additional, t_uint32 ttlScale, bool cacheFlush);
+		void Send(const packet_t & packet, const void * to);
+
+		pfc::string8 m_group;
+		t_uint16 m_port;
+
+		Service m_service;
+		name_t m_typeName;
+		name_t m_instanceName;
+		name_t m_hostName;
+		name_t m_enumName;
+
+		pfc::list_t<t_uint32> m_addresses;
+		pfc::list_t<t_uint32> m_memberships;	// interfaces the socket joined the group on, INADDR_ANY when there is no address
+
+		t_size m_socket;
+		volatile bool m_running;
+		volatile bool m_stopping;
+		unsigned m_announcements;
+		double m_nextAnnounce;
+		double m_nextRefresh;
+		pfc::lores_timer m_clock;
+	};
+
+}
@@ -0,0 +1,255 @@
+#include "stdafx.h"
+#include "PcmBroadcast.h"
+
+namespace foo_touchremote
+{
+
+	namespace
+	{
+		long compare_exchange(volatile long & value, long exchange, long comparand)
+		{
+#ifdef _MSC_VER
+			return InterlockedCompareExchange(&value, exchange, comparand);
+#else
+			return __sync_val_compare_and_swap(&value, comparand, exchange);
+#endif
+		}
+
+		// full barrier, so ring bytes copied before it are not read after it
+		t_uint32 load(volatile long & value)
+		{
+			return (t_uint32)compare_exchange(value, 0, 0);
+		}
+
+		void add(volatile long & value, long delta)
+		{
+			long current;
+			do
+			{
+				current = value;
+			}
+			while (compare_exchange(value, current + delta, current) != current);
+		}
+
+		void store(volatile long & value, t_uint32 newValue)
+		{
+			pfc::threadSafeInt::exchangeHere(value, (long)newValue);
+		}
+
+		t_uint32 pack_format(unsigned sampleRate, unsigned channels)
+		{
+			return (t_uint32)((sampleRate << 5) | channels);
+		}
+
+		t_uint32 frame_size(t_uint32 format)
+		{
+			return (format & 31) * sizeof(t_int16);
+		}
+	}
+
+	PcmBroadcast::Reader::Reader() : m_owner(NULL), m_inUse(0), m_sleeping(0), m_cursor(0), m_format(0), m_dropped(0)
+	{
+	}
+
+	void PcmBroadcast::Reader::Reset(PcmBroadcast * owner)
+	{
+		m_owner = owner;
+		m_sleeping = 0;
+		m_cursor = 0;
+		m_format = 0;
+		m_dropped = 0;
+		m_canRead.set_state(false);
+	}
+
+	unsigned PcmBroadcast::Reader::GetSampleRate() const
+	{
+		return m_format >> 5;
+	}
+
+	unsigned PcmBroadcast::Reader::GetChannels() const
+	{
+		return m_format & 31;
+	}
+
+	t_uint64 PcmBroadcast::Reader::GetDroppedBytes() const
+	{
+		return m_dropped;
+	}
+
+	int PcmBroadcast::Reader::Read(void * buffer, t_size bytes, double timeout)
+	{
+		PcmBroadcast & owner = *m_owner;
+		const t_uint32 capacity = owner.m_mask + 1;
+
+		pfc::lores_timer timer;
+		timer.start();
+
+		for (;;)
+		{
+			if (owner.m_shutdown) return -1;
+
+			t_uint32 formatStart = load(owner.m_formatStart);
+			t_uint32 format = load(owner.m_format);
+			t_uint32 written = load(owner.m_written);
+
+			if (m_format == 0 && format != 0)
+			{
+				// a new reader starts at the live position of the current format
+				if (load(owner.m_formatStart) != formatStart || load(owner.m_format) != format) continue;
+				m_format = format;
+				m_cursor = written;
+			}
+
+			if (m_format != 0)
+			{
+				const t_uint32 frame = frame_size(m_format);
+				t_uint32 end = written;
+
+				if (written - m_cursor > capacity / 4 * 3)
+				{
+					// too slow, skip to recent audio
+					t_uint32 skip = (written - capacity / 4 - m_cursor) / frame * frame;
+					m_cursor += skip;
+					m_dropped += skip;
+				}
+
+				if (format != m_format)
+				{
+					// the old format ends where the new one starts
+					if ((t_int32)(formatStart - m_cursor) <= 0) return -1;
+					end = formatStart;
+				}
+
+				t_uint32 available = (end - m_cursor) / frame * frame;
+				if (available > 0)
+				{
+					t_uint32 count = (t_uint32)pfc::min_t<t_size>(available, bytes / frame * frame);
+					if (count == 0) return 0;
+
+					t_uint32 offset = m_cursor & owner.m_mask;
+					t_uint32 first = pfc::min_t<t_uint32>(count, capacity - offset);
+					memcpy(buffer, owner.m_ring.get_ptr() + offset, first);
+					memcpy((t_uint8 *)buffer + first, owner.m_ring.get_ptr(), count - first);
+
+					// the producer may have lapped us while copying, the copy is garbage then
+					if (load(owner.m_reserved) - m_cursor > capacity) continue;
+
+					m_cursor += count;
+					return (int)count;
+				}
+			}
+
+			double remaining = timeout - timer.query();
+			if (remaining <= 0) return 0;
+
+			m_canRead.set_state(false);
+			store(m_sleeping, 1);
+			if (load(owner.m_written) == written && load(owner.m_format) == format && !owner.m_shutdown)
+				m_canRead.wait_for(remaining);
+			store(m_sleeping, 0);
+		}
+	}
+
+	PcmBroadcast::PcmBroadcast(t_size capacity) : m_written(0), m_reserved(0), m_formatStart(0), m_format(0), m_readerCount(0), m_shutdown(0)
+	{
+		t_size size = 4096;
+		while (size < capacity) size <<= 1;
+
+		m_mask = (t_uint32)(size - 1);
+		m_ring.set_size(size);
+		m_ring.fill_null();
+	}
+
+	void PcmBroadcast::Write(const audio_sample * data, t_size samples, unsigned channels, unsigned sampleRate)
+	{
+		if (m_readerCount == 0 || m_shutdown) return;
+		if (samples == 0 || channels == 0 || channels > 31 || sampleRate == 0) return;
+
+		// keep every chunk well below the ring size, so readers always have something valid to skip to
+		const t_size maxSamples = (m_mask + 1) / 4 / (channels * sizeof(t_int16));
+		if (samples > maxSamples)
+		{
+			data += (samples - maxSamples) * channels;
+			samples = maxSamples;
+		}
+
+		// converted once, no matter how many readers there are
+		const t_size count = samples * channels;
+		if (m_scratch.get_size() < count) m_scratch.set_size(count);
+		pfc::audio_math::convert_to_int16(data, count, m_scratch.get_ptr(), 1);
+
+		const t_uint32 bytes = (t_uint32)(count * sizeof(t_int16));
+		const t_uint32 written = (t_uint32)m_written;
+		const t_uint32 format = pack_format(sampleRate, channels);
+
+		if (format != (t_uint32)m_format)
+		{
+			store(m_formatStart, written);
+			store(m_format, format);
+		}
+
+		store(m_reserved, written + bytes);
+
+		const t_uint32 offset = written & m_mask;
+		const t_uint32 first = pfc::min_t<t_uint32>(bytes, m_mask + 1 - offset);
+		memcpy(m_ring.get_ptr() + offset, m_scratch.get_ptr(), first);
+		memcpy(m_ring.get_ptr(), (const t_uint8 *)m_scratch.get_ptr() + first, bytes - first);
+
+		store(m_written, written + bytes);
+
+		WakeReaders();
+	}
+
+	void PcmBroadcast::WakeReaders()
+	{
+		for (t_size i = 0; i < MaxReaders; i++)
+		{
+			Reader & reader = m_readers[i];
+			if (reader.m_inUse && reader.m_sleeping && pfc::threadSafeInt::exchangeHere(reader.m_sleeping, 0))
+				reader.m_canRead.set_state(true);
+		}
+	}
+
+	PcmBroadcast::Reader * PcmBroadcast::Open()
+	{
+		if (m_shutdown) return NULL;
+
+		for (t_size i = 0; i < MaxReaders; i++)
+		{
+			Reader & reader = m_readers[i];
+			if (compare_exchange(reader.m_inUse, 1, 0) == 0)
+			{
+				reader.Reset(this);
+				add(m_readerCount, 1);
+				return &reader;
+			}
+		}
+
+		return NULL;
+	}
+
+	void PcmBroadcast::Close(Reader * reader)
+	{
+		if (reader == NULL) return;
+
+		add(m_readerCount, -1);
+		store(reader->m_inUse, 0);
+	}
+
+	bool PcmBroadcast::HasReaders() const
+	{
+		return m_readerCount > 0;
+	}
+
+	void PcmBroadcast::Shutdown()
+	{
+		store(m_shutdown, 1);
+
+		for (t_size i = 0; i < MaxReaders; i++)
+		{
+			if (m_readers[i].m_inUse)
+				m_readers[i].m_canRead.set_state(true);
+		}
+	}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+namespace foo_touchremote
+{
+
+	// Single producer, many readers ring of 16-bit PCM.
+	// The producer converts each chunk once and never waits; every reader keeps its own cursor and a reader
+	// that falls more than the ring size behind skips ahead to recent audio instead of holding the producer back.
+	class PcmBroadcast
+	{
+
+	public:
+		enum { MaxReaders = 8 };
+
+		class Reader
+		{
+
+		public:
+			// Copies up to bytes (whole frames) into buffer, waiting up to timeout seconds for data.
+			// Returns the number of bytes copied, 0 on timeout, or -1 when the format changed or the broadcast was shut down.
+			int Read(void * buffer, t_size bytes, double timeout);
+
+			// Valid after the first successful Read().
+			unsigned GetSampleRate() const;
+			unsigned GetChannels() const;
+
+			t_uint64 GetDroppedBytes() const;
+
+		private:
+			friend class PcmBroadcast;
+
+			Reader();
+			void Reset(PcmBroadcast * owner);
+
+			PcmBroadcast * m_owner;
+			volatile long m_inUse;
+			volatile long m_sleeping;
+			pfc::event m_canRead;
+
+			t_uint32 m_cursor;
+			t_uint32 m_format;
+			t_uint64 m_dropped;
+		};
+
+		// capacity is in bytes and rounded up to a power of two
+		PcmBroadcast(t_size capacity = 1 << 20);
+
+		// Producer side, from one thread only. data holds samples * channels interleaved values.
+		void Write(const audio_sample * data, t_size samples, unsigned channels, unsigned sampleRate);
+
+		// Returns NULL when MaxReaders readers are open already.
+		Reader * Open();
+		void Close(Reader * reader);
+
+		bool HasReaders() const;
+
+		// Wakes all readers; from now on Read() returns -1.
+		void Shutdown();
+
+	private:
+		void WakeReaders();
+
+		t_uint32 m_mask;
+		pfc::array_t<t_uint8> m_ring;
+		pfc::array_t<t_int16> m_scratch;
+
+		// positions are byte counters modulo 2^32, the ring is much smaller so differences stay valid
+		volatile long m_written;
+		volatile long m_reserved;		// end of the chunk being copied in, readers must not rely on bytes it overwrites
+		volatile long m_formatStart;
+		volatile long m_format;
+		volatile long m_readerCount;
+		volatile long m_shutdown;
+
+		Reader m_readers[MaxReaders];
+	};
+
+}
@@ -97,6 +97,9 @@ namespace foo_touchremote
 			metadb_handle_ptr np;
 			if (!ctl->get_now_playing(np)) return;*/
 
+			// the snapshot keeps its track object, so its cached status has to be rebuilt explicitly
+			ManagedHost::Instance->LazyUpdateTrack(p_track);
+			ManagedHost::Instance->PublishNowPlaying();
 			SessionManager::StateUpdated();
 		}
 
@@ -111,15 +114,7 @@ namespace foo_touchremote
 
 		void PlayCallback::on_playback_time(double p_time)
 		{
-			//IDisposable^ lock = ManagedHost::Instance->BeginWrite();
-			try
-			{
-				ManagedHost::Instance->SetCurrentPosition(p_time);
-			}
-			finally
-			{
-				//delete lock;
-			}
+			// not subscribed, the position is interpolated from the last start/seek/pause
 		}
 
 		void PlayCallback::on_volume_change(float p_new_val)
@@ -147,7 +142,6 @@ namespace foo_touchremote
 				| flag_on_playback_edited
 				//| flag_on_playback_dynamic_info
 				| flag_on_playback_dynamic_info_track
-				| flag_on_playback_time
 				| flag_on_volume_change;
 		}
 
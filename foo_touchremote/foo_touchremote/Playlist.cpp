@@ -68,7 +68,7 @@ namespace foo_touchremote
 	{
 		if (m_tracks == nullptr)
 		{
-			m_tracks = (new PlaylistTracks_enum())->Run(this, m_index);
+			m_tracks = PlaylistTracks_enum::Invoke(this, m_index);
 			m_trackCount = m_tracks->Count;
 		}
 		return m_tracks;
@@ -98,7 +98,7 @@ namespace foo_touchremote
 		if (m_tracks == nullptr)
 		{
 			if (m_trackCount == -1)
-				m_trackCount = (new PlaylistTracks_count())->Run(this, m_index);
+				m_trackCount = PlaylistTracks_count::Invoke(this, m_index);
 			return m_trackCount;
 		}
 		return m_tracks->Count;
@@ -178,7 +178,7 @@ namespace foo_touchremote
 
 	void Playlist::PlayRandom()
 	{
-		(new Play_impl())->Run(this);
+		Play_impl::Invoke(this);
 	}
 
 	void Playlist::Play(int index)
@@ -189,7 +189,7 @@ namespace foo_touchremote
 			return;
 		}
 
-		(new Play_impl())->Run(this, m_tracks[index]);
+		Play_impl::Invoke(this, m_tracks[index]);
 	}
 
 	void Playlist::Delete()
@@ -213,7 +213,7 @@ namespace foo_touchremote
 
 	void Playlist::Clear()
 	{
-		(new Playlist_clear())->Run(this);
+		Playlist_clear::Invoke(this);
 	}
 
 	CALLBACK_START_UM(Playlist_add_tracks, int, IEnumerable<ITrack^>^)
@@ -253,7 +253,7 @@ namespace foo_touchremote
 		if (tracks == nullptr)
 			throw gcnew ArgumentNullException("tracks");
 
-		(new Playlist_add_tracks())->Run(this, tracks);
+		Playlist_add_tracks::Invoke(this, tracks);
 	}
 
 	CALLBACK_START_UM(Playlist_del_tracks, int, IEnumerable<ITrack^>^)
@@ -270,9 +270,12 @@ namespace foo_touchremote
 				bit_array_bittable mask;
 				mask.resize(pl->TrackCount);
 
+				// linear in playlist plus selection size
+				HashSet<ITrack^>^ toRemove = gcnew HashSet<ITrack^>(arg);
 				for (int i = 0; i < list->Count; i++)
 				{
-					mask.set(i, System::Linq::Enumerable::Contains(arg, list[i]));
+					if (toRemove->Contains(list[i]))
+						mask.set(i, true);
 				}
 
 				mgr->playlist_remove_items(index, mask);
@@ -295,7 +298,7 @@ namespace foo_touchremote
 		if (tracks == nullptr)
 			throw gcnew ArgumentNullException("tracks");
 
-		(new Playlist_del_tracks())->Run(this, tracks);
+		Playlist_del_tracks::Invoke(this, tracks);
 	}
 
 	CALLBACK_START_UU(Playlist_move_track, int, int*)
@@ -349,6 +352,6 @@ namespace foo_touchremote
 
 		int pair[] = { trackToMove, moveAfter };
 
-		(new Playlist_move_track())->Run(this, pair);
+		Playlist_move_track::Invoke(this, pair);
 	}
 }
\ No newline at end of file
@@ -67,22 +67,13 @@ namespace foo_touchremote
 
 			static_api_ptr_t<playlist_manager> mgr;
 
-			t_size count = mgr->playlist_get_item_count(p_playlist);
-			if (count != pfc::infinite32)
-			{
-				ManagedHost^ host = ManagedHost::Instance;
-
-				for (t_size i = 0; i < count; i++)
-				{
-					if (!p_mask[i]) continue;
-					
-					metadb_handle_ptr ptr;
-					if (mgr->playlist_get_item_handle(ptr, p_playlist, i))
-					{
-						host->LazyUpdateTrack(ptr);
-					}
-				}
-			}
+			// one call collects the handles of all set bits, instead of a lookup per index
+			metadb_handle_list items;
+			mgr->playlist_get_items(p_playlist, items, p_mask);
+
+			ManagedHost^ host = ManagedHost::Instance;
+			for (t_size i = 0; i < items.get_count(); i++)
+				host->LazyUpdateTrack(items[i]);
 			SessionManager::DatabaseUpdated();
 		}
 
@@ -7,6 +7,9 @@
 
 #pragma managed
 
+using namespace TouchRemote::Core;
+using namespace TouchRemote::Core::Misc;
+
 namespace foo_touchremote
 {
 
@@ -17,14 +20,16 @@ namespace foo_touchremote
 
 		m_library = library;
 		m_playlists = nullptr;
+		m_previousIds = nullptr;
 		m_lock = gcnew ReaderWriterLockSlim(LockRecursionPolicy::NoRecursion);
+		m_lockWait = Stats::Latency("lock wait PlaylistPool");
 	}
 
 	Playlist^ PlaylistPool::default::get(t_size index)
 	{
 		if (index == pfc::infinite32) return nullptr;
 
-		m_lock->EnterUpgradeableReadLock();
+		Stats::EnterUpgradeableReadLock(m_lock, m_lockWait);
 		try
 		{
 			ValidateAll();
@@ -42,7 +47,7 @@ namespace foo_touchremote
 
 	array<Playlist^>^ PlaylistPool::Playlists::get()
 	{
-		m_lock->EnterUpgradeableReadLock();
+		Stats::EnterUpgradeableReadLock(m_lock, m_lockWait);
 		try
 		{
 			ValidateAll();
@@ -56,12 +61,21 @@ namespace foo_touchremote
 
 	void PlaylistPool::InvalidateAll()
 	{
-		m_lock->EnterWriteLock();
+		Stats::EnterWriteLock(m_lock, m_lockWait);
 		try
 		{
 			if (m_playlists != nullptr)
+			{
+				if (m_previousIds == nullptr)
+				{
+					m_previousIds = gcnew array<int>(m_playlists->Length);
+					for (int i = 0; i < m_playlists->Length; i++)
+						m_previousIds[i] = m_playlists[i]->Id;
+				}
+
 				for each (Playlist^ p in m_playlists)
 					p->Invalidate();
+			}
 			m_playlists = nullptr;
 		}
 		finally
@@ -96,10 +110,30 @@ namespace foo_touchremote
 	{
 		if (m_playlists != nullptr) return;
 
-		m_lock->EnterWriteLock();
+		Stats::EnterWriteLock(m_lock, m_lockWait);
 		try
 		{
-			m_playlists = (new Playlists_enum())->Run(this, m_library);
+			m_playlists = Playlists_enum::Invoke(this, m_library);
+
+			if (m_previousIds != nullptr)
+			{
+				// created, removed and renamed playlists
+				HashSet<int>^ previous = gcnew HashSet<int>(m_previousIds);
+				HashSet<int>^ current = gcnew HashSet<int>();
+				for each (Playlist^ p in m_playlists)
+				{
+					int id = p->Id;
+					current->Add(id);
+					if (!previous->Contains(id))
+						ChangeJournal::ContainerChanged(id);
+				}
+
+				for each (int id in m_previousIds)
+					if (!current->Contains(id))
+						ChangeJournal::ContainerRemoved(id);
+
+				m_previousIds = nullptr;
+			}
 		}
 		finally
 		{
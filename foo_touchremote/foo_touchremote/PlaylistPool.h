@@ -33,7 +33,9 @@ namespace foo_touchremote
 
 		IMediaLibrary^ m_library;
 		array<Playlist^>^ m_playlists;
+		array<int>^ m_previousIds;		// ids before InvalidateAll(), compared with the rebuilt list
 		ReaderWriterLockSlim^ m_lock;
+		TouchRemote::Core::Misc::Histogram^ m_lockWait;
 	};
 
 }
\ No newline at end of file
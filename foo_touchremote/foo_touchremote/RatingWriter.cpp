@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "RatingWriter.h"
+#include "Track.h"
+#include "Utils.h"
+#include "MainThreadCallback.h"
+
+#pragma managed
+
+namespace foo_touchremote
+{
+
+	// taps on the stars arriving closer than this are written together
+	static const int RatingBatchWindow = 300;
+
+	RatingWriter::RatingWriter()
+	{
+		m_pending = gcnew Dictionary<Track^, TouchRemote::Interfaces::Rating>();
+		m_timer = gcnew Timer(gcnew TimerCallback(this, &RatingWriter::OnTimer), nullptr, Timeout::Infinite, Timeout::Infinite);
+		m_scheduled = false;
+	}
+
+	void RatingWriter::Queue(Track^ track, TouchRemote::Interfaces::Rating value)
+	{
+		if (track == nullptr)
+			throw gcnew ArgumentNullException("track");
+
+		Monitor::Enter(this);
+		try
+		{
+			// the last tap on a track wins
+			m_pending[track] = value;
+
+			if (!m_scheduled)
+			{
+				m_scheduled = true;
+				m_timer->Change(RatingBatchWindow, Timeout::Infinite);
+			}
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	Dictionary<Track^, TouchRemote::Interfaces::Rating>^ RatingWriter::TakePending()
+	{
+		Monitor::Enter(this);
+		try
+		{
+			m_scheduled = false;
+			m_timer->Change(Timeout::Infinite, Timeout::Infinite);
+
+			if (m_pending->Count == 0) return nullptr;
+
+			Dictionary<Track^, TouchRemote::Interfaces::Rating>^ pending = m_pending;
+			m_pending = gcnew Dictionary<Track^, TouchRemote::Interfaces::Rating>();
+			return pending;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	void RatingWriter::Flush()
+	{
+		Dictionary<Track^, TouchRemote::Interfaces::Rating>^ pending = TakePending();
+		if (pending != nullptr)
+			Apply(pending);
+	}
+
+	void RatingWriter::OnTimer(Object^ state)
+	{
+		try
+		{
+			Flush();
+		}
+		catch (Exception^ ex)
+		{
+			_console::error(ex->ToString());
+		}
+	}
+
+	CALLBACK_START_UM(TrackRating_apply, int, array<List<Track^>^>^)
+		static const GUID * const commands[] = 
+		{
+			&foo_playcount::guids::rating_none,
+			&foo_playcount::guids::rating_one_star,
+			&foo_playcount::guids::rating_two_stars,
+			&foo_playcount::guids::rating_three_stars,
+			&foo_playcount::guids::rating_four_stars,
+			&foo_playcount::guids::rating_five_stars,
+		};
+
+		int count = 0;
+		for (int i = 0; i < arg->Length; i++)
+		{
+			if (arg[i] == nullptr) continue;
+
+			pfc::list_t<metadb_handle_ptr> items;
+			items.prealloc(arg[i]->Count);
+			for each (Track^ track in arg[i])
+				items.add_item(track->GetHandle());
+
+			if (menu_helpers::run_command_context(foo_playcount::guids::rating_menu_item, *commands[i], items))
+				count += (int)items.get_count();
+		}
+		return count;
+	CALLBACK_END()
+
+	void RatingWriter::Apply(IDictionary<Track^, TouchRemote::Interfaces::Rating>^ ratings)
+	{
+		if (ratings == nullptr)
+			throw gcnew ArgumentNullException("ratings");
+
+		array<List<Track^>^>^ groups = gcnew array<List<Track^>^>(6);
+
+		for each (KeyValuePair<Track^, TouchRemote::Interfaces::Rating> item in ratings)
+		{
+			int value = Math::Max(0, Math::Min((int)item.Value, 5));
+
+			if (groups[value] == nullptr)
+				groups[value] = gcnew List<Track^>();
+			groups[value]->Add(item.Key);
+		}
+
+		TrackRating_apply::Invoke(this, groups);
+	}
+
+}
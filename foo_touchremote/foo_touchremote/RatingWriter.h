@@ -0,0 +1,34 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+using namespace TouchRemote::Interfaces;
+
+namespace foo_touchremote
+{
+	// forward declaration
+	ref class Track;
+
+	// Collects rating changes made within a short window and applies them in one
+	// main thread call, running the foo_playcount command once per rating value.
+	private ref class RatingWriter
+	{
+
+	public:
+		RatingWriter();
+
+		void Queue(Track^ track, TouchRemote::Interfaces::Rating value);
+		void Apply(IDictionary<Track^, TouchRemote::Interfaces::Rating>^ ratings);
+		void Flush();
+
+	private:
+		void OnTimer(Object^ state);
+		Dictionary<Track^, TouchRemote::Interfaces::Rating>^ TakePending();
+
+		Dictionary<Track^, TouchRemote::Interfaces::Rating>^ m_pending;
+		Timer^ m_timer;
+		bool m_scheduled;
+	};
+
+}
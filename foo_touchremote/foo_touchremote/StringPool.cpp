@@ -0,0 +1,109 @@
+#include "stdafx.h"
+#include "StringPool.h"
+#include "TrigramIndex.h"
+#include "Utils.h"
+
+#pragma managed
+
+namespace foo_touchremote
+{
+
+	StringPool::StringPool()
+	{
+		m_ids = gcnew Dictionary<String^, int>(StringComparer::Ordinal);
+		m_values = gcnew array<String^>(256);
+		m_stats = TouchRemote::Core::Misc::Stats::Cache("tag strings");
+
+		// id 0 is reserved for empty and missing values
+		m_values[0] = String::Empty;
+		m_count = 1;
+
+		p_index = new TrigramIndex();
+	}
+
+	StringPool::~StringPool()
+	{
+		this->!StringPool();
+	}
+
+	StringPool::!StringPool()
+	{
+		delete p_index;
+		p_index = NULL;
+	}
+
+	String^ StringPool::Intern(String^ value)
+	{
+		if (value == nullptr) return nullptr;
+
+		return GetValue(GetId(value));
+	}
+
+	int StringPool::GetId(String^ value)
+	{
+		if (String::IsNullOrEmpty(value)) return 0;
+
+		int id;
+
+		Monitor::Enter(m_ids);
+		try
+		{
+			if (m_ids->TryGetValue(value, id))
+			{
+				m_stats->Hit();
+				return id;
+			}
+
+			m_stats->Miss();
+
+			if (m_count == m_values->Length)
+			{
+				// readers index the array without locking, so publish a filled copy
+				array<String^>^ values = gcnew array<String^>(m_values->Length * 2);
+				Array::Copy(m_values, values, m_count);
+				m_values = values;
+			}
+
+			id = m_count;
+			m_values[id] = value;
+			m_ids->Add(value, id);
+			m_count++;
+
+			p_index->Set(id, ToUtf8String(value));
+		}
+		finally
+		{
+			Monitor::Exit(m_ids);
+		}
+
+		return id;
+	}
+
+	String^ StringPool::GetValue(int id)
+	{
+		array<String^>^ values = m_values;
+
+		if (id <= 0 || id >= values->Length) return String::Empty;
+
+		return values[id];
+	}
+
+	array<bool>^ StringPool::FindContaining(String^ value)
+	{
+		pfc::array_t<t_uint32> ids;
+		p_index->Find(ToUtf8String(value), ids);
+
+		// read after the search, so it covers every id found
+		array<bool>^ found = gcnew array<bool>(m_values->Length);
+		for (t_size i = 0; i < ids.get_size(); i++)
+			found[ids[i]] = true;
+
+		return found;
+	}
+
+	int StringPool::Count::get()
+	{
+		return m_count;
+	}
+
+}
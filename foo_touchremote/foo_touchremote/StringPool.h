@@ -0,0 +1,44 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace foo_touchremote
+{
+	// forward declaration
+	class TrigramIndex;
+
+	// Shares one String instance between all tracks having the same tag value.
+	// Every value also gets a small integer id, so tables can store ids instead of references.
+	// Values are indexed for substring search as they are added.
+	private ref class StringPool
+	{
+
+	public:
+		StringPool();
+		~StringPool();
+		!StringPool();
+
+		String^ Intern(String^ value);
+
+		int GetId(String^ value);
+		String^ GetValue(int id);
+
+		// Flags, by id, the values containing value the way TrigramIndex::Find() matches.
+		array<bool>^ FindContaining(String^ value);
+
+		property int Count
+		{
+			int get();
+		}
+
+	private:
+		Dictionary<String^, int>^ m_ids;
+		array<String^>^ m_values;
+		int m_count;
+		TouchRemote::Core::Misc::HitCounter^ m_stats;
+		TrigramIndex *p_index;
+	};
+
+}
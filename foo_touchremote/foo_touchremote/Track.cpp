@@ -7,10 +7,14 @@
 #include "MainThreadCallback.h"
 #include "ManagedHost.h"
 #include "TitleFormatters.h"
+#include "StringPool.h"
+#include "TrackTable.h"
+#include "TrigramIndex.h"
 
 #pragma managed
 
 using namespace System::IO;
+using namespace System::Threading;
 using namespace TouchRemote::Core;
 
 namespace foo_touchremote
@@ -30,26 +34,24 @@ namespace foo_touchremote
 		return value;
 	}
 
-	static String^ format_string(metadb_handle_ptr &track, const titleformat_object::ptr &format, const file_info *info, const char *fallback)
+	// the text stays valid as long as fields, which also keeps it past the metadb lock
+	static const char* format_field(metadb_handle_ptr &track, const titleformat_object::ptr &format, const file_info *info, const char *fallback, pfc::string_arena &fields)
 	{
-		pfc::string8_fastalloc s_value;
-
-		if (format.is_valid() && track->format_title_nonlocking(NULL, s_value, format, NULL))
+		if (format.is_valid() && track->format_title_nonlocking(NULL, fields, format, NULL))
 		{
-			if (strcmp(s_value, "?") == 0) return String::Empty;
-			return FromUtf8String(s_value);
+			if (strcmp(fields, "?") == 0) fields.reset();
+			return fields.commit();
 		}
 
+		fields.reset();
 		if (info->meta_exists(fallback))
-			return FromUtf8String(info->meta_get(fallback, 0));
-		
-		return String::Empty;
+			fields.add_string(info->meta_get(fallback, 0));
+
+		return fields.commit();
 	}
 
-	static String^ format_string_live(metadb_handle_ptr &track, const titleformat_object::ptr &format, const file_info &info, const char *fallback)
+	static String^ format_string_live(metadb_handle_ptr &track, const titleformat_object::ptr &format, const file_info &info, const char *fallback, pfc::string8_sso &s_value)
 	{
-		pfc::string8_fastalloc s_value;
-
 		if (format.is_valid())
 		{
             track->format_title_from_external_info_nonlocking(info, NULL, s_value, format, NULL);
@@ -64,323 +66,355 @@ namespace foo_touchremote
 		return String::Empty;
 	}
 
-	Track::Track(IMediaLibrary^ library, metadb_handle_ptr &ptr)
+	Track::Track(TrackTable^ table, int row)
 	{
-		if (library == nullptr)
-			throw gcnew ArgumentNullException("library");
+		if (table == nullptr)
+			throw gcnew ArgumentNullException("table");
 
-		if (ptr.is_empty())
-			throw gcnew ArgumentNullException("ptr");
+		if (row < 0)
+			throw gcnew ArgumentOutOfRangeException("row");
 
-		m_library = library;
-		m_source = gcnew FilePlaybackSource(ptr->get_location());
-        m_isLive = false;
+		m_table = table;
+		m_row = row;
 
-		Initialize(ptr);
+		foobar::titleformat::Initialize();
 	}
 
-	Track::Track(IMediaLibrary^ library, metadb_handle_ptr &ptr, IPlaybackSource^ location)
-	{	
-		if (library == nullptr)
-			throw gcnew ArgumentNullException("library");
-
-		if (ptr.is_empty())
-			throw gcnew ArgumentNullException("ptr");
+	void Track::ReadInfo(metadb_handle_ptr &ptr)
+	{
+		StringPool^ strings = m_table->Strings;
 
-		if (location == nullptr)
-			throw gcnew ArgumentNullException("location");
+		TimeSpan duration;
+		String^ title;
+		String^ album_artist;
+		String^ artist;
+		String^ album;
+		int genre, composer, trackNumber, discNumber;
+		TouchRemote::Interfaces::Rating rating;
 
-		m_library = library;
-		m_source = location;
+		// the seven fields of a track fit the inline block, reading a track allocates no native strings
+		pfc::string_arena_t<512> fields;
+		const char * utf8Title;
 
-		Initialize(ptr);
-	}
+		{
+			in_metadb_sync_fromhandle l_sync(ptr);
 
-	void Track::Initialize(metadb_handle_ptr &ptr)
-	{
-		foobar::titleformat::Initialize();
+			const file_info * info = NULL;
+			if (!ptr->get_info_locked(info))
+				throw gcnew ArgumentException("failed to get info for " + Source->ToString(), "ptr");
 
-		ReadInfo(ptr);
+			duration = TimeSpan::FromSeconds(info->get_length());
+			utf8Title = format_field(ptr, foobar::titleformat::title, info, "TITLE", fields);
+			if (*utf8Title == 0)
+			{
+				fields.add_string(pfc::string_filename(ptr->get_path()));
+				utf8Title = fields.commit();
+			}
+			title = FromUtf8String(utf8Title);
 
-        p_native_handle = new metadb_handle_ptr(ptr);
-	}
+			album_artist = strings->Intern(FromUtf8String(format_field(ptr, foobar::titleformat::albumartist, info, "ALBUM ARTIST", fields)));
+			artist = strings->Intern(FromUtf8String(format_field(ptr, foobar::titleformat::artist, info, "ARTIST", fields)));
+			album = FromUtf8String(format_field(ptr, foobar::titleformat::album, info, "ALBUM", fields));
 
-	void Track::ReadInfo(metadb_handle_ptr &ptr)
-	{
-		in_metadb_sync_fromhandle l_sync(ptr);
-		
-		const file_info * info = NULL;
-		if (!ptr->get_info_locked(info))
-			throw gcnew ArgumentException("failed to get info for " + m_source->ToString(), "ptr");
-	
-        m_duration = TimeSpan::FromSeconds(info->get_length());
-		m_title = format_string(ptr, foobar::titleformat::title, info, "TITLE");
-		if (String::IsNullOrEmpty(m_title))
-			m_title = FromUtf8String(pfc::string_filename(ptr->get_path()).get_ptr());
+			genre = strings->GetId(FromUtf8String(format_field(ptr, foobar::titleformat::genre, info, "GENRE", fields)));
+			composer = strings->GetId(FromUtf8String(format_field(ptr, foobar::titleformat::composer, info, "COMPOSER", fields)));
 
-		{
-			String^ album_artist = format_string(ptr, foobar::titleformat::albumartist, info, "ALBUM ARTIST");
-			String^ artist = format_string(ptr, foobar::titleformat::artist, info, "ARTIST");
-			String^ album = format_string(ptr, foobar::titleformat::album, info, "ALBUM");
+			trackNumber = get_int(info->meta_get("TRACKNUMBER", 0));
+			discNumber = get_int(info->meta_get("DISCNUMBER", 0));
 
-			if (!String::IsNullOrEmpty(artist) && !String::IsNullOrEmpty(album_artist) && String::Equals(artist, album_artist, StringComparison::InvariantCultureIgnoreCase))
-			{
-				artist = nullptr;
-			}
-			else if (String::IsNullOrEmpty(album_artist))
-			{
-				album_artist = artist;
-				artist = nullptr;
-			}
+			String^ s_rating = FromUtf8String(format_field(ptr, foobar::titleformat::rating, info, "RATING", fields));
+			int n_rating;
+			if (!String::IsNullOrEmpty(s_rating) && int::TryParse(s_rating, n_rating))
+				rating = (TouchRemote::Interfaces::Rating)Math::Max(0, Math::Min(n_rating, 5));
+			else
+				rating = TouchRemote::Interfaces::Rating::None;
+		}
 
-			m_artist = artist;
-			((Library^)m_library)->RegisterAlbumAndArtist(album_artist, album, m_artistPtr, m_albumPtr);
+		if (!String::IsNullOrEmpty(artist) && (ReferenceEquals(artist, album_artist) || String::Equals(artist, album_artist, StringComparison::InvariantCultureIgnoreCase)))
+		{
+			artist = nullptr;
+		}
+		else if (String::IsNullOrEmpty(album_artist))
+		{
+			album_artist = artist;
+			artist = nullptr;
 		}
 
-		m_genre = format_string(ptr, foobar::titleformat::genre, info, "GENRE");
-		m_composer = format_string(ptr, foobar::titleformat::composer, info, "COMPOSER");
+		IArtist^ artistPtr = nullptr;
+		IAlbum^ albumPtr = nullptr;
+		((Library^)m_table->MediaLibrary)->RegisterAlbumAndArtist(album_artist, album, artistPtr, albumPtr);
 
-		m_trackNumber = get_int(info->meta_get("TRACKNUMBER", 0));
-		m_discNumber = get_int(info->meta_get("DISCNUMBER", 0));
+		int albumName = (albumPtr != nullptr) ? strings->GetId(albumPtr->Title) : 0;
+		int albumArtistName = (artistPtr != nullptr) ? strings->GetId(artistPtr->Name) : 0;
 
-		String^ rating = format_string(ptr, foobar::titleformat::rating, info, "RATING");
-		int n_rating;
-		if (!String::IsNullOrEmpty(rating) && int::TryParse(rating, n_rating))
-			m_rating = (TouchRemote::Interfaces::Rating)Math::Max(0, Math::Min(n_rating, 5));
-		else
-			m_rating = TouchRemote::Interfaces::Rating::None;
+		Monitor::Enter(m_table);
+		try
+		{
+			m_table->m_durations[m_row] = duration;
+			m_table->m_titles[m_row] = title;
+			m_table->m_artists[m_row] = strings->GetId(artist);
+			m_table->m_albumArtists[m_row] = artistPtr;
+			m_table->m_albums[m_row] = albumPtr;
+			m_table->m_albumNames[m_row] = albumName;
+			m_table->m_albumArtistNames[m_row] = albumArtistName;
+			m_table->m_genres[m_row] = genre;
+			m_table->m_composers[m_row] = composer;
+			m_table->m_trackNumbers[m_row] = trackNumber;
+			m_table->m_discNumbers[m_row] = discNumber;
+			m_table->m_ratings[m_row] = (Byte)rating;
+			m_table->m_kinds[m_row] = (Byte)MediaKind::Track;
+
+			m_table->p_titles->Set(m_row, utf8Title);
+		}
+		finally
+		{
+			Monitor::Exit(m_table);
+		}
+	}
+    
+	void Track::Refresh()
+	{
+		// tags changed on disk since the row was read, see TrackTable::MarkDirty;
+		// under the table lock so that Grow() cannot swap the column for a copy in between
+		Monitor::Enter(m_table);
+		try
+		{
+			if (m_table->m_dirty[m_row] == 0) return;
+			m_table->m_dirty[m_row] = 0;
+		}
+		finally
+		{
+			Monitor::Exit(m_table);
+		}
 
-        m_kind = (Byte)MediaKind::Track;
+		try
+		{
+			metadb_handle_ptr ptr = GetHandle();
+			ReadInfo(ptr);
+		}
+		catch (Exception^ ex)
+		{
+			_console::error(ex->ToString());
+		}
 	}
     
     void Track::SetDynamic(const file_info &info)
     {
-        if (p_native_handle == NULL) return;
-
-        metadb_handle_ptr ptr = *p_native_handle;
+        metadb_handle_ptr ptr = GetHandle();
+        pfc::string8_sso value;
 
-        m_liveTitle = format_string_live(ptr, foobar::titleformat::title, info, "TITLE");
+        TrackTable::LiveInfo^ live = gcnew TrackTable::LiveInfo();
+        live->Row = m_row;
+        live->Title = format_string_live(ptr, foobar::titleformat::title, info, "TITLE", value);
 			
-        String^ album_artist = format_string_live(ptr, foobar::titleformat::albumartist, info, "ALBUM ARTIST");
-		String^ artist = format_string_live(ptr, foobar::titleformat::artist, info, "ARTIST");
+        String^ album_artist = format_string_live(ptr, foobar::titleformat::albumartist, info, "ALBUM ARTIST", value);
+		String^ artist = format_string_live(ptr, foobar::titleformat::artist, info, "ARTIST", value);
 
 		if (!String::IsNullOrEmpty(artist))
-			m_liveArtist = artist;
+			live->ArtistName = artist;
 		else if (!String::IsNullOrEmpty(album_artist))
-			m_liveArtist = album_artist;
-        else
-            m_liveArtist = nullptr;
+			live->ArtistName = album_artist;
 
-		m_liveAlbum = format_string_live(ptr, foobar::titleformat::album, info, "ALBUM");
+		live->AlbumName = format_string_live(ptr, foobar::titleformat::album, info, "ALBUM", value);
 
-		m_liveGenre = format_string_live(ptr, foobar::titleformat::genre, info, "GENRE");
-		m_liveComposer = format_string_live(ptr, foobar::titleformat::composer, info, "COMPOSER");
+		live->GenreName = format_string_live(ptr, foobar::titleformat::genre, info, "GENRE", value);
+		live->ComposerName = format_string_live(ptr, foobar::titleformat::composer, info, "COMPOSER", value);
 
-        m_isLive = true;
+        m_table->m_live = live;
     }
 
     void Track::CancelDynamic()
     {
-        m_isLive = false;
-        m_liveTitle = nullptr;
-        m_liveArtist = nullptr;
-        m_liveAlbum = nullptr;
-        m_liveGenre = nullptr;
-        m_liveComposer = nullptr;
+        TrackTable::LiveInfo^ live = m_table->m_live;
+        if (live != nullptr && live->Row == m_row)
+            m_table->m_live = nullptr;
     }
 
-	Track::~Track()
+	int Track::Row::get()
 	{
-		//this->!Track();
+		return m_row;
 	}
 
-	Track::!Track()
+	TrackTable^ Track::Table::get()
 	{
-		if (p_native_handle != NULL)
-		{
-			if (core_api::are_services_available())
-				p_native_handle->release();
-			else
-				p_native_handle->detach();
-            delete p_native_handle;
-            p_native_handle = NULL;
-		}
+		return m_table;
 	}
 
 	IPlaybackSource^ Track::Source::get()
 	{
-		return m_source;
+		return m_table->m_sources[m_row];
 	}
 
 	TimeSpan Track::Duration::get()
 	{
-		return m_duration;
+		Refresh();
+		return m_table->m_durations[m_row];
 	}
 
 	IArtist^ Track::AlbumArtist::get()
 	{
-		return m_artistPtr;
+		Refresh();
+		return m_table->m_albumArtists[m_row];
 	}
 
 	IAlbum^ Track::Album::get()
 	{
-		return m_albumPtr;
+		Refresh();
+		return m_table->m_albums[m_row];
 	}
 	
 	String^ Track::ArtistName::get()
 	{
-		if (!String::IsNullOrEmpty(m_artist))
-			return m_artist;
+		Refresh();
+		int artist = m_table->m_artists[m_row];
+		if (artist != 0)
+			return m_table->Strings->GetValue(artist);
 
-		if (m_artistPtr != nullptr)
-			return m_artistPtr->Name;
+		IArtist^ artistPtr = AlbumArtist;
+		if (artistPtr != nullptr)
+			return artistPtr->Name;
 
 		return ""; // "Unknown Artist";
 	}
 
 	String^ Track::AlbumArtistName::get()
 	{
-		if (m_artistPtr != nullptr)
-			return m_artistPtr->Name;
+		IArtist^ artistPtr = AlbumArtist;
+		if (artistPtr != nullptr)
+			return artistPtr->Name;
 
 		return ""; // "Unknown Artist";
 	}
 
 	String^ Track::AlbumName::get()
 	{
-		if (m_albumPtr != nullptr)
-			return m_albumPtr->Title;
+		IAlbum^ albumPtr = Album;
+		if (albumPtr != nullptr)
+			return albumPtr->Title;
 			
 		return ""; // "Unknown Album";
 	}
 	
 	String^ Track::Title::get()
 	{
-		return m_title;
+		Refresh();
+		return m_table->m_titles[m_row];
 	}
 
 	String^ Track::GenreName::get()
 	{
-		return m_genre;
+		Refresh();
+		return m_table->Strings->GetValue(m_table->m_genres[m_row]);
 	}
 
 	String^ Track::ComposerName::get()
 	{
-		return m_composer;
+		Refresh();
+		return m_table->Strings->GetValue(m_table->m_composers[m_row]);
 	}
 
 	int Track::TrackNumber::get()
 	{
-		return m_trackNumber;
+		Refresh();
+		return m_table->m_trackNumbers[m_row];
 	}
 
 	int Track::DiscNumber::get()
 	{
-		return m_discNumber;
+		Refresh();
+		return m_table->m_discNumbers[m_row];
 	}
 
     Boolean Track::IsLiveStream::get()
     {
-        return m_isLive;
+        TrackTable::LiveInfo^ live = m_table->m_live;
+        return live != nullptr && live->Row == m_row;
     }
 
     String^ Track::LiveArtistName::get()
 	{
-		if (m_liveArtist != nullptr)
-			return m_liveArtist;
+		TrackTable::LiveInfo^ live = m_table->m_live;
+		if (live != nullptr && live->Row == m_row && live->ArtistName != nullptr)
+			return live->ArtistName;
 
 		return ArtistName;
 	}
 
 	String^ Track::LiveAlbumName::get()
 	{
-		if (m_liveAlbum != nullptr)
-			return m_liveAlbum;
+		TrackTable::LiveInfo^ live = m_table->m_live;
+		if (live != nullptr && live->Row == m_row && live->AlbumName != nullptr)
+			return live->AlbumName;
 
 		return AlbumName;
 	}
 	
 	String^ Track::LiveTitle::get()
 	{
-		if (m_liveTitle != nullptr)
-			return m_liveTitle;
+		TrackTable::LiveInfo^ live = m_table->m_live;
+		if (live != nullptr && live->Row == m_row && live->Title != nullptr)
+			return live->Title;
 
 		return Title;
 	}
 
 	String^ Track::LiveGenreName::get()
 	{
-		if (!String::IsNullOrEmpty(m_liveGenre))
-			return m_liveGenre;
+		TrackTable::LiveInfo^ live = m_table->m_live;
+		if (live != nullptr && live->Row == m_row && !String::IsNullOrEmpty(live->GenreName))
+			return live->GenreName;
 
 		return GenreName;	
 	}
 
 	String^ Track::LiveComposerName::get()
 	{
-		if (!String::IsNullOrEmpty(m_liveComposer))
-			return m_liveComposer;
+		TrackTable::LiveInfo^ live = m_table->m_live;
+		if (live != nullptr && live->Row == m_row && !String::IsNullOrEmpty(live->ComposerName))
+			return live->ComposerName;
 
 		return ComposerName;
 	}
 
 	TouchRemote::Interfaces::Rating Track::Rating::get()
 	{
-		return m_rating;
+		Refresh();
+		return (TouchRemote::Interfaces::Rating)m_table->m_ratings[m_row];
 	}
 
-	CALLBACK_START_UU(TrackRating_set, int, int)
-		switch (arg)
-		{
-		case 0:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_none);
-			break;
-		case 1:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_one_star);
-			break;
-		case 2:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_two_stars);
-			break;
-		case 3:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_three_stars);
-			break;
-		case 4:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_four_stars);
-			break;
-		case 5:
-			menu_helpers::run_command_context_now_playing(foo_playcount::guids::rating_menu_item, foo_playcount::guids::rating_five_stars);
-			break;
-		}
-		return 0;
-	CALLBACK_END()
-
 	void Track::Rating::set(TouchRemote::Interfaces::Rating value)
 	{
-		(new TrackRating_set())->Run(ManagedHost::Instance, (int)value);
-		m_rating = value;
+		// the column is updated right away, the write itself is batched
+		Monitor::Enter(m_table);
+		try
+		{
+			m_table->m_ratings[m_row] = (Byte)value;
+		}
+		finally
+		{
+			Monitor::Exit(m_table);
+		}
+		ManagedHost::Instance->SetTrackRating(this, value);
 	}
 
 	Byte Track::Kind::get()
 	{
-		return m_kind;
+		return m_table->m_kinds[m_row];
 	}
 
 	int Track::Id::get()
 	{
-		return ((Library^)m_library)->Identifiers->GetId(this);
+		return ((Library^)m_table->MediaLibrary)->Identifiers->GetId(this);
 	}
 
 	__int64 Track::PersistentId::get()
 	{
-		return ((Library^)m_library)->Identifiers->GetPersistentId(this);
+		return ((Library^)m_table->MediaLibrary)->Identifiers->GetPersistentId(this);
 	}
 
 	metadb_handle_ptr Track::GetHandle()
 	{
-		if (p_native_handle == NULL)
-			throw gcnew InvalidOperationException("Track has empty native handle");
-
-		return metadb_handle_ptr(*p_native_handle);
+		return m_table->GetHandle(m_row);
 	}
 
     CALLBACK_START_MU(AlbumArt_extract, Bitmap^, metadb_handle_ptr)
@@ -442,7 +476,7 @@ namespace foo_touchremote
 
 	Bitmap^ Track::GetCoverImage()
 	{
-	    return (new AlbumArt_extract())->Run(ManagedHost::Instance, GetHandle());
+	    return AlbumArt_extract::Invoke(ManagedHost::Instance, GetHandle());
 	}
 
 	bool Track::Equals(ITrack^ other)
@@ -453,9 +487,9 @@ namespace foo_touchremote
 		Track^ o = safe_cast<Track^> (other);
 		if (o == nullptr) return false;
 
-		//return GetHandle() == o->GetHandle();
+		if (ReferenceEquals(m_table, o->m_table) && m_row == o->m_row) return true;
 
-		return ((IEquatable<IPlaybackSource^>^)m_source)->Equals(o->m_source);
+		return ((IEquatable<IPlaybackSource^>^)Source)->Equals(o->Source);
 	}
 
 	int Track::CompareTo(ITrack^ other)
@@ -474,7 +508,7 @@ namespace foo_touchremote
 
 		//return Math::Sign((__int64)(byte*)(p_native_handle->get_ptr()) - (__int64)(byte*)(o->p_native_handle->get_ptr()));
 
-		return m_source->CompareTo(o->m_source);
+		return Source->CompareTo(o->Source);
 	}
 
 	String^ Track::ToString()
@@ -487,7 +521,7 @@ namespace foo_touchremote
 		//if (p_native_handle == NULL)
 		//	throw gcnew InvalidOperationException("Track has empty native handle");
 		//return ((__int64)(byte*)(p_native_handle->get_ptr()) & 0xFFFFFFFF);
-		return m_source->GetHashCode();
+		return Source->GetHashCode();
 	}
 
 	bool Track::Equals(System::Object ^other)
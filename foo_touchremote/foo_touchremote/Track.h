@@ -8,14 +8,13 @@ using namespace TouchRemote::Interfaces;
 
 namespace foo_touchremote
 {
+	// forward declaration
+	ref class TrackTable;
 
 	public ref class Track : public ITrack, public IArtworkSource, public ILiveTrack
 	{
 	public:
-		Track(IMediaLibrary^ library, metadb_handle_ptr &ptr);
-		Track(IMediaLibrary^ library, metadb_handle_ptr &ptr, IPlaybackSource^ location);
-		~Track();
-		!Track();
+		Track(TrackTable^ table, int row);
 
 		virtual property int Id
 		{
@@ -140,40 +139,26 @@ namespace foo_touchremote
 
 	internal:
 		void ReadInfo(metadb_handle_ptr &ptr);
+		void Refresh();
         
         void SetDynamic(const file_info &info);
         void CancelDynamic();
 
 		metadb_handle_ptr GetHandle();
 
-	private:
-		void Initialize(metadb_handle_ptr &ptr);
-
-		metadb_handle_ptr *p_native_handle;
-
-		IMediaLibrary^ m_library;
-		IPlaybackSource^ m_source;
-		TimeSpan m_duration;
-		int m_trackNumber;
-		int m_discNumber;
-		TouchRemote::Interfaces::Rating m_rating;
-
-		IAlbum^ m_albumPtr;
-		IArtist^ m_artistPtr;
-
-		String^ m_title;
-		String^ m_artist;
-		String^ m_genre;
-		String^ m_composer;
+		property int Row
+		{
+			int get();
+		}
 
-        String^ m_liveTitle;
-        String^ m_liveArtist;
-        String^ m_liveGenre;
-        String^ m_liveAlbum;
-        String^ m_liveComposer;
+		property TrackTable^ Table
+		{
+			TrackTable^ get();
+		}
 
-        Boolean m_isLive;
-        Byte m_kind;
+	private:
+		TrackTable^ m_table;
+		int m_row;
 	};
 
 }
\ No newline at end of file
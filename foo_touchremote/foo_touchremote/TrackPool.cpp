@@ -1,21 +1,82 @@
 #include "stdafx.h"
 #include "TrackPool.h"
 #include "Track.h"
+#include "TrackTable.h"
+#include "Library.h"
 #include "Utils.h"
 
 #pragma managed
 
+using namespace TouchRemote::Core::Misc;
+
 namespace foo_touchremote
 {
 
+	// background refresh waits for a burst of modifications to settle, then re-reads a few rows at a time
+	static const int RefreshDelay = 1000;
+	static const int RefreshInterval = 20;
+	static const int RefreshBatchSize = 64;
+
 	TrackPool::TrackPool(IMediaLibrary^ library)
 	{
 		if (library == nullptr)
 			throw gcnew ArgumentNullException("library");
 
 		m_library = library;
-		m_tracks = gcnew Dictionary<IntPtr, WeakReference^>();
+		m_table = gcnew TrackTable(library);
+		((Library^)library)->Table = m_table;
 		m_lock = gcnew ReaderWriterLockSlim(LockRecursionPolicy::NoRecursion);
+		m_lockWait = Stats::Latency("lock wait TrackPool");
+		m_views = Stats::Cache("track views");
+		m_refreshTimer = gcnew Timer(gcnew TimerCallback(this, &TrackPool::OnRefreshTimer), nullptr, Timeout::Infinite, Timeout::Infinite);
+		m_refreshScheduled = false;
+	}
+
+	void TrackPool::MarkModified(metadb_handle_ptr &ptr)
+	{
+		Monitor::Enter(this);
+		try
+		{
+			if (m_table->MarkDirty(ptr) && !m_refreshScheduled)
+			{
+				m_refreshScheduled = true;
+				m_refreshTimer->Change(RefreshDelay, Timeout::Infinite);
+			}
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	void TrackPool::OnRefreshTimer(Object^ state)
+	{
+		array<int>^ rows = gcnew array<int>(RefreshBatchSize);
+		int count;
+
+		Monitor::Enter(this);
+		try
+		{
+			count = m_table->TakeDirty(rows);
+			if (count == 0)
+				m_refreshScheduled = false;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+
+		if (count == 0) return;
+
+		for (int i = 0; i < count; i++)
+		{
+			// rows without a view are re-read by the view created for them later
+			Track^ track = m_table->GetView(rows[i]);
+			if (track != nullptr)
+				track->Refresh();
+		}
+
+		m_refreshTimer->Change(RefreshInterval, Timeout::Infinite);
 	}
 
 	ITrack^ TrackPool::GetTrack(metadb_handle_ptr &ptr)
@@ -32,20 +93,42 @@ namespace foo_touchremote
 	{
 		if (ptr.is_empty()) return nullptr;
 
-		IntPtr key = (IntPtr)(void*)ptr.get_ptr();
-		WeakReference ^r;
-		m_lock->EnterUpgradeableReadLock();
+		Track^ track = nullptr;
+		Stats::EnterUpgradeableReadLock(m_lock, m_lockWait);
 		try
 		{
-			if (!m_tracks->TryGetValue(key, r) || !r->IsAlive)
+			int row = m_table->Find(ptr);
+			if (row >= 0)
+				track = m_table->GetView(row);
+
+			m_views->Record(track != nullptr);
+
+			if (track == nullptr)
 			{
 				if (doNotCreate) return nullptr;
 
-				m_lock->EnterWriteLock();
+				Stats::EnterWriteLock(m_lock, m_lockWait);
 				try
 				{
-					r = gcnew WeakReference(gcnew Track(m_library, ptr));
-					m_tracks[key] = r;
+					bool created = row < 0;
+					if (created)
+						row = m_table->Allocate(ptr);
+
+					track = gcnew Track(m_table, row);
+					m_table->SetView(row, track);
+
+					if (created || update)
+					{
+						try
+						{
+							track->ReadInfo(ptr);
+						}
+						catch (Exception^)
+						{
+							m_table->Free(row);
+							throw;
+						}
+					}
 				}
 				finally
 				{
@@ -54,10 +137,10 @@ namespace foo_touchremote
 			}
 			else if (update)
 			{
-				static_cast<Track^>(r->Target)->ReadInfo(ptr);
+				track->ReadInfo(ptr);
 			}
 
-			return static_cast<ITrack^>(r->Target);
+			return track;
 		}
 		finally
 		{
@@ -7,6 +7,8 @@ using namespace TouchRemote::Interfaces;
 
 namespace foo_touchremote
 {
+	// forward declaration
+	ref class TrackTable;
 
 	private ref class TrackPool
 	{
@@ -18,10 +20,21 @@ namespace foo_touchremote
 		virtual ITrack^ GetTrack(metadb_handle_ptr &ptr, bool update);
 		virtual ITrack^ GetTrack(metadb_handle_ptr &ptr, bool update, bool doNotCreate);
 
+		// Marks a track whose tags changed; it is re-read when next served, or in the background
+		// a little later. Costs one table lookup, so it is safe to call for every item of a big rescan.
+		void MarkModified(metadb_handle_ptr &ptr);
+
 	private:
+		void OnRefreshTimer(Object^ state);
+
 		IMediaLibrary^ m_library;
-		Dictionary<IntPtr, WeakReference^>^ m_tracks;
+		TrackTable^ m_table;
 		ReaderWriterLockSlim^ m_lock;
+		TouchRemote::Core::Misc::Histogram^ m_lockWait;
+		TouchRemote::Core::Misc::HitCounter^ m_views;
+
+		Timer^ m_refreshTimer;
+		bool m_refreshScheduled;
 
 	};
 
@@ -0,0 +1,398 @@
+#include "stdafx.h"
+#include "TrackTable.h"
+#include "Track.h"
+#include "Library.h"
+#include "StringPool.h"
+#include "FilePlaybackSource.h"
+#include "TrigramIndex.h"
+#include "Utils.h"
+
+#pragma managed
+
+using namespace System::Threading;
+
+namespace foo_touchremote
+{
+
+	// dirty rows a search re-reads itself, the same as one batch of TrackPool's background refresh
+	static const int SearchRefreshLimit = 64;
+
+	TrackTable::TrackTable(IMediaLibrary^ library)
+	{
+		if (library == nullptr)
+			throw gcnew ArgumentNullException("library");
+
+		m_library = library;
+		m_rows = gcnew Dictionary<IntPtr, int>();
+		m_freeRows = gcnew Stack<int>();
+		m_dirtyRows = gcnew Queue<int>();
+		m_live = nullptr;
+		m_count = 0;
+		m_capacity = 0;
+
+		m_sources = gcnew array<IPlaybackSource^>(0);
+		m_durations = gcnew array<TimeSpan>(0);
+		m_trackNumbers = gcnew array<int>(0);
+		m_discNumbers = gcnew array<int>(0);
+		m_ratings = gcnew array<Byte>(0);
+		m_kinds = gcnew array<Byte>(0);
+		m_titles = gcnew array<String^>(0);
+		m_artists = gcnew array<int>(0);
+		m_genres = gcnew array<int>(0);
+		m_composers = gcnew array<int>(0);
+		m_albumArtists = gcnew array<IArtist^>(0);
+		m_albums = gcnew array<IAlbum^>(0);
+		m_albumNames = gcnew array<int>(0);
+		m_albumArtistNames = gcnew array<int>(0);
+		m_dirty = gcnew array<Byte>(0);
+		m_views = gcnew array<GCHandle>(0);
+
+		p_handles = new pfc::array_t<metadb_handle_ptr>();
+		p_titles = new TrigramIndex();
+	}
+
+	TrackTable::~TrackTable()
+	{
+		this->!TrackTable();
+	}
+
+	TrackTable::!TrackTable()
+	{
+		ReleaseHandles();
+	}
+
+	void TrackTable::ReleaseHandles()
+	{
+		if (p_handles == NULL) return;
+
+		for (t_size i = 0; i < p_handles->get_size(); i++)
+		{
+			if (core_api::are_services_available())
+				(*p_handles)[i].release();
+			else
+				(*p_handles)[i].detach();
+		}
+
+		delete p_handles;
+		p_handles = NULL;
+
+		delete p_titles;
+		p_titles = NULL;
+
+		for (int i = 0; i < m_views->Length; i++)
+			if (m_views[i].IsAllocated)
+				m_views[i].Free();
+	}
+
+	IMediaLibrary^ TrackTable::MediaLibrary::get()
+	{
+		return m_library;
+	}
+
+	StringPool^ TrackTable::Strings::get()
+	{
+		return ((Library^)m_library)->Strings;
+	}
+
+	int TrackTable::Count::get()
+	{
+		return m_count - m_freeRows->Count;
+	}
+
+	int TrackTable::Find(metadb_handle_ptr &ptr)
+	{
+		if (ptr.is_empty()) return -1;
+
+		IntPtr key = (IntPtr)(void*)ptr.get_ptr();
+
+		Monitor::Enter(this);
+		try
+		{
+			int row;
+			if (m_rows->TryGetValue(key, row))
+				return row;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+
+		return -1;
+	}
+
+	int TrackTable::Allocate(metadb_handle_ptr &ptr)
+	{
+		if (ptr.is_empty())
+			throw gcnew ArgumentNullException("ptr");
+
+		IntPtr key = (IntPtr)(void*)ptr.get_ptr();
+
+		Monitor::Enter(this);
+		try
+		{
+			int row;
+			if (m_rows->TryGetValue(key, row))
+				return row;
+
+			if (m_freeRows->Count == 0 && m_count == m_capacity)
+				Grow();
+
+			if (m_freeRows->Count > 0)
+				row = m_freeRows->Pop();
+			else
+				row = m_count++;
+
+			(*p_handles)[row] = ptr;
+			m_sources[row] = gcnew FilePlaybackSource(ptr->get_location());
+			m_kinds[row] = (Byte)MediaKind::Track;
+			m_rows[key] = row;
+
+			return row;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	void TrackTable::Free(int row)
+	{
+		Monitor::Enter(this);
+		try
+		{
+			if (row < 0 || row >= m_count) return;
+
+			metadb_handle_ptr &ptr = (*p_handles)[row];
+			if (ptr.is_empty()) return;
+
+			m_rows->Remove((IntPtr)(void*)ptr.get_ptr());
+			ptr.release();
+
+			m_sources[row] = nullptr;
+			m_durations[row] = TimeSpan::Zero;
+			m_trackNumbers[row] = 0;
+			m_discNumbers[row] = 0;
+			m_ratings[row] = 0;
+			m_titles[row] = nullptr;
+			m_artists[row] = 0;
+			m_genres[row] = 0;
+			m_composers[row] = 0;
+			m_albumArtists[row] = nullptr;
+			m_albums[row] = nullptr;
+			m_albumNames[row] = 0;
+			m_albumArtistNames[row] = 0;
+			m_dirty[row] = 0;
+			m_views[row].Target = nullptr;
+
+			p_titles->Remove(row);
+
+			LiveInfo^ live = m_live;
+			if (live != nullptr && live->Row == row)
+				m_live = nullptr;
+
+			m_freeRows->Push(row);
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	metadb_handle_ptr TrackTable::GetHandle(int row)
+	{
+		Monitor::Enter(this);
+		try
+		{
+			if (row < 0 || row >= m_count || (*p_handles)[row].is_empty())
+				throw gcnew InvalidOperationException("Track has empty native handle");
+
+			return (*p_handles)[row];
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	Track^ TrackTable::GetView(int row)
+	{
+		return static_cast<Track^>(m_views[row].Target);
+	}
+
+	void TrackTable::SetView(int row, Track^ view)
+	{
+		m_views[row].Target = view;
+	}
+
+	bool TrackTable::MarkDirty(metadb_handle_ptr &ptr)
+	{
+		if (ptr.is_empty()) return false;
+
+		Monitor::Enter(this);
+		try
+		{
+			int row;
+			if (!m_rows->TryGetValue((IntPtr)(void*)ptr.get_ptr(), row))
+				return false;
+
+			if (m_dirty[row] == 0)
+			{
+				m_dirty[row] = 1;
+				m_dirtyRows->Enqueue(row);
+			}
+
+			return true;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	int TrackTable::TakeDirty(array<int>^ rows)
+	{
+		Monitor::Enter(this);
+		try
+		{
+			// rows refreshed or freed since they were queued are skipped
+			int count = 0;
+			while (count < rows->Length && m_dirtyRows->Count > 0)
+			{
+				int row = m_dirtyRows->Dequeue();
+				if (m_dirty[row] != 0)
+					rows[count++] = row;
+			}
+
+			return count;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
+	}
+
+	List<int>^ TrackTable::FindRows(String^ property, String^ value)
+	{
+		array<int>^ column;
+		array<int>^ fallback = nullptr;
+
+		if (property == "Title")
+			column = nullptr;
+		else if (property == "ArtistName")
+		{
+			// Track::ArtistName falls back to the album artist
+			column = m_artists;
+			fallback = m_albumArtistNames;
+		}
+		else if (property == "AlbumArtistName")
+			column = m_albumArtistNames;
+		else if (property == "AlbumName")
+			column = m_albumNames;
+		else if (property == "GenreName")
+			column = m_genres;
+		else if (property == "ComposerName")
+			column = m_composers;
+		else
+			return nullptr;
+
+		// the index has to see the tags the views would return
+		RefreshDirty(SearchRefreshLimit);
+
+		List<int>^ rows = gcnew List<int>();
+
+		if (column == nullptr)
+		{
+			pfc::array_t<t_uint32> found;
+			p_titles->Find(ToUtf8String(value), found);
+
+			for (t_size i = 0; i < found.get_size(); i++)
+				rows->Add((int)found[i]);
+
+			return rows;
+		}
+
+		// Grow() may have published bigger columns meanwhile, the ones picked above stay valid for their own length
+		array<bool>^ matches = Strings->FindContaining(value);
+		int count = Math::Min(m_count, column->Length);
+		if (fallback != nullptr) count = Math::Min(count, fallback->Length);
+
+		for (int row = 0; row < count; row++)
+		{
+			int id = column[row];
+			if (id == 0 && fallback != nullptr) id = fallback[row];
+
+			if (id != 0 && id < matches->Length && matches[id])
+				rows->Add(row);
+		}
+
+		return rows;
+	}
+
+	void TrackTable::RefreshDirty(int limit)
+	{
+		// taken off the queue TrackPool refreshes from, so no row is re-read by both
+		array<int>^ rows = gcnew array<int>(limit);
+		int count = TakeDirty(rows);
+
+		for (int i = 0; i < count; i++)
+		{
+			Track^ view = GetView(rows[i]);
+			if (view != nullptr)
+				view->Refresh();
+		}
+	}
+
+	int TrackTable::Sweep()
+	{
+		// rows nobody looks at anymore are reused instead of growing the table;
+		// library members are never collected since the library holds their views
+		int freed = 0;
+
+		for (int row = 0; row < m_count; row++)
+		{
+			if ((*p_handles)[row].is_empty()) continue;
+			if (m_views[row].Target != nullptr) continue;
+
+			Free(row);
+			freed++;
+		}
+
+		return freed;
+	}
+
+	void TrackTable::Grow()
+	{
+		// a sweep walks the whole table, so it only replaces growing when it frees a good share of it;
+		// skipping growth for a handful of rows would sweep again a few allocations later
+		if (m_capacity > 0 && Sweep() >= m_capacity / 4) return;
+
+		int capacity = Math::Max(1024, m_capacity * 2);
+
+		Array::Resize(m_sources, capacity);
+		Array::Resize(m_durations, capacity);
+		Array::Resize(m_trackNumbers, capacity);
+		Array::Resize(m_discNumbers, capacity);
+		Array::Resize(m_ratings, capacity);
+		Array::Resize(m_kinds, capacity);
+		Array::Resize(m_titles, capacity);
+		Array::Resize(m_artists, capacity);
+		Array::Resize(m_genres, capacity);
+		Array::Resize(m_composers, capacity);
+		Array::Resize(m_albumArtists, capacity);
+		Array::Resize(m_albums, capacity);
+		Array::Resize(m_albumNames, capacity);
+		Array::Resize(m_albumArtistNames, capacity);
+		Array::Resize(m_dirty, capacity);
+
+		array<GCHandle>^ views = gcnew array<GCHandle>(capacity);
+		Array::Copy(m_views, views, m_capacity);
+		for (int i = m_capacity; i < capacity; i++)
+			views[i] = GCHandle::Alloc(nullptr, GCHandleType::Weak);
+		m_views = views;
+
+		p_handles->set_size(capacity);
+
+		m_capacity = capacity;
+	}
+
+}
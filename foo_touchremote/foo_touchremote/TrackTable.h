@@ -0,0 +1,112 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Runtime::InteropServices;
+using namespace TouchRemote::Interfaces;
+
+namespace foo_touchremote
+{
+	// forward declaration
+	ref class Track;
+	ref class StringPool;
+	class TrigramIndex;
+
+	// Column storage for track metadata. Track objects are thin views over a row of this table,
+	// so scans over the library touch plain arrays and no per-track native state needs finalizing.
+	// Columns are written under the table lock and read without it; growing a column publishes a filled copy.
+	private ref class TrackTable
+	{
+
+	public:
+		TrackTable(IMediaLibrary^ library);
+		~TrackTable();
+		!TrackTable();
+
+		property IMediaLibrary^ MediaLibrary
+		{
+			IMediaLibrary^ get();
+		}
+
+		property StringPool^ Strings
+		{
+			StringPool^ get();
+		}
+
+		property int Count
+		{
+			int get();
+		}
+
+		int Find(metadb_handle_ptr &ptr);
+		int Allocate(metadb_handle_ptr &ptr);
+		void Free(int row);
+
+		metadb_handle_ptr GetHandle(int row);
+
+		Track^ GetView(int row);
+		void SetView(int row, Track^ view);
+
+		// Flags the row of a modified track, its columns are re-read the next time a view is asked for them.
+		// Returns false for handles that have no row. Flagged rows are also queued for TakeDirty().
+		bool MarkDirty(metadb_handle_ptr &ptr);
+		int TakeDirty(array<int>^ rows);
+
+		// Rows whose text property (named as on ITrack) contains value, ignoring case, accents and ligatures.
+		// Titles are looked up in their own TrigramIndex, tag values through StringPool::FindContaining().
+		// Returns nullptr for properties that are not indexed. A few rows modified since they were read are re-read
+		// first; after a bulk edit the others match by their old values until TrackPool's background refresh gets to them.
+		List<int>^ FindRows(String^ property, String^ value);
+
+	internal:
+		ref class LiveInfo
+		{
+		public:
+			int Row;
+			String^ Title;
+			String^ ArtistName;
+			String^ AlbumName;
+			String^ GenreName;
+			String^ ComposerName;
+		};
+
+		array<IPlaybackSource^>^ m_sources;
+		array<TimeSpan>^ m_durations;
+		array<int>^ m_trackNumbers;
+		array<int>^ m_discNumbers;
+		array<Byte>^ m_ratings;
+		array<Byte>^ m_kinds;
+		array<String^>^ m_titles;
+		array<int>^ m_artists;
+		array<int>^ m_genres;
+		array<int>^ m_composers;
+		array<IArtist^>^ m_albumArtists;
+		array<IAlbum^>^ m_albums;
+		array<int>^ m_albumNames;			// string ids of m_albums[row]->Title and m_albumArtists[row]->Name, for FindRows()
+		array<int>^ m_albumArtistNames;
+		array<Byte>^ m_dirty;
+
+		// title of every row in use, kept in step with m_titles under the table lock
+		TrigramIndex *p_titles;
+
+		// dynamic info of the stream being played, replaced as a whole
+		LiveInfo^ m_live;
+
+	private:
+		void Grow();
+		int Sweep();
+		void ReleaseHandles();
+		void RefreshDirty(int limit);
+
+		IMediaLibrary^ m_library;
+
+		Dictionary<IntPtr, int>^ m_rows;
+		Stack<int>^ m_freeRows;
+		Queue<int>^ m_dirtyRows;
+		array<GCHandle>^ m_views;
+		pfc::array_t<metadb_handle_ptr> *p_handles;
+		int m_count;
+		int m_capacity;
+	};
+
+}
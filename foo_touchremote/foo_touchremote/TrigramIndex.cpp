@@ -0,0 +1,325 @@
+#include "stdafx.h"
+#include "TrigramIndex.h"
+
+// plain loops over arrays, no reason to run them as IL
+#pragma unmanaged
+
+namespace foo_touchremote
+{
+
+	namespace
+	{
+		// position of the first item >= id in list[from, to)
+		t_size lower_bound(const t_uint32 * list, t_size from, t_size to, t_uint32 id)
+		{
+			while (from < to)
+			{
+				t_size middle = from + (to - from) / 2;
+				if (list[middle] < id) from = middle + 1;
+				else to = middle;
+			}
+			return from;
+		}
+	}
+
+	TrigramIndex::TrigramIndex() : m_matcher(SmartStrStr::global()), m_count(0)
+	{
+	}
+
+	void TrigramIndex::Set(t_uint32 id, const char * text)
+	{
+		if (text == NULL || *text == 0)
+		{
+			Remove(id);
+			return;
+		}
+
+		// folding is the expensive part and needs no lock
+		grams_t grams;
+		t_uint64 mask;
+		bool ambiguous = GetDocumentTrigrams(text, grams, mask);
+
+		inWriteSync(m_lock);
+
+		if (id < m_texts.get_size() && !m_texts[id].is_empty())
+		{
+			if (strcmp(m_texts[id], text) == 0) return;
+			RemoveDocument(id);
+		}
+
+		if (id >= m_texts.get_size())
+		{
+			t_size size = pfc::max_t<t_size>(id + 1, m_texts.get_size() * 2);
+			m_texts.set_size(size);
+			m_masks.set_size(size);
+		}
+
+		m_texts[id] = text;
+		m_masks[id] = mask;
+		m_count++;
+
+		for (t_size i = 0; i < grams.get_size(); i++)
+			Insert(m_postings.find_or_add(grams[i]), id);
+
+		if (ambiguous)
+			Insert(m_ambiguous, id);
+	}
+
+	void TrigramIndex::Remove(t_uint32 id)
+	{
+		inWriteSync(m_lock);
+
+		if (id >= m_texts.get_size() || m_texts[id].is_empty()) return;
+
+		RemoveDocument(id);
+		m_texts[id] = pfc::string8();
+		m_masks[id] = 0;
+		m_count--;
+	}
+
+	t_size TrigramIndex::GetCount() const
+	{
+		inReadSync(m_lock);
+		return m_count;
+	}
+
+	void TrigramIndex::Find(const char * query, pfc::array_t<t_uint32> & out) const
+	{
+		pfc::string8 folded;
+		chars_t chars;
+		Fold(query != NULL ? query : "", folded, chars);
+
+		inReadSync(m_lock);
+
+		const t_size total = m_texts.get_size();
+
+		if (chars.get_size() == 0)
+		{
+			for (t_size id = 0; id < total; id++)
+				if (!m_texts[id].is_empty()) out.append_single_val((t_uint32)id);
+			return;
+		}
+
+		// the query is passed folded, SmartStrStr then lets its lower case letters without accents
+		// match any case and any accent in the document
+		const t_uint64 mask = GetMask(chars);
+
+		if (chars.get_size() < 3)
+		{
+			for (t_size id = 0; id < total; id++)
+			{
+				if ((m_masks[id] & mask) != mask || m_texts[id].is_empty()) continue;
+				if (m_matcher.testSubstring(m_texts[id], folded)) out.append_single_val((t_uint32)id);
+			}
+			return;
+		}
+
+		const t_size first = out.get_size();
+		FindIndexed(chars, folded, out);
+
+		// the trigrams of documents SmartStrStr may also match by the first letter of a ligature
+		// do not cover every spelling, they are tested one by one
+		const t_size indexed = out.get_size();
+		for (t_size i = 0; i < m_ambiguous.get_size(); i++)
+		{
+			const t_uint32 id = m_ambiguous[i];
+			if ((m_masks[id] & mask) != mask) continue;
+
+			t_size at = lower_bound(out.get_ptr(), first, indexed, id);
+			if (at < indexed && out[at] == id) continue;
+
+			if (m_matcher.testSubstring(m_texts[id], folded)) out.append_single_val(id);
+		}
+
+		if (out.get_size() > indexed)
+		{
+			pfc::sort_inline_t(out.get_ptr() + first, out.get_size() - first, [](t_uint32 id1, t_uint32 id2) {
+				return pfc::compare_t(id1, id2);
+			});
+		}
+	}
+
+	void TrigramIndex::FindIndexed(const chars_t & chars, const char * folded, pfc::array_t<t_uint32> & out) const
+	{
+		grams_t grams;
+		GetTrigrams(chars, grams);
+		SortUnique(grams);
+
+		const t_size count = grams.get_size();
+		pfc::array_t<const postings_t*> lists;
+		lists.set_size(count);
+		for (t_size i = 0; i < count; i++)
+		{
+			lists[i] = m_postings.query_ptr(grams[i]);
+			if (lists[i] == NULL) return;
+		}
+
+		// walk the shortest list and look its ids up in the others, which only ever move forward
+		pfc::sort_inline_t(lists, count, [](const postings_t * list1, const postings_t * list2) {
+			return pfc::compare_t(list1->get_size(), list2->get_size());
+		});
+
+		pfc::array_t<t_size> cursors;
+		cursors.set_size(count);
+		cursors.fill_null();
+
+		const postings_t & shortest = *lists[0];
+		for (t_size walk = 0; walk < shortest.get_size(); walk++)
+		{
+			const t_uint32 id = shortest[walk];
+
+			bool all = true;
+			for (t_size i = 1; i < count && all; i++)
+			{
+				const postings_t & list = *lists[i];
+				cursors[i] = lower_bound(list.get_ptr(), cursors[i], list.get_size(), id);
+				all = cursors[i] < list.get_size() && list[cursors[i]] == id;
+			}
+
+			if (all && m_matcher.testSubstring(m_texts[id], folded)) out.append_single_val(id);
+		}
+	}
+
+	bool TrigramIndex::Fold(const char * text, pfc::string8 & out, chars_t & chars) const
+	{
+		out.reset();
+		chars.set_size(0);
+
+		bool ambiguous = false;
+		pfc::string8_fastalloc single, transformed;
+
+		for (const char * walk = text; *walk != 0; )
+		{
+			unsigned c;
+			t_size delta = pfc::utf8_decode_char(walk, c);
+			if (delta == 0) break;
+			walk += delta;
+
+			if (c < 0x80)
+			{
+				if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+				out.add_byte((char)c);
+				chars.append_single_val(c);
+				continue;
+			}
+
+			// lower case before transforming, the downconvert table maps accented lower case letters
+			// to their base; and after, since ligatures may expand to upper case letters
+			c = pfc::charLower(c);
+			single.reset();
+			single.add_char(c);
+			m_matcher.transformStrHere(transformed, single, single.length());
+
+			const t_size first = chars.get_size();
+			for (const char * walk2 = transformed; *walk2 != 0; )
+			{
+				unsigned c2;
+				t_size delta2 = pfc::utf8_decode_char(walk2, c2);
+				if (delta2 == 0) break;
+				walk2 += delta2;
+
+				c2 = pfc::charLower(c2);
+				out.add_char(c2);
+				chars.append_single_val(c2);
+			}
+
+			// SmartStrStr also matches some ligatures by their first letter alone (the ae ligature by a)
+			if (chars.get_size() - first > 1 && m_matcher.matchOneChar(chars[first], c))
+				ambiguous = true;
+		}
+
+		return ambiguous;
+	}
+
+	bool TrigramIndex::GetDocumentTrigrams(const char * text, grams_t & out, t_uint64 & mask) const
+	{
+		pfc::string8 folded;
+		chars_t chars;
+		bool ambiguous = Fold(text, folded, chars);
+
+		out.set_size(0);
+		GetTrigrams(chars, out);
+		SortUnique(out);
+
+		mask = GetMask(chars);
+		return ambiguous;
+	}
+
+	void TrigramIndex::GetTrigrams(const chars_t & chars, grams_t & out)
+	{
+		// code points take 21 bits, three of them fit one key
+		for (t_size i = 0; i + 2 < chars.get_size(); i++)
+			out.append_single_val(((t_uint64)chars[i] << 42) | ((t_uint64)chars[i + 1] << 21) | chars[i + 2]);
+	}
+
+	void TrigramIndex::SortUnique(grams_t & grams)
+	{
+		if (grams.get_size() < 2) return;
+
+		pfc::sort_inline_t(grams, grams.get_size(), [](t_uint64 gram1, t_uint64 gram2) {
+			return pfc::compare_t(gram1, gram2);
+		});
+
+		t_size unique = 1;
+		for (t_size i = 1; i < grams.get_size(); i++)
+			if (grams[i] != grams[unique - 1]) grams[unique++] = grams[i];
+		grams.set_size(unique);
+	}
+
+	t_uint64 TrigramIndex::GetMask(const chars_t & chars)
+	{
+		t_uint64 mask = 0;
+		for (t_size i = 0; i < chars.get_size(); i++)
+			mask |= (t_uint64)1 << (chars[i] & 63);
+		return mask;
+	}
+
+	void TrigramIndex::Insert(postings_t & list, t_uint32 id)
+	{
+		const t_size size = list.get_size();
+
+		// rows and tag values are mostly added in ascending order
+		if (size == 0 || list[size - 1] < id)
+		{
+			list.append_single_val(id);
+			return;
+		}
+
+		t_size at = lower_bound(list.get_ptr(), 0, size, id);
+		if (list[at] == id) return;
+
+		list.set_size(size + 1);
+		memmove(list.get_ptr() + at + 1, list.get_ptr() + at, (size - at) * sizeof(t_uint32));
+		list[at] = id;
+	}
+
+	void TrigramIndex::Remove(postings_t & list, t_uint32 id)
+	{
+		const t_size size = list.get_size();
+		t_size at = lower_bound(list.get_ptr(), 0, size, id);
+		if (at == size || list[at] != id) return;
+
+		memmove(list.get_ptr() + at, list.get_ptr() + at + 1, (size - at - 1) * sizeof(t_uint32));
+		list.set_size(size - 1);
+	}
+
+	void TrigramIndex::RemoveDocument(t_uint32 id)
+	{
+		// the postings of a document are found again from its text
+		grams_t grams;
+		t_uint64 mask;
+		if (GetDocumentTrigrams(m_texts[id], grams, mask))
+			Remove(m_ambiguous, id);
+
+		for (t_size i = 0; i < grams.get_size(); i++)
+		{
+			postings_t * list = m_postings.query_ptr(grams[i]);
+			if (list == NULL) continue;
+
+			Remove(*list, id);
+			if (list->get_size() == 0)
+				m_postings.remove(grams[i]);
+		}
+	}
+
+}
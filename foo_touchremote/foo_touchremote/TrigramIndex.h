@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../../foobarsdk/pfc/SmartStrStr.h"
+
+namespace foo_touchremote
+{
+
+	// Substring index over short texts such as titles and tag values, for search as you type.
+	// Texts are folded the way SmartStrStr compares them (lower case, accents dropped, ligatures spelled out) and
+	// every run of three folded characters lists the documents containing it. Find() intersects the lists of the
+	// query's trigrams, shortest first, and confirms the documents left over with SmartStrStr::testSubstring.
+	// Queries shorter than three folded characters cannot use the lists and test every document.
+	// Documents are small integer ids chosen by the caller. All methods may be called from any thread.
+	class TrigramIndex
+	{
+
+	public:
+		TrigramIndex();
+
+		// Replaces the text of a document, an empty text removes it.
+		void Set(t_uint32 id, const char * text);
+		void Remove(t_uint32 id);
+
+		// Appends the ids of the documents containing query, ascending.
+		// Case, accents and ligatures are ignored on both sides; an empty query matches every document.
+		void Find(const char * query, pfc::array_t<t_uint32> & out) const;
+
+		t_size GetCount() const;
+
+	private:
+		typedef pfc::array_t<t_uint32, pfc::alloc_fast_aggressive> chars_t;
+		typedef pfc::array_t<t_uint32, pfc::alloc_fast_aggressive> postings_t;
+		typedef pfc::array_t<t_uint64, pfc::alloc_fast_aggressive> grams_t;
+
+		// Lower case, accents dropped, ligatures spelled out; out holds the result as UTF-8, chars as code points.
+		// Returns true when SmartStrStr would also match some ligature of text by its first letter alone,
+		// such texts can match queries their trigrams do not contain.
+		bool Fold(const char * text, pfc::string8 & out, chars_t & chars) const;
+		bool GetDocumentTrigrams(const char * text, grams_t & out, t_uint64 & mask) const;
+		static void GetTrigrams(const chars_t & chars, grams_t & out);
+		static void SortUnique(grams_t & grams);
+		static t_uint64 GetMask(const chars_t & chars);
+
+		static void Insert(postings_t & list, t_uint32 id);
+		static void Remove(postings_t & list, t_uint32 id);
+
+		void FindIndexed(const chars_t & chars, const char * folded, pfc::array_t<t_uint32> & out) const;
+		void RemoveDocument(t_uint32 id);
+
+		const SmartStrStr & m_matcher;
+
+		mutable pfc::readWriteLock m_lock;
+		pfc::array_t<pfc::string8, pfc::alloc_fast_aggressive> m_texts;	// by id, empty for ids not in use
+		pfc::array_t<t_uint64, pfc::alloc_fast_aggressive> m_masks;		// folded characters present, one bit per (c & 63)
+		pfc::hash_map_t<t_uint64, postings_t> m_postings;				// ids ascending
+		postings_t m_ambiguous;											// ids of texts Fold() returned true for
+		t_size m_count;
+	};
+
+}